@@ -0,0 +1,114 @@
+/****************************************************************************************************************************
+  PWM_3Phase.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the 3-phase SVPWM / SPWM modulation engine for BLDC / PMSM inverters,
+// using 3 phase-correct push-pull slices, then measure the computation time per update
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_3Phase.h"
+
+// Phase U on slice 0 (GP0 / GP1), V on slice 1 (GP2 / GP3), W on slice 2 (GP4 / GP5)
+#define pinU          0
+#define pinV          2
+#define pinW          4
+
+// 20KHz carrier, duties updated every 2 periods => 10KHz
+#define CARRIER_FREQ        20000
+#define UPDATE_DIVIDER      2
+
+// 200 ticks @ 125MHz = 1.6us
+#define DEAD_TIME           200
+
+RP2040_PWM_3Phase* Inverter;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_3Phase on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  Inverter = new RP2040_PWM_3Phase(pinU, pinV, pinW);
+
+  if ( !Inverter || !Inverter->begin(CARRIER_FREQ, PWM_3PHASE_SVPWM, DEAD_TIME, UPDATE_DIVIDER) )
+  {
+    Serial.println(F("Error starting 3-phase PWM"));
+
+    while (true)
+      delay(1000);
+  }
+
+  // Computation time per update, integer only
+  uint32_t levels[3];
+  uint32_t startTime = micros();
+
+  for (uint32_t angle = 0; angle < 65536; angle += 4)
+  {
+    Inverter->compute(angle, PWM_3PHASE_MI_ONE, levels);
+  }
+
+  Serial.print(F("compute() time (ns) = "));
+  Serial.println( (micros() - startTime) * 1000 / 16384);
+
+  Serial.print(F("TOP = "));
+  Serial.print(Inverter->get_TOP());
+  Serial.print(F(", Update rate (Hz) = "));
+  Serial.println(Inverter->getUpdateRate());
+
+  // Open-loop rotation at 10Hz electrical, modulation index 0.5
+  Inverter->setVector(0, PWM_3PHASE_MI_ONE / 2);
+  Inverter->setRotation(10.0f);
+  Inverter->start();
+}
+
+void loop()
+{
+  static uint16_t modIndex = PWM_3PHASE_MI_ONE / 2;
+
+  delay(1000);
+
+  // Ramp modulation index up to 1.15 with SVPWM, then back
+  modIndex += PWM_3PHASE_MI_ONE / 10;
+
+  if (modIndex > PWM_3PHASE_MI_MAX)
+    modIndex = PWM_3PHASE_MI_ONE / 10;
+
+  Inverter->setVector(Inverter->getAngle(), modIndex);
+
+  Serial.print(F("Modulation index = "));
+  Serial.print(modIndex / 32768.0f, 3);
+  Serial.print(F(", Updates = "));
+  Serial.println(Inverter->getUpdateCount());
+}
@@ -0,0 +1,128 @@
+/****************************************************************************************************************************
+  PWM_ADC_Sync.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo ADC sampling synchronized to the PWM output, one sample per PWM period in the middle
+// of the on-time, e.g. for motor current sensing away from the switching edges. Connect the shunt amplifier to GP26
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_ADC.h"
+
+#define pinToUse      0
+
+// ADC input 0 = GP26
+#define ADC_INPUT     0
+
+// true  : normal mode, a spare slice triggers in the middle of the on-time
+// false : phase-correct mode, the wrap of the PWM slice is already the middle of the on-time
+#define USE_TRIGGER_SLICE     false
+
+#define TRIGGER_SLICE         7
+
+float frequency = 20000.0f;
+float dutyCycle = 30.0f;
+
+RP2040_PWM*     PWM_Instance;
+RP2040_PWM_ADC* ADC_Sampler;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_ADC_Sync on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  PWM_Instance = new RP2040_PWM(pinToUse, frequency, dutyCycle, !USE_TRIGGER_SLICE);
+
+  if (PWM_Instance)
+  {
+    PWM_Instance->setPWM(pinToUse, frequency, dutyCycle, !USE_TRIGGER_SLICE);
+  }
+
+  ADC_Sampler = new RP2040_PWM_ADC(pinToUse);
+
+  bool started;
+
+#if USE_TRIGGER_SLICE
+  started = ADC_Sampler->begin(ADC_INPUT, TRIGGER_SLICE, ADC_Sampler->getCenterDelay());
+#else
+  started = ADC_Sampler->begin(ADC_INPUT);
+#endif
+
+  if ( !started || !ADC_Sampler->start() )
+  {
+    Serial.println(F("Error starting ADC sampling"));
+
+    while (true)
+      delay(1000);
+  }
+
+  Serial.print(F("Sample rate = "));
+  Serial.println(ADC_Sampler->getSampleRate());
+}
+
+void loop()
+{
+  static uint32_t lastPrint = 0;
+  static uint32_t sum       = 0;
+  static uint32_t count     = 0;
+  static uint32_t period    = 0;
+
+  PWM_ADC_Sample sample;
+
+  // Average all samples of the last second
+  while (ADC_Sampler->read(sample))
+  {
+    sum    += sample.value;
+    period  = sample.period;
+    count++;
+  }
+
+  if (millis() - lastPrint >= 1000)
+  {
+    lastPrint = millis();
+
+    Serial.print(F("Period = "));
+    Serial.print(period);
+    Serial.print(F(", samples = "));
+    Serial.print(count);
+    Serial.print(F(", average = "));
+    Serial.print(count ? sum / count : 0);
+    Serial.print(F(", overruns = "));
+    Serial.println(ADC_Sampler->getOverruns());
+
+    sum   = 0;
+    count = 0;
+  }
+}
@@ -0,0 +1,86 @@
+/****************************************************************************************************************************
+  PWM_Analyzer.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to analyze the frequency and dutycycle accuracy, effective bits and call cost of setPWM_Int()
+// over the whole frequency range, in both normal and phase-correct modes. Capture the CSV from the Serial Monitor
+// as a baseline, to compare whenever the TOP / DIV calculation or the dutycycle mapping changes
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Analyzer.h"
+
+// The slice of this pin is reprogrammed during the analysis
+#define pinToUse      25
+
+// Set to false to print only the histograms and summary
+#define PRINT_CSV     true
+
+RP2040_PWM_Analyzer* Analyzer;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Analyzer on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  Analyzer = new RP2040_PWM_Analyzer(pinToUse);
+
+  if (!Analyzer)
+  {
+    Serial.println(F("Error creating analyzer"));
+
+    while (true)
+      delay(1000);
+  }
+
+  // Whole range, 10 points per decade, dutycycle 0%, 10%, ..., 100%, 100 calls per cost measurement
+  Analyzer->setDutySteps(11);
+  Analyzer->setCostRepeats(100);
+
+  uint32_t points = Analyzer->run(PRINT_CSV ? &Serial : NULL);
+
+  Serial.print(F("\nAnalyzed points = "));
+  Serial.println(points);
+
+  Analyzer->printHistograms(Serial);
+  Analyzer->printSummary(Serial);
+
+  // Stop the output of the analyzed slice
+  Analyzer->getPWM()->disablePWM();
+}
+
+void loop()
+{
+}
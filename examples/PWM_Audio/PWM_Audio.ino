@@ -0,0 +1,116 @@
+/****************************************************************************************************************************
+  PWM_Audio.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the PCM audio playback over PWM, using DMA paced at the audio rate.
+// Use a simple RC low-pass filter (e.g. 1K / 10nF) on each output pin before the amplifier
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Audio.h"
+
+#define pin10         10    // PWM channel 5A, Left
+#define pin11         11    // PWM channel 5B, Right
+
+#define SAMPLE_RATE   22050
+#define BIT_DEPTH     8
+
+// 440Hz tone, 8-bit unsigned, 8KHz source, one period
+#define SOURCE_RATE   8000
+#define NUM_SAMPLES   18
+
+const uint8_t sine440[NUM_SAMPLES] =
+{
+  128, 172, 210, 238, 253, 253, 238, 210, 172, 128, 84, 46, 18, 3, 3, 18, 46, 84
+};
+
+RP2040_PWM_Audio* Audio_Instance;
+
+// Streaming callback : 1KHz / 500Hz square waves on Left / Right, 16-bit signed stereo
+uint32_t squareWave(int16_t* buffer, const uint32_t& frames)
+{
+  static uint32_t count = 0;
+
+  for (uint32_t i = 0; i < frames; i++, count++)
+  {
+    buffer[2 * i]     = ( (count / 11) & 0x01 ) ? 8000 : -8000;
+    buffer[2 * i + 1] = ( (count / 22) & 0x01 ) ? 8000 : -8000;
+  }
+
+  // Stop after 2s
+  if (count > 2 * SAMPLE_RATE)
+  {
+    count = 0;
+
+    return 0;
+  }
+
+  return frames;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Audio on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  Audio_Instance = new RP2040_PWM_Audio(pin10, pin11);
+
+  if ( !Audio_Instance || !Audio_Instance->begin(SAMPLE_RATE, BIT_DEPTH) )
+  {
+    Serial.println(F("Error starting PWM Audio"));
+
+    while (true)
+      delay(1000);
+  }
+
+  Serial.print(F("Carrier Freq (Hz) = "));
+  Serial.print(Audio_Instance->getCarrierFreq());
+  Serial.print(F(", Sample Rate (Hz) = "));
+  Serial.println(Audio_Instance->getActualSampleRate(), 2);
+}
+
+void loop()
+{
+  Serial.println(F("Play 440Hz tone, mono buffer, interpolated"));
+  Audio_Instance->play(sine440, NUM_SAMPLES, PWM_AUDIO_FORMAT_U8, 1, SOURCE_RATE, true, true);
+
+  delay(2000);
+
+  Serial.println(F("Play square waves, stereo stream"));
+  Audio_Instance->play(squareWave, 2, SAMPLE_RATE, false);
+
+  while (Audio_Instance->isPlaying())
+    delay(10);
+}
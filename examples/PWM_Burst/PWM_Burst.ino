@@ -0,0 +1,106 @@
+/****************************************************************************************************************************
+  PWM_Burst.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the burst mode, outputting exactly N pulses then stopping,
+// for camera triggers, ultrasonic bursts or stepper moves
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Burst.h"
+
+#define pin10         10    // PWM channel 5A
+
+#define pinToUse      pin10
+
+RP2040_PWM_Burst* Burst_Instance;
+
+volatile bool burstDone = false;
+
+// Called from IRQ context
+void burstCompleted(const uint& slice_num)
+{
+  (void) slice_num;
+
+  burstDone = true;
+}
+
+void runBurst(const char* title)
+{
+  Serial.print(title);
+  Serial.print(F(", actual Freq (Hz) = "));
+  Serial.print(Burst_Instance->getActualFreq());
+
+  burstDone = false;
+  Burst_Instance->start();
+
+  while (!burstDone)
+    delay(1);
+
+  Serial.print(F(", bursts = "));
+  Serial.print(Burst_Instance->getBurstCount());
+  Serial.print(F(", periods = "));
+  Serial.println(Burst_Instance->getPeriodCount());
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Burst on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  Burst_Instance = new RP2040_PWM_Burst(pinToUse);
+  Burst_Instance->attachCallback(burstCompleted);
+}
+
+void loop()
+{
+  // 10 pulses @ 1KHz, 50%
+  Burst_Instance->setBurst(1000.0f, 50.0f, 10);
+  runBurst("10 pulses @ 1KHz");
+
+  delay(1000);
+
+  // 3 bursts of 8 pulses @ 40KHz, 50%, 100 periods gap
+  Burst_Instance->setBurst(40000.0f, 50.0f, 8, 3, 100);
+  runBurst("3 x 8 pulses @ 40KHz, gap 100 periods");
+
+  delay(1000);
+
+  // 1000 pulses @ 2MHz, 50%, counted by DMA
+  Burst_Instance->setBurst(2000000.0f, 50.0f, 1000, 1, 0, PWM_BURST_DMA);
+  runBurst("1000 pulses @ 2MHz using DMA");
+
+  delay(1000);
+}
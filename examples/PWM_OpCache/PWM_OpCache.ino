@@ -0,0 +1,129 @@
+/****************************************************************************************************************************
+  PWM_OpCache.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the operating-point cache, for steppers or pumps moving between a few known speeds,
+// and measure the average time of setPWM() switching between cached and between uncached frequencies
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM.h"
+
+#define UPDATE_INTERVAL       1000L
+
+#define pinToUse      10
+
+// Known speeds, solved once at boot
+float speeds[] = { 500.0f, 1000.0f, 2500.0f, 4000.0f };
+
+#define NUM_SPEEDS    ( sizeof(speeds) / sizeof(float) )
+
+RP2040_PWM* PWM_Instance;
+
+// Average ns per setPWM() over UPDATE_INTERVAL ms. cached = false to use a new frequency at each call
+uint32_t measureTransition(const bool& cached)
+{
+  uint32_t count      = 0;
+  uint32_t startTime  = millis();
+  float    offset     = 0;
+
+  while (millis() - startTime < UPDATE_INTERVAL)
+  {
+    if (!cached)
+    {
+      // Never seen before, so always a miss
+      offset += 0.001f;
+    }
+
+    PWM_Instance->setPWM(pinToUse, speeds[count % NUM_SPEEDS] + offset, 50.0f);
+
+    count++;
+  }
+
+  return UPDATE_INTERVAL * 1000000 / count;
+}
+
+void printStats()
+{
+  const PWM_OpCache_Stats& stats = PWM_opCacheStats();
+
+  Serial.print(F("Hits = "));
+  Serial.print(stats.hits);
+  Serial.print(F(", Misses = "));
+  Serial.print(stats.misses);
+  Serial.print(F(", Evictions = "));
+  Serial.println(stats.evictions);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_OpCache on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  Serial.print(F("Cache size = "));
+  Serial.println(PWM_OP_CACHE_SIZE);
+
+  Serial.print(F("Preloaded = "));
+  Serial.println(PWM_opCachePreload(speeds, NUM_SPEEDS));
+
+  PWM_Instance = new RP2040_PWM(pinToUse, speeds[0], 50.0f);
+
+  if (PWM_Instance)
+  {
+    PWM_Instance->setPWM();
+  }
+}
+
+void loop()
+{
+  PWM_opCacheResetStats();
+
+  Serial.print(F("Cached transitions, ns = "));
+  Serial.println(measureTransition(true));
+
+  printStats();
+
+  PWM_opCacheResetStats();
+
+  Serial.print(F("Uncached transitions, ns = "));
+  Serial.println(measureTransition(false));
+
+  printStats();
+
+  // Uncached frequencies evicted the speeds
+  PWM_opCachePreload(speeds, NUM_SPEEDS);
+
+  delay(UPDATE_INTERVAL);
+}
@@ -0,0 +1,123 @@
+/****************************************************************************************************************************
+  PWM_Resource.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the pin / slice resource allocator : compile-time check of constant pins, runtime
+// detection of two objects fighting for the same slice, and automatic placement of a set of frequencies
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Resource.h"
+
+// GP0 and GP16 are the same channel A of slice 0. Using both here would fail to compile
+#define pinMotor      0
+#define pinFan        1
+#define pinHighSide   2
+#define pinLowSide    3
+
+PWM_ASSERT_PINS_UNIQUE(pinMotor, pinFan, pinHighSide, pinLowSide);
+PWM_ASSERT_PUSHPULL(pinHighSide, pinLowSide);
+
+// Needed outputs, placed automatically on the remaining channels
+PWM_Placement placement[] =
+{
+  // frequency, phaseCorrect, channels
+  { 20000.0f,   false,        5 },
+  { 1000.0f,    false,        3 },
+  { 50.0f,      true,         2 }
+};
+
+#define NUM_PLACEMENTS        ( sizeof(placement) / sizeof(PWM_Placement) )
+
+// Pico header pins only : GP23, GP24, GP25 and GP29 are used on board
+#define PICO_HEADER_PINS      ( PWM_RESOURCE_ALL_PINS & ~( (1UL << 23) | (1UL << 24) | (1UL << 25) | (1UL << 29) ) )
+
+RP2040_PWM* PWM_Instance[2 * NUM_PWM_SLICES];
+uint8_t     numInstances = 0;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Resource on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  RP2040_PWM* motor     = new RP2040_PWM(pinMotor, 20000, 50);
+  RP2040_PWM* fan       = new RP2040_PWM(pinFan, 25000, 50);
+  RP2040_PWM* pushPull  = new RP2040_PWM(pinHighSide, 100000, 50);
+
+  motor->setPWM();
+  pushPull->setPWMPushPull(pinHighSide, pinLowSide, 100000, 50);
+
+  // Same slice as the motor, another frequency : warning with _PWM_LOGLEVEL_ > 1, refused if PWM_RESOURCE_STRICT
+  fan->setPWM();
+
+  if (PWM_resourceOwner(pinFan) != fan)
+  {
+    Serial.println(F("Fan : conflict on slice 0, moved to the motor frequency"));
+
+    fan->setPWM(pinFan, 20000, 50);
+  }
+
+  if (PWM_resourcePlace(placement, NUM_PLACEMENTS, PICO_HEADER_PINS))
+  {
+    for (uint8_t i = 0; i < NUM_PLACEMENTS; i++)
+    {
+      Serial.print(F("Freq = "));
+      Serial.print(placement[i].frequency);
+      Serial.print(F(", pins ="));
+
+      for (uint8_t j = 0; j < placement[i].channels; j++)
+      {
+        Serial.print(F(" GP"));
+        Serial.print(placement[i].pins[j]);
+
+        // Claims the reserved channel, as the frequency matches
+        PWM_Instance[numInstances] = new RP2040_PWM(placement[i].pins[j], placement[i].frequency, 25);
+        PWM_Instance[numInstances++]->setPWM(placement[i].pins[j], placement[i].frequency, 25, placement[i].phaseCorrect);
+      }
+
+      Serial.println();
+    }
+  }
+  else
+  {
+    Serial.println(F("Not enough PWM channels for the placement"));
+  }
+
+  PWM_resourcePrint(Serial);
+}
+
+void loop()
+{
+}
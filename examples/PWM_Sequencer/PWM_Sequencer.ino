@@ -0,0 +1,128 @@
+/****************************************************************************************************************************
+  PWM_Sequencer.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the sequencer running a timed multi-channel PWM script from a hardware alarm,
+// without setPWM() and delay() in loop(). Then the throughput of the interpreter is measured in ops/s
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Sequencer.h"
+
+#define pin10         10    // PWM channel 5A
+#define pin11         11    // PWM channel 5B
+#define pin14         14    // PWM channel 7A
+
+// Tick = 1ms
+#define TICK_US       1000
+
+// Light show : 1KHz on slice 5 and 7, channels fading in turn, 5 times
+const PWM_Seq_Op lightShow[] =
+{
+  /* 0 */ PWM_SEQ_OP_FREQ    (  0, pin10, 1000),
+  /* 1 */ PWM_SEQ_OP_FREQ    (  0, pin14, 1000),
+  /* 2 */ PWM_SEQ_OP_ENABLE  (  0, pin10),
+  /* 3 */ PWM_SEQ_OP_ENABLE  (  0, pin14),
+  /* 4 */ PWM_SEQ_OP_DUTY    (  0, pin10,      0),
+  /* 5 */ PWM_SEQ_OP_DUTY    (  0, pin11, 100000),
+  /* 6 */ PWM_SEQ_OP_DUTY    (  0, pin14,  50000),
+  /* 7 */ PWM_SEQ_OP_DUTY    (250, pin10,  25000),
+  /* 8 */ PWM_SEQ_OP_DUTY    (  0, pin11,  75000),
+  /* 9 */ PWM_SEQ_OP_DUTY    (250, pin10,  50000),
+  /*10 */ PWM_SEQ_OP_DUTY    (  0, pin11,  50000),
+  /*11 */ PWM_SEQ_OP_DUTY    (  0, pin14, 100000),
+  /*12 */ PWM_SEQ_OP_DUTY    (250, pin10,  75000),
+  /*13 */ PWM_SEQ_OP_DUTY    (  0, pin11,  25000),
+  /*14 */ PWM_SEQ_OP_DUTY    (250, pin10, 100000),
+  /*15 */ PWM_SEQ_OP_DUTY    (  0, pin11,      0),
+  /*16 */ PWM_SEQ_OP_DUTY    (  0, pin14,      0),
+  /*17 */ PWM_SEQ_OP_LOOP    (250, 4, 4),
+  /*18 */ PWM_SEQ_OP_DISABLE (  0, pin10),
+  /*19 */ PWM_SEQ_OP_DISABLE (  0, pin14),
+  /*20 */ PWM_SEQ_OP_END     (  0)
+};
+
+// Benchmark : 4 level ops then loop forever
+const PWM_Seq_Op benchmark[] =
+{
+  /* 0 */ PWM_SEQ_OP_LEVEL   (1, pin10, 100),
+  /* 1 */ PWM_SEQ_OP_LEVEL   (1, pin11, 200),
+  /* 2 */ PWM_SEQ_OP_LEVEL   (1, pin10, 300),
+  /* 3 */ PWM_SEQ_OP_LEVEL   (1, pin11, 400),
+  /* 4 */ PWM_SEQ_OP_JUMP    (1, 0)
+};
+
+RP2040_PWM_Sequencer* Sequencer;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Sequencer on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  Sequencer = new RP2040_PWM_Sequencer(TICK_US);
+
+  Sequencer->attachPin(pin10);
+  Sequencer->attachPin(pin11);
+  Sequencer->attachPin(pin14);
+
+  Sequencer->load(lightShow, sizeof(lightShow) / sizeof(PWM_Seq_Op));
+  Sequencer->start();
+
+  Serial.println(F("Light show running"));
+
+  // The main loop is free while the script runs
+  while (Sequencer->isRunning())
+    delay(100);
+
+  Serial.print(F("Light show done, ops = "));
+  Serial.println(Sequencer->getOpCount());
+
+  // Interpreter throughput, ignoring the delays
+  Sequencer->load(benchmark, sizeof(benchmark) / sizeof(PWM_Seq_Op));
+
+  uint32_t startTime = millis();
+
+  while (millis() - startTime < 1000)
+  {
+    Sequencer->execute();
+  }
+
+  Serial.print(F("Throughput (ops/s) = "));
+  Serial.println(Sequencer->getOpCount());
+}
+
+void loop()
+{
+}
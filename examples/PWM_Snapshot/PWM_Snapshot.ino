@@ -0,0 +1,93 @@
+/****************************************************************************************************************************
+  PWM_Snapshot.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the PWM configuration snapshot and instant restore.
+// The snapshot printed here can be pasted as a const PWM_Snapshot, to restore all PWM outputs at boot
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Snapshot.h"
+
+#define NUM_OF_PINS       4
+
+uint32_t PWM_Pins[]       = { 10, 11, 14, 16 };
+float    frequency[]      = { 2000.0f, 2000.0f, 5000.0f, 20000.0f };
+float    dutyCycle[]      = { 25.0f, 75.0f, 50.0f, 10.0f };
+
+RP2040_PWM* PWM_Instance[NUM_OF_PINS];
+
+PWM_Snapshot snapshot;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Snapshot on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  // Normal path : constructor with calc_TOP_and_DIV(), then setPWM() per channel
+  uint32_t startTime = micros();
+
+  for (uint8_t index = 0; index < NUM_OF_PINS; index++)
+  {
+    PWM_Instance[index] = new RP2040_PWM(PWM_Pins[index], frequency[index], dutyCycle[index]);
+    PWM_Instance[index]->setPWM();
+  }
+
+  uint32_t normalTime = micros() - startTime;
+
+  PWM_snapshotCapture(snapshot);
+  PWM_snapshotPrint(snapshot, Serial);
+
+  for (uint8_t index = 0; index < NUM_OF_PINS; index++)
+  {
+    PWM_Instance[index]->disablePWM();
+  }
+
+  // Restore path : registers straight from the snapshot, one pwm_hw->en write
+  startTime = micros();
+
+  PWM_snapshotRestore(snapshot);
+
+  uint32_t restoreTime = micros() - startTime;
+
+  Serial.print(F("Constructor + setPWM (us) = "));
+  Serial.print(normalTime);
+  Serial.print(F(", Snapshot restore (us) = "));
+  Serial.println(restoreTime);
+}
+
+void loop()
+{
+}
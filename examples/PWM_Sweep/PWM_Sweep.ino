@@ -0,0 +1,96 @@
+/****************************************************************************************************************************
+  PWM_Sweep.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the frequency sweep / chirp generator, with TOP updated at every PWM period
+// and the dutycycle held constant. Useful for ultrasonic transducer drive and impedance scanning
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Sweep.h"
+
+#define pin10         10    // PWM channel 5A
+
+#define pinToUse      pin10
+
+RP2040_PWM_Sweep* Sweep_Instance;
+
+void printSweepInfo(RP2040_PWM_Sweep* Sweep_Instance)
+{
+  Serial.print(F("Sweeps = "));
+  Serial.print(Sweep_Instance->getSweepCount());
+  Serial.print(F(", Periods = "));
+  Serial.print(Sweep_Instance->getPeriodCount());
+  Serial.print(F(", Freq (Hz) = "));
+  Serial.println(Sweep_Instance->getCurrentFreq());
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Sweep on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  Sweep_Instance = new RP2040_PWM_Sweep(pinToUse);
+}
+
+void loop()
+{
+  // Linear chirp 35-45KHz in 5ms, 50% dutycycle, 100 times
+  Serial.println(F("Linear sweep 35KHz => 45KHz, 5ms, 100 times"));
+  Sweep_Instance->setSweep(35000.0f, 45000.0f, 5.0f, 50.0f, PWM_SWEEP_LINEAR, 100);
+  Sweep_Instance->start();
+
+  while (!Sweep_Instance->isFinished())
+    delay(1);
+
+  printSweepInfo(Sweep_Instance);
+
+  delay(1000);
+
+  // Log chirp 100Hz-10KHz in 2s, 25% dutycycle, repeated until stop()
+  Serial.println(F("Log sweep 100Hz => 10KHz, 2s, forever"));
+  Sweep_Instance->setSweep(100.0f, 10000.0f, 2000.0f, 25.0f, PWM_SWEEP_LOG, PWM_SWEEP_FOREVER);
+  Sweep_Instance->start();
+
+  for (uint8_t i = 0; i < 10; i++)
+  {
+    delay(1000);
+    printSweepInfo(Sweep_Instance);
+  }
+
+  Sweep_Instance->stop();
+
+  delay(1000);
+}
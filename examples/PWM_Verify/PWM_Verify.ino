@@ -0,0 +1,113 @@
+/****************************************************************************************************************************
+  PWM_Verify.ino
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  The RP2040 PWM block has 8 identical slices. Each slice can drive two PWM output signals, or measure the frequency
+  or duty cycle of an input signal. This gives a total of up to 16 controllable PWM outputs. All 30 GPIO pins can be driven
+  by the PWM block
+*****************************************************************************************************************************/
+// This example to demo the output verification, detecting and repairing a slice reconfigured
+// behind the library, as done here by direct pico-sdk calls simulating another library
+
+#define _PWM_LOGLEVEL_        2
+
+#if ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+      defined(ARDUINO_GENERIC_RP2040) ) && defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_MBED_RP2040_PWM
+  #endif
+
+#elif ( defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_ADAFRUIT_FEATHER_RP2040) || \
+        defined(ARDUINO_GENERIC_RP2040) ) && !defined(ARDUINO_ARCH_MBED)
+
+  #if(_PWM_LOGLEVEL_>3)
+    #warning USING_RP2040_PWM
+  #endif
+#else
+  #error This code is intended to run on the RP2040 mbed_nano, mbed_rp2040 or arduino-pico platform! Please check your Tools->Board setting.
+#endif
+
+#include "RP2040_PWM_Verify.h"
+
+#define pin10         10    // PWM channel 5A
+#define pin14         14    // PWM channel 7A
+
+// Check 2 slices every 100ms
+#define VERIFY_INTERVAL_MS      100
+
+RP2040_PWM* PWM_Instance1;
+RP2040_PWM* PWM_Instance2;
+
+RP2040_PWM_Verify PWM_Verify(true, 2);
+
+volatile uint8_t lastSlice    = 0xFF;
+volatile uint8_t lastMismatch = 0;
+
+// Called from timer IRQ. No Serial here
+void mismatchDetected(const uint& slice_num, const uint8_t& mismatch)
+{
+  lastSlice     = slice_num;
+  lastMismatch  = mismatch;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  delay(100);
+
+  Serial.print(F("\nStarting PWM_Verify on "));
+  Serial.println(BOARD_NAME);
+  Serial.println(RP2040_PWM_VERSION);
+
+  PWM_Instance1 = new RP2040_PWM(pin10, 1000.0f, 50.0f);
+  PWM_Instance1->setPWM();
+
+  PWM_Instance2 = new RP2040_PWM(pin14, 20000.0f, 25.0f);
+  PWM_Instance2->setPWM();
+
+  // Also compared with the TOP, DIV, phaseCorrect and level intended by each instance
+  PWM_Verify.addInstance(PWM_Instance1);
+  PWM_Verify.addInstance(PWM_Instance2);
+
+  PWM_Verify.attachCallback(mismatchDetected);
+  PWM_Verify.startTimer(VERIFY_INTERVAL_MS);
+}
+
+void loop()
+{
+  static uint8_t step = 0;
+
+  // Corrupt one slice every 2s, as another library would do
+  if ( (step++ & 0x01) == 0)
+  {
+    Serial.println(F("Corrupting TOP of slice 5"));
+    pwm_set_wrap(pwm_gpio_to_slice_num(pin10), 1000);
+  }
+  else
+  {
+    Serial.println(F("Corrupting CC and CSR of slice 7"));
+    pwm_set_chan_level(pwm_gpio_to_slice_num(pin14), PWM_CHAN_A, 0);
+    pwm_set_phase_correct(pwm_gpio_to_slice_num(pin14), true);
+  }
+
+  delay(2000);
+
+  Serial.print(F("Checks = "));
+  Serial.print(PWM_Verify.getCheckCount());
+  Serial.print(F(", Mismatches = "));
+  Serial.print(PWM_Verify.getMismatchCount());
+  Serial.print(F(", Repairs = "));
+  Serial.print(PWM_Verify.getRepairCount());
+  Serial.print(F(", Last slice = "));
+  Serial.print(lastSlice);
+  Serial.print(F(", Registers = 0x"));
+  Serial.println(lastMismatch, HEX);
+}
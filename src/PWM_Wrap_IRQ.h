@@ -0,0 +1,133 @@
+/****************************************************************************************************************************
+  PWM_Wrap_IRQ.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef PWM_WRAP_IRQ_H
+#define PWM_WRAP_IRQ_H
+
+// Dispatcher of the shared PWM_IRQ_WRAP interrupt to per-slice callbacks,
+// used by the sweep, burst, sequencer, modulation and ADC trigger engines
+
+#include "RP2040_PWM.h"
+
+#include "hardware/irq.h"
+
+///////////////////////////////////////////////////////////////////
+
+typedef void (*PWM_Wrap_Callback)(const uint& slice_num, void* param);
+
+typedef struct
+{
+  PWM_Wrap_Callback callback;
+  void*             param;
+} PWM_wrap_handler;
+
+static PWM_wrap_handler PWM_wrap_handler_data[NUM_PWM_SLICES] =
+{
+  { NULL, NULL },
+  { NULL, NULL },
+  { NULL, NULL },
+  { NULL, NULL },
+  { NULL, NULL },
+  { NULL, NULL },
+  { NULL, NULL },
+  { NULL, NULL }
+};
+
+static bool PWM_wrap_IRQ_installed = false;
+
+////////////////////////////////////////
+
+static void PWM_Wrap_IRQ_handler()
+{
+  uint32_t status = pwm_get_irq_status_mask();
+
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    // Only the slices attached in this file, as the IRQ is shared
+    if ( (status & (1u << slice_num)) && PWM_wrap_handler_data[slice_num].callback )
+    {
+      pwm_clear_irq(slice_num);
+      PWM_wrap_handler_data[slice_num].callback(slice_num, PWM_wrap_handler_data[slice_num].param);
+    }
+  }
+}
+
+////////////////////////////////////////
+
+// Call callback(slice_num, param) at every wrap of the slice, from PWM_IRQ_WRAP
+inline bool PWM_attachWrapInterrupt(const uint& slice_num, PWM_Wrap_Callback callback, void* param = NULL)
+{
+  if ( (slice_num >= NUM_PWM_SLICES) || (callback == NULL) )
+    return false;
+
+  if ( PWM_wrap_handler_data[slice_num].callback && (PWM_wrap_handler_data[slice_num].callback != callback) )
+  {
+    PWM_LOGWARN1("Warning, replacing wrap callback of slice =", slice_num);
+  }
+
+  pwm_set_irq_enabled(slice_num, false);
+
+  PWM_wrap_handler_data[slice_num].callback = callback;
+  PWM_wrap_handler_data[slice_num].param    = param;
+
+  if (!PWM_wrap_IRQ_installed)
+  {
+    irq_add_shared_handler(PWM_IRQ_WRAP, PWM_Wrap_IRQ_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+
+    PWM_wrap_IRQ_installed = true;
+  }
+
+  pwm_clear_irq(slice_num);
+  pwm_set_irq_enabled(slice_num, true);
+
+  return true;
+}
+
+////////////////////////////////////////
+
+inline void PWM_detachWrapInterrupt(const uint& slice_num)
+{
+  if (slice_num >= NUM_PWM_SLICES)
+    return;
+
+  pwm_set_irq_enabled(slice_num, false);
+  pwm_clear_irq(slice_num);
+
+  PWM_wrap_handler_data[slice_num].callback = NULL;
+  PWM_wrap_handler_data[slice_num].param    = NULL;
+}
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // PWM_WRAP_IRQ_H
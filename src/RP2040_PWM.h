@@ -6,7 +6,7 @@
   Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
   Licensed under MIT license
 
-  Version: 1.7.0
+  Version: 1.8.0
 
   Version Modified By   Date      Comments
   ------- -----------  ---------- -----------
@@ -26,6 +26,7 @@
   1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
   1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
   1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
 *****************************************************************************************************************************/
 
 #pragma once
@@ -69,19 +70,20 @@
 ///////////////////////////////////////////////////////////////////
 
 #ifndef RP2040_PWM_VERSION
-  #define RP2040_PWM_VERSION           "RP2040_PWM v1.7.0"
+  #define RP2040_PWM_VERSION           "RP2040_PWM v1.8.0"
   
   #define RP2040_PWM_VERSION_MAJOR     1
-  #define RP2040_PWM_VERSION_MINOR     7
+  #define RP2040_PWM_VERSION_MINOR     8
   #define RP2040_PWM_VERSION_PATCH     0
 
-  #define RP2040_PWM_VERSION_INT       1007000
+  #define RP2040_PWM_VERSION_INT       1008000
 #endif
 
 ///////////////////////////////////////////////////////////////////
 
 #include <math.h>
 #include <float.h>
+#include <string.h>
 #include "hardware/pwm.h"
 
 #include "PWM_Generic_Debug.h"
@@ -148,6 +150,655 @@ static PWM_slice_manual PWM_slice_manual_data[NUM_PWM_SLICES] =
   { 0, 0, false, false, false }
 };
 
+////////////////////////////////////////
+
+// Register shadow of each slice, to write only the registers really changed
+// CC is kept as the full 32-bit word holding both channel A and B levels
+
+#define PWM_SHADOW_CSR        0x01
+#define PWM_SHADOW_DIV        0x02
+#define PWM_SHADOW_TOP        0x04
+#define PWM_SHADOW_CC         0x08
+
+#define PWM_SHADOW_ALL        ( PWM_SHADOW_CSR | PWM_SHADOW_DIV | PWM_SHADOW_TOP | PWM_SHADOW_CC )
+
+// Set to true to count the bus writes, and those the same calls did up to v1.7.0, one pico-sdk call per register
+#if !defined(PWM_SHADOW_STATISTICS)
+  #define PWM_SHADOW_STATISTICS      false
+#endif
+
+typedef struct
+{
+  uint32_t csr;
+  uint32_t div;
+  uint32_t top;
+  uint32_t cc;
+  uint8_t  dirty;
+  bool     loaded;
+} PWM_slice_shadow;
+
+// Registers of a slice, or a mask of their bits
+typedef struct
+{
+  uint32_t csr;
+  uint32_t div;
+  uint32_t top;
+  uint32_t cc;
+} PWM_slice_regs;
+
+static PWM_slice_shadow PWM_slice_shadow_data[NUM_PWM_SLICES] =
+{
+  { 0, 0, 0, 0, 0, false },
+  { 0, 0, 0, 0, 0, false },
+  { 0, 0, 0, 0, 0, false },
+  { 0, 0, 0, 0, 0, false },
+  { 0, 0, 0, 0, 0, false },
+  { 0, 0, 0, 0, 0, false },
+  { 0, 0, 0, 0, 0, false },
+  { 0, 0, 0, 0, 0, false }
+};
+
+#if PWM_SHADOW_STATISTICS
+
+// Counted by the RP2040_PWM calls only. The engines writing through the shadow had no v1.7.0 equivalent
+typedef struct
+{
+  // Register writes of the v1.7.0 code path for the same calls : pwm_init() is 6 writes, other pwm_xyz() 1 each
+  uint32_t legacy;
+  // Register writes really done on the bus
+  uint32_t written;
+} PWM_shadow_stats;
+
+static PWM_shadow_stats PWM_shadow_stats_data = { 0, 0 };
+
+#define PWM_SHADOW_COUNT_LEGACY(writes)     PWM_shadow_stats_data.legacy  += (writes)
+#define PWM_SHADOW_COUNT_WRITTEN(writes)    PWM_shadow_stats_data.written += (writes)
+
+// Number of bus writes saved, compared to the v1.7.0 code path
+inline uint32_t PWM_shadow_writes_saved()
+{
+  return PWM_shadow_stats_data.legacy - PWM_shadow_stats_data.written;
+}
+
+inline const PWM_shadow_stats& PWM_shadow_get_stats()
+{
+  return PWM_shadow_stats_data;
+}
+
+inline void PWM_shadow_reset_stats()
+{
+  PWM_shadow_stats_data.legacy  = 0;
+  PWM_shadow_stats_data.written = 0;
+}
+
+#else
+
+#define PWM_SHADOW_COUNT_LEGACY(writes)     (void) (writes)
+#define PWM_SHADOW_COUNT_WRITTEN(writes)    (void) (writes)
+
+#endif    // PWM_SHADOW_STATISTICS
+
+////////////////////////////////////////
+
+// Read the real registers once, so that the shadow starts in sync with the hardware
+inline void PWM_shadow_load(const uint& slice_num)
+{
+  PWM_slice_shadow* shadow = &PWM_slice_shadow_data[slice_num];
+
+  shadow->csr    = pwm_hw->slice[slice_num].csr;
+  shadow->div    = pwm_hw->slice[slice_num].div;
+  shadow->top    = pwm_hw->slice[slice_num].top;
+  shadow->cc     = pwm_hw->slice[slice_num].cc;
+  shadow->dirty  = 0;
+  shadow->loaded = true;
+}
+
+////////////////////////////////////////
+
+inline void PWM_shadow_update(const uint& slice_num, uint32_t& reg, const uint32_t& value, const uint8_t& mask)
+{
+  if (!PWM_slice_shadow_data[slice_num].loaded)
+    PWM_shadow_load(slice_num);
+
+  if (reg != value)
+  {
+    reg = value;
+    PWM_slice_shadow_data[slice_num].dirty |= mask;
+  }
+}
+
+////////////////////////////////////////
+
+inline void PWM_shadow_set_csr(const uint& slice_num, const uint32_t& csr)
+{
+  PWM_shadow_update(slice_num, PWM_slice_shadow_data[slice_num].csr, csr, PWM_SHADOW_CSR);
+}
+
+inline void PWM_shadow_set_csr_bits(const uint& slice_num, const uint32_t& bits, const bool& value)
+{
+  if (!PWM_slice_shadow_data[slice_num].loaded)
+    PWM_shadow_load(slice_num);
+
+  uint32_t csr = PWM_slice_shadow_data[slice_num].csr;
+
+  PWM_shadow_set_csr(slice_num, value ? (csr | bits) : (csr & ~bits) );
+}
+
+inline void PWM_shadow_set_div(const uint& slice_num, const uint32_t& div)
+{
+  PWM_shadow_update(slice_num, PWM_slice_shadow_data[slice_num].div, div, PWM_SHADOW_DIV);
+}
+
+inline void PWM_shadow_set_top(const uint& slice_num, const uint32_t& top)
+{
+  PWM_shadow_update(slice_num, PWM_slice_shadow_data[slice_num].top, top, PWM_SHADOW_TOP);
+}
+
+inline void PWM_shadow_set_level(const uint& slice_num, const uint& chan, const uint16_t& level)
+{
+  if (!PWM_slice_shadow_data[slice_num].loaded)
+    PWM_shadow_load(slice_num);
+
+  uint32_t cc = PWM_slice_shadow_data[slice_num].cc;
+
+  if (chan == PWM_CHAN_A)
+    cc = (cc & ~PWM_CH0_CC_A_BITS) | ( ((uint32_t) level) << PWM_CH0_CC_A_LSB );
+  else
+    cc = (cc & ~PWM_CH0_CC_B_BITS) | ( ((uint32_t) level) << PWM_CH0_CC_B_LSB );
+
+  PWM_shadow_update(slice_num, PWM_slice_shadow_data[slice_num].cc, cc, PWM_SHADOW_CC);
+}
+
+////////////////////////////////////////
+
+// Write only the dirty registers. CSR goes last, so that the slice is enabled with the new DIV, TOP and CC
+// If restart, the slice is stopped and its counter cleared first, the same as pwm_init()
+// Return the number of bus writes done
+inline uint8_t PWM_shadow_flush(const uint& slice_num, const bool& restart = false)
+{
+  PWM_slice_shadow* shadow = &PWM_slice_shadow_data[slice_num];
+  uint8_t writes = 0;
+
+  if (restart)
+  {
+    pwm_hw->slice[slice_num].csr = 0;
+    pwm_hw->slice[slice_num].ctr = PWM_CH0_CTR_RESET;
+
+    writes += 2;
+
+    shadow->dirty |= PWM_SHADOW_CSR;
+  }
+
+  if (shadow->dirty & PWM_SHADOW_DIV)
+  {
+    pwm_hw->slice[slice_num].div = shadow->div;
+    writes++;
+  }
+
+  if (shadow->dirty & PWM_SHADOW_TOP)
+  {
+    pwm_hw->slice[slice_num].top = shadow->top;
+    writes++;
+  }
+
+  if (shadow->dirty & PWM_SHADOW_CC)
+  {
+    pwm_hw->slice[slice_num].cc = shadow->cc;
+    writes++;
+  }
+
+  if (shadow->dirty & PWM_SHADOW_CSR)
+  {
+    pwm_hw->slice[slice_num].csr = shadow->csr;
+    writes++;
+  }
+
+  shadow->dirty = 0;
+
+  return writes;
+}
+
+////////////////////////////////////////
+
+// TOP and DIV for freq, as used by RP2040_PWM. Return false if freq is too low
+// actualFreq is before the phaseCorrect compensation, as getActualFreq()
+inline bool PWM_calc_TOP_and_DIV(const uint32_t& freq_CPU, const float& freq, const bool& phaseCorrect,
+                                 uint32_t& top, uint32_t& div, float& actualFreq)
+{
+  if (freq > 2000.0)
+  {
+    div = 1;
+  }
+  else if (freq >= 200.0) 
+  {
+    div = 10;
+  }
+  else if (freq >= 20.0) 
+  {
+    div = 100;
+  }
+  else if (freq >= 10.0) 
+  {
+    div = 200;
+  }
+  else if (freq >= ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000))
+  {
+    div = 255;
+  }
+  else
+  {
+    PWM_LOGERROR1("Error, freq must be >=", ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000));
+    
+    return false;
+  }
+  
+  // Formula => PWM_Freq = ( F_CPU ) / [ ( TOP + 1 ) * ( DIV + DIV_FRAC/16) ]
+  top = ( freq_CPU / freq / div ) - 1;
+     
+  actualFreq = ( freq_CPU  ) / ( (top + 1) * div );
+  
+  // Compensate half freq if phaseCorrect
+  if (phaseCorrect)
+    top /= 2;
+  
+  return true;
+}
+
+////////////////////////////////////////
+
+// Operating-point cache. Solved TOP / DIV / actual frequency of the last frequencies used, with the duty
+// to level scale factor, so that going back to one of them skips the float range checks and calculation.
+// Shared by all instances, least recently used entry replaced. Set PWM_OP_CACHE_SIZE to 0 to disable
+
+#if !defined(PWM_OP_CACHE_SIZE)
+  #define PWM_OP_CACHE_SIZE         8
+#endif
+
+typedef struct
+{
+  // Bits of the float frequency, exact match only
+  uint32_t  key;
+  uint32_t  top;
+  uint32_t  div;
+  float     actualFreq;
+  // level = ( (dutycycle / 2) * levelScale ) >> 32, same result as ( top * (dutycycle / 2) ) / 50000
+  uint64_t  levelScale;
+  // Value of PWM_op_cache_stats_data.clock when last used
+  uint32_t  lastUsed;
+  bool      phaseCorrect;
+  bool      valid;
+} PWM_OpPoint;
+
+typedef struct
+{
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t clock;
+} PWM_OpCache_Stats;
+
+static PWM_OpCache_Stats PWM_op_cache_stats_data = { 0, 0, 0, 0 };
+
+#if (PWM_OP_CACHE_SIZE > 0)
+  // Zero-initialized, all invalid
+  static PWM_OpPoint PWM_op_cache_data[PWM_OP_CACHE_SIZE];
+#endif
+
+////////////////////////////////////////
+
+// Scale factor of the duty to level mapping. Rounded up 2^32 / 50000, exact for dutycycle up to 100,000
+inline uint64_t PWM_levelScale(const uint32_t& top)
+{
+  return ( ( (uint64_t) top << 32) + 49999 ) / 50000;
+}
+
+inline uint32_t PWM_opLevel(const uint64_t& levelScale, const uint32_t& dutycycle)
+{
+  return (uint32_t) ( ( (uint64_t) (dutycycle >> 1) * levelScale ) >> 32 );
+}
+
+////////////////////////////////////////
+
+inline uint32_t PWM_opKey(const float& frequency)
+{
+  uint32_t key;
+
+  memcpy(&key, &frequency, sizeof(key));
+
+  return key;
+}
+
+////////////////////////////////////////
+
+// NULL if not cached, without counting
+inline PWM_OpPoint* PWM_opCacheLookup(const float& frequency, const bool& phaseCorrect)
+{
+#if (PWM_OP_CACHE_SIZE > 0)
+  uint32_t key = PWM_opKey(frequency);
+
+  for (uint8_t i = 0; i < PWM_OP_CACHE_SIZE; i++)
+  {
+    PWM_OpPoint* point = &PWM_op_cache_data[i];
+
+    if (point->valid && (point->key == key) && (point->phaseCorrect == phaseCorrect))
+      return point;
+  }
+#else
+  (void) frequency;
+  (void) phaseCorrect;
+#endif
+
+  return NULL;
+}
+
+////////////////////////////////////////
+
+// NULL if not cached. Counts a hit or a miss
+inline PWM_OpPoint* PWM_opCacheFind(const float& frequency, const bool& phaseCorrect)
+{
+  PWM_OpPoint* point = PWM_opCacheLookup(frequency, phaseCorrect);
+
+  if (point)
+  {
+    point->lastUsed = ++PWM_op_cache_stats_data.clock;
+    PWM_op_cache_stats_data.hits++;
+  }
+  else
+  {
+    PWM_op_cache_stats_data.misses++;
+  }
+
+  return point;
+}
+
+////////////////////////////////////////
+
+// Store a solved point in a free entry, or in place of the least recently used one
+inline PWM_OpPoint* PWM_opCacheInsert(const float& frequency, const bool& phaseCorrect, const uint32_t& top,
+                                      const uint32_t& div, const float& actualFreq)
+{
+#if (PWM_OP_CACHE_SIZE > 0)
+  PWM_OpPoint* point = &PWM_op_cache_data[0];
+
+  for (uint8_t i = 0; i < PWM_OP_CACHE_SIZE; i++)
+  {
+    if (!PWM_op_cache_data[i].valid)
+    {
+      point = &PWM_op_cache_data[i];
+      break;
+    }
+
+    if (PWM_op_cache_data[i].lastUsed < point->lastUsed)
+      point = &PWM_op_cache_data[i];
+  }
+
+  if (point->valid)
+    PWM_op_cache_stats_data.evictions++;
+
+  point->key          = PWM_opKey(frequency);
+  point->top          = top;
+  point->div          = div;
+  point->actualFreq   = actualFreq;
+  point->levelScale   = PWM_levelScale(top);
+  point->lastUsed     = ++PWM_op_cache_stats_data.clock;
+  point->phaseCorrect = phaseCorrect;
+  point->valid        = true;
+
+  return point;
+#else
+  (void) frequency;
+  (void) phaseCorrect;
+  (void) top;
+  (void) div;
+  (void) actualFreq;
+
+  return NULL;
+#endif
+}
+
+////////////////////////////////////////
+
+// Solve and cache the known operating points, e.g. at boot. Return the number of valid frequencies
+inline uint8_t PWM_opCachePreload(const float* frequencies, const uint8_t& count, const bool& phaseCorrect = false)
+{
+#if defined(F_CPU)
+  uint32_t freq_CPU = F_CPU;
+#else
+  uint32_t freq_CPU = 125000000;
+#endif
+
+  uint8_t loaded = 0;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint32_t  top;
+    uint32_t  div;
+    float     actualFreq;
+
+    if (PWM_opCacheLookup(frequencies[i], phaseCorrect))
+    {
+      loaded++;
+    }
+    else if ( (frequencies[i] <= ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000)) &&
+              PWM_calc_TOP_and_DIV(freq_CPU, frequencies[i], phaseCorrect, top, div, actualFreq) &&
+              PWM_opCacheInsert(frequencies[i], phaseCorrect, top, div, actualFreq) )
+    {
+      loaded++;
+    }
+  }
+
+  return loaded;
+}
+
+////////////////////////////////////////
+
+inline void PWM_opCacheClear()
+{
+#if (PWM_OP_CACHE_SIZE > 0)
+  memset(PWM_op_cache_data, 0, sizeof(PWM_op_cache_data));
+#endif
+
+  PWM_op_cache_stats_data.clock = 0;
+}
+
+////////////////////////////////////////
+
+inline const PWM_OpCache_Stats& PWM_opCacheStats()
+{
+  return PWM_op_cache_stats_data;
+}
+
+inline void PWM_opCacheResetStats()
+{
+  PWM_op_cache_stats_data.hits      = 0;
+  PWM_op_cache_stats_data.misses    = 0;
+  PWM_op_cache_stats_data.evictions = 0;
+}
+
+////////////////////////////////////////
+
+// Ownership of the slice channels, to detect two users of the same channel, or of the TOP / DIV / phaseCorrect
+// shared by both channels of a slice. The owner is any pointer identifying the user, usually the object itself.
+// See RP2040_PWM_Resource.h for the compile-time checks and the automatic placement
+
+// Set to true to refuse a conflicting configuration. Default is to warn and go on
+#if !defined(PWM_RESOURCE_STRICT)
+  #define PWM_RESOURCE_STRICT       false
+#endif
+
+#if !defined(NUM_PWM_PINS)
+  #define NUM_PWM_PINS              30
+#endif
+
+typedef enum
+{
+  PWM_RESOURCE_OK             = 0,
+  // Not a GPIO, or not a slice
+  PWM_RESOURCE_BAD_PIN        = 1,
+  // Channel, or whole slice, owned by another user
+  PWM_RESOURCE_BUSY           = 2,
+  // Other channel of the slice owned or reserved with another TOP / DIV / phaseCorrect
+  PWM_RESOURCE_SLICE_CONFLICT = 3
+} PWM_Resource_Status;
+
+typedef struct
+{
+  // Per channel, NULL if free
+  const void* owner[2];
+  uint32_t    top;
+  uint32_t    div;
+  bool        phaseCorrect;
+  // Channels reserved by PWM_resourcePlace(), bit 0 for A, bit 1 for B, for any user with the same TOP / DIV
+  uint8_t     reserved;
+  // Whole slice owned by owner[0], e.g. a trigger slice or a slice whose TOP changes at every period
+  bool        exclusive;
+} PWM_slice_resource;
+
+// One table for the whole program, also with several .cpp including this header : the static of an inline function
+// has a single instance, unlike PWM_slice_data[] and the other static tables, which are per translation unit
+inline PWM_slice_resource* PWM_resourceData()
+{
+  static PWM_slice_resource data[NUM_PWM_SLICES];
+
+  return data;
+}
+
+////////////////////////////////////////
+
+// Claim the channel of pin, with the TOP / DIV / phaseCorrect it needs. Claiming again by the same owner
+// updates the configuration, which conflicts only if the other channel is used by someone else
+inline PWM_Resource_Status PWM_resourceClaim(const uint8_t& pin, const void* owner, const uint32_t& top,
+                                             const uint32_t& div, const bool& phaseCorrect)
+{
+  if ( (pin >= NUM_PWM_PINS) || (owner == NULL) )
+    return PWM_RESOURCE_BAD_PIN;
+
+  PWM_slice_resource* resource = &PWM_resourceData()[pwm_gpio_to_slice_num(pin)];
+  uint chan = pwm_gpio_to_channel(pin);
+
+  if ( (resource->exclusive && (resource->owner[0] != owner)) ||
+       (resource->owner[chan] && (resource->owner[chan] != owner)) )
+  {
+    return PWM_RESOURCE_BUSY;
+  }
+
+  bool shared     = (resource->owner[chan ^ 1] && (resource->owner[chan ^ 1] != owner)) || resource->reserved;
+  bool sameConfig = (resource->top == top) && (resource->div == div) && (resource->phaseCorrect == phaseCorrect);
+
+  if (shared && !sameConfig && !resource->exclusive)
+    return PWM_RESOURCE_SLICE_CONFLICT;
+
+  resource->owner[chan]     = owner;
+  resource->reserved       &= ~(1 << chan);
+
+  if (!resource->exclusive)
+  {
+    resource->top           = top;
+    resource->div           = div;
+    resource->phaseCorrect  = phaseCorrect;
+  }
+
+  return PWM_RESOURCE_OK;
+}
+
+////////////////////////////////////////
+
+// Claim both channels of the slice, whatever its configuration
+inline PWM_Resource_Status PWM_resourceClaimSlice(const uint& slice_num, const void* owner)
+{
+  if ( (slice_num >= NUM_PWM_SLICES) || (owner == NULL) )
+    return PWM_RESOURCE_BAD_PIN;
+
+  PWM_slice_resource* resource = &PWM_resourceData()[slice_num];
+
+  for (uint chan = 0; chan < 2; chan++)
+  {
+    if ( (resource->owner[chan] && (resource->owner[chan] != owner)) || (resource->reserved & (1 << chan)) )
+      return PWM_RESOURCE_BUSY;
+  }
+
+  resource->owner[0]  = owner;
+  resource->owner[1]  = owner;
+  resource->exclusive = true;
+
+  return PWM_RESOURCE_OK;
+}
+
+////////////////////////////////////////
+
+inline void PWM_resourceRelease(const uint8_t& pin, const void* owner)
+{
+  if (pin >= NUM_PWM_PINS)
+    return;
+
+  PWM_slice_resource* resource = &PWM_resourceData()[pwm_gpio_to_slice_num(pin)];
+
+  if (resource->exclusive)
+  {
+    if (resource->owner[0] == owner)
+    {
+      resource->owner[0]  = NULL;
+      resource->owner[1]  = NULL;
+      resource->exclusive = false;
+    }
+  }
+  else if (resource->owner[pwm_gpio_to_channel(pin)] == owner)
+  {
+    resource->owner[pwm_gpio_to_channel(pin)] = NULL;
+  }
+}
+
+////////////////////////////////////////
+
+// Release all the channels and slices of owner, e.g. before deleting it
+inline void PWM_resourceReleaseAll(const void* owner)
+{
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    PWM_slice_resource* resource = &PWM_resourceData()[slice_num];
+
+    for (uint chan = 0; chan < 2; chan++)
+    {
+      if (resource->owner[chan] == owner)
+        resource->owner[chan] = NULL;
+    }
+
+    if (resource->owner[0] == NULL)
+      resource->exclusive = false;
+  }
+}
+
+////////////////////////////////////////
+
+// NULL if free
+inline const void* PWM_resourceOwner(const uint8_t& pin)
+{
+  if (pin >= NUM_PWM_PINS)
+    return NULL;
+
+  return PWM_resourceData()[pwm_gpio_to_slice_num(pin)].owner[pwm_gpio_to_channel(pin)];
+}
+
+////////////////////////////////////////
+
+// Report a refused claim. Return true to go on anyway, always unless PWM_RESOURCE_STRICT
+inline bool PWM_resourceCheck(const PWM_Resource_Status& status, const uint8_t& pin)
+{
+  if (status == PWM_RESOURCE_OK)
+    return true;
+
+  if (PWM_RESOURCE_STRICT)
+  {
+    PWM_LOGERROR3("Error, PWM resource conflict, pin/slice =", pin, ", status =", status);
+
+    return false;
+  }
+
+  PWM_LOGWARN3("Warning, PWM resource conflict, pin/slice =", pin, ", status =", status);
+
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////
 
 class RP2040_PWM
@@ -167,6 +818,7 @@ class RP2040_PWM
     _dutycycle    = dutycycle * 1000;
     
     _phaseCorrect = phaseCorrect;
+    _levelScale   = 0;
      
     if (!calc_TOP_and_DIV(frequency))
     {
@@ -178,11 +830,17 @@ class RP2040_PWM
     }
              
     _enabled      = false;
+    _pushPull     = false;
+    _level        = 0;
   }
   
   ///////////////////////////////////////////
   
-  ~RP2040_PWM();
+  // The instance can be deleted and its channels claimed by another one
+  ~RP2040_PWM()
+  {
+    PWM_resourceReleaseAll(this);
+  }
   
   ///////////////////////////////////////////
   
@@ -216,41 +874,22 @@ class RP2040_PWM
       return false;
     }
     
-    pwm_set_gpio_level(_pin, level);
+    PWM_shadow_set_level(_slice_num, pwm_gpio_to_channel(_pin), level);
+    
+    _level = level;
            
     // From v1.1.0
     ////////////////////////////////
     
-    if ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_A)
-    {
-      PWM_slice_manual_data[_slice_num].channelA_div    = level;
-      PWM_slice_manual_data[_slice_num].channelA_Active = true;
-      
-      // If B is active, set the data now
-      if (PWM_slice_manual_data[_slice_num].channelB_Active)
-      {
-        pwm_set_chan_level(_slice_num, PWM_CHAN_B, PWM_slice_manual_data[_slice_num].channelB_div);
-      }
-    }
-    else if ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_B)
-    {
-      PWM_slice_manual_data[_slice_num].channelB_div     = level;
-      PWM_slice_manual_data[_slice_num].channelB_Active  = true;
-      
-      // If A is active, set the data now
-      if (PWM_slice_manual_data[_slice_num].channelA_Active)
-      {
-        pwm_set_chan_level(_slice_num, PWM_CHAN_A, PWM_slice_manual_data[_slice_num].channelA_div);
-      }
-    }
-    else
-    {
-      PWM_LOGERROR1("Error, not correct PWM pin = ", _pin);
-      
+    if (!updateManualSliceData(level))
       return false;
-    }
     
-    pwm_set_enabled(_slice_num, true);
+    // Only the changed registers are written, CC as one word for both channels
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, true);
+    PWM_SHADOW_COUNT_WRITTEN(PWM_shadow_flush(_slice_num));
+    
+    // v1.7.0 : pwm_set_gpio_level(), pwm_set_chan_level() of the active other channel, pwm_set_enabled()
+    PWM_SHADOW_COUNT_LEGACY(manualSiblingActive() ? 3 : 2);
       
     PWM_LOGINFO3("pin = ", _pin, ", PWM_CHAN =", pwm_gpio_to_channel(_pin));
     
@@ -278,11 +917,31 @@ class RP2040_PWM
       prev_level =  level;
       _dutycycle = ( (uint32_t) level * 100000 / _PWM_config.top);
     }
+    
+    _level = level;
        
     // Better @ 1597ns, reducing nearly 1.3us out of setPWM_manual() => 2889ns
-    hw_write_masked( &pwm_hw->slice[pwm_gpio_to_slice_num(pin)].cc,
-                     ((uint)level) << (pwm_gpio_to_channel(pin) ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB),
-                     pwm_gpio_to_channel(pin) ? PWM_CH0_CC_B_BITS : PWM_CH0_CC_A_BITS);
+    // Only the half of CC of this channel is written. The other half is kept as in the hardware,
+    // as the other channel may be driven by another instance
+    uint slice_num = pwm_gpio_to_slice_num(pin);
+    uint chan      = pwm_gpio_to_channel(pin);
+    
+    hw_write_masked( &pwm_hw->slice[slice_num].cc,
+                     ((uint)level) << (chan ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB),
+                     chan ? PWM_CH0_CC_B_BITS : PWM_CH0_CC_A_BITS);
+    
+    // Same half in the shadow, if already loaded, else it is read later from the hardware
+    if (PWM_slice_shadow_data[slice_num].loaded)
+    {
+      uint32_t& cc = PWM_slice_shadow_data[slice_num].cc;
+      
+      cc = chan ? ( (cc & ~PWM_CH0_CC_B_BITS) | ( ((uint32_t) level) << PWM_CH0_CC_B_LSB ) ) :
+                  ( (cc & ~PWM_CH0_CC_A_BITS) | ( ((uint32_t) level) << PWM_CH0_CC_A_LSB ) );
+    }
+    
+    // Same single write as v1.7.0
+    PWM_SHADOW_COUNT_LEGACY(1);
+    PWM_SHADOW_COUNT_WRITTEN(1);
         
     PWM_LOGINFO3("pin = ", _pin, ", PWM_CHAN =", pwm_gpio_to_channel(_pin));
     
@@ -317,6 +976,9 @@ class RP2040_PWM
     
     _PWM_config.top = top;
     _PWM_config.div = div;
+    
+    // TOP not from an operating point
+    _levelScale     = 0;
 
     // Limit level <= top
     if (level > top)
@@ -324,21 +986,28 @@ class RP2040_PWM
       
     _dutycycle  = ( (uint32_t) level * 100000 / top);
     
+    if (!claimResource(_pin))
+      return false;
+    
     gpio_set_function(_pin, GPIO_FUNC_PWM);
     
     _slice_num = pwm_gpio_to_slice_num(_pin);
     
-    pwm_config config = pwm_get_default_config();
-           
-    // Set phaseCorrect
-    pwm_set_phase_correct(_slice_num, phaseCorrect);
-       
-    pwm_config_set_clkdiv_int(&config, _PWM_config.div);
-    pwm_config_set_wrap(&config, _PWM_config.top);
+    // Restart the slice only if DIV or TOP really changes, as pwm_init() did
+    bool restart = !PWM_slice_manual_data[_slice_num].initialized;
+    
+    PWM_shadow_set_div(_slice_num, ((uint32_t) _PWM_config.div) << PWM_CH0_DIV_INT_LSB);
+    PWM_shadow_set_top(_slice_num, _PWM_config.top);
+    
+    if (PWM_slice_shadow_data[_slice_num].dirty & (PWM_SHADOW_DIV | PWM_SHADOW_TOP))
+      restart = true;
+    
+    // Same CSR as pwm_init() with default config, plus phaseCorrect and auto start running once configured
+    PWM_shadow_set_csr(_slice_num, (phaseCorrect ? PWM_CH0_CSR_PH_CORRECT_BITS : 0) | PWM_CH0_CSR_EN_BITS);
+    PWM_shadow_set_level(_slice_num, pwm_gpio_to_channel(_pin), level);
     
-    // auto start running once configured
-    pwm_init(_slice_num, &config, true);
-    pwm_set_gpio_level(_pin, level);
+    _level    = level;
+    _pushPull = false;
     
     // Store and flag so that simpler setPWM_manual() can be called without top and div
     PWM_slice_manual_data[_slice_num].initialized = true;
@@ -347,36 +1016,13 @@ class RP2040_PWM
     ////////////////////////////////
     // Update PWM_slice_manual_data[]
     
-    if ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_A)
-    {
-      PWM_slice_manual_data[_slice_num].channelA_div    = level;
-      PWM_slice_manual_data[_slice_num].channelA_Active = true;
-      
-      // If B is active, set the data now
-      if (PWM_slice_manual_data[_slice_num].channelB_Active)
-      {
-        pwm_set_chan_level(_slice_num, PWM_CHAN_B, PWM_slice_manual_data[_slice_num].channelB_div);
-      }
-    }
-    else if ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_B)
-    {
-      PWM_slice_manual_data[_slice_num].channelB_div     = level;
-      PWM_slice_manual_data[_slice_num].channelB_Active  = true;
-      
-      // If A is active, set the data now
-      if (PWM_slice_manual_data[_slice_num].channelA_Active)
-      {
-        pwm_set_chan_level(_slice_num, PWM_CHAN_A, PWM_slice_manual_data[_slice_num].channelA_div);
-      }
-    }
-    else
-    {
-      PWM_LOGERROR1("Error, not correct PWM pin = ", _pin);
-      
+    if (!updateManualSliceData(level))
       return false;
-    }
     
-    pwm_set_enabled(_slice_num, true);
+    PWM_SHADOW_COUNT_WRITTEN(PWM_shadow_flush(_slice_num, restart));
+    
+    // v1.7.0 : pwm_set_phase_correct(), pwm_init(), pwm_set_gpio_level(), other channel level if active, pwm_set_enabled()
+    PWM_SHADOW_COUNT_LEGACY(manualSiblingActive() ? 10 : 9);
       
     PWM_LOGINFO3("pin = ", _pin, ", PWM_CHAN =", pwm_gpio_to_channel(_pin));
     
@@ -412,16 +1058,21 @@ class RP2040_PWM
       return false;
     }
     
-    if ( (frequency <= ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000)) 
-      && (frequency >= ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000) ) )
+    bool changeFreq = (_frequency != frequency) || !_phaseCorrect;
+    
+    // A cached operating point was range checked when solved
+    PWM_OpPoint* opPoint = changeFreq ? PWM_opCacheFind(frequency, true) : NULL;
+    
+    if ( opPoint || ( (frequency <= ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000)) 
+                   && (frequency >= ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000) ) ) )
     {         
-      if ( (_frequency != frequency) || !_phaseCorrect )
+      if (changeFreq)
       {
         // Must change before calling calc_TOP_and_DIV()
         _phaseCorrect = true;
         
         // To compensate phasecorrect half frequency
-        if (!calc_TOP_and_DIV(frequency))
+        if (!calc_TOP_and_DIV(frequency, opPoint))
         {
           _frequency  = 0;
         }
@@ -453,46 +1104,39 @@ class RP2040_PWM
             
       if ( (!_enabled) || newFreq || newDutyCycle )
       {
+        // Claim both channels, as the same owner
+        if ( !newDutyCycle && ( !claimResource(pinA) || !claimResource(pinB) ) )
+        {
+          _frequency = 0;
+          
+          return false;
+        }
+        
         gpio_set_function(pinA, GPIO_FUNC_PWM);
         gpio_set_function(pinB, GPIO_FUNC_PWM);
-               
-        pwm_config config = pwm_get_default_config();
-                         
-        pwm_config_set_clkdiv_int(&config, _PWM_config.div);
-        pwm_config_set_wrap(&config, _PWM_config.top);
         
-        if ( newDutyCycle )
-        {
-          // KH, to fix glitch when changing dutycycle from v1.4.0
-          // Check https://github.com/khoih-prog/RP2040_PWM/issues/10
-          // From pico-sdk/src/rp2_common/hardware_pwm/include/hardware/pwm.h
-          // Only take effect after the next time the PWM slice wraps
-          // (or, in phase-correct mode, the next time the slice reaches 0). 
-          // If the PWM is not running, the write is latched in immediately
-          //pwm_set_wrap(uint slice_num, uint16_t wrap)
-          pwm_set_wrap(_slice_num, _PWM_config.top);
-        }
-        else
-        {
-          // auto start running once configured
-          pwm_init(_slice_num, &config, true);
-        }
+        // KH, to fix glitch when changing dutycycle from v1.4.0
+        // Check https://github.com/khoih-prog/RP2040_PWM/issues/10
+        // From pico-sdk/src/rp2_common/hardware_pwm/include/hardware/pwm.h
+        // Only take effect after the next time the PWM slice wraps
+        // (or, in phase-correct mode, the next time the slice reaches 0). 
+        // If the PWM is not running, the write is latched in immediately
+        // The shadow writes TOP only if changed, and the counter is restarted only for new frequency
+        PWM_shadow_set_div(_slice_num, ((uint32_t) _PWM_config.div) << PWM_CH0_DIV_INT_LSB);
+        PWM_shadow_set_top(_slice_num, _PWM_config.top);
         
-        uint32_t PWM_level = ( _PWM_config.top * (_dutycycle / 2) ) / 50000;
+        uint32_t PWM_level = dutyToLevel(_dutycycle);
         
-        // To avoid uint32_t overflow and still keep accuracy as _dutycycle max = 100,000 > 65536 of uint16_t
-        pwm_set_gpio_level(pinA, PWM_level);        
-        pwm_set_gpio_level(pinB, PWM_level);
+        _level    = PWM_level;
+        _pushPull = true;
                
         // From v1.1.0
         ////////////////////////////////
         // Update PWM_slice_data[]
         PWM_slice_data[_slice_num].freq = _frequency;
         
-        // Set phaseCorrect
-        pwm_set_phase_correct(_slice_num, true);
-        
-        pwm_set_output_polarity(_slice_num, false, true);
+        // Set phaseCorrect, channel B inverted, and auto start running once configured
+        PWM_shadow_set_csr(_slice_num, PWM_CH0_CSR_PH_CORRECT_BITS | PWM_CH0_CSR_B_INV_BITS | PWM_CH0_CSR_EN_BITS);
    
         if ( ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_A) || ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_B) )
         {
@@ -502,17 +1146,9 @@ class RP2040_PWM
           PWM_slice_data[_slice_num].channelA_Active  = true;
           PWM_slice_data[_slice_num].channelB_Active  = true;
           
-          // If A is active, set the data now
-          if (PWM_slice_data[_slice_num].channelA_Active)
-          {
-            pwm_set_chan_level(_slice_num, PWM_CHAN_A, PWM_slice_data[_slice_num].channelA_div);
-          }
-          
-          // If B is active, set the data now
-          if (PWM_slice_data[_slice_num].channelB_Active)
-          {
-            pwm_set_chan_level(_slice_num, PWM_CHAN_B, PWM_slice_data[_slice_num].channelB_div);
-          }
+          // Both levels go into the same CC word, written once
+          PWM_shadow_set_level(_slice_num, PWM_CHAN_A, PWM_slice_data[_slice_num].channelA_div);
+          PWM_shadow_set_level(_slice_num, PWM_CHAN_B, PWM_slice_data[_slice_num].channelB_div);
         }   
         else
         {
@@ -521,7 +1157,11 @@ class RP2040_PWM
           return false;
         }
         
-        pwm_set_enabled(_slice_num, true);
+        PWM_SHADOW_COUNT_WRITTEN(PWM_shadow_flush(_slice_num, !newDutyCycle));
+        
+        // v1.7.0 : pwm_set_wrap() or pwm_init(), 2 pwm_set_gpio_level(), pwm_set_phase_correct(),
+        // pwm_set_output_polarity(), 2 pwm_set_chan_level(), pwm_set_enabled()
+        PWM_SHADOW_COUNT_LEGACY(newDutyCycle ? 8 : 13);
           
         PWM_LOGINFO5("pinA = ", pinA, ", pinB = ", pinB, ", PWM_CHAN =", pwm_gpio_to_channel(_pin));
         
@@ -549,14 +1189,17 @@ class RP2040_PWM
     
     _phaseCorrect = phaseCorrect;
     
-    if ( (frequency <= ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000)) 
-      && (frequency >= ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000) ) )
+    // A cached operating point was range checked when solved
+    PWM_OpPoint* opPoint = (_frequency != frequency) ? PWM_opCacheFind(frequency, phaseCorrect) : NULL;
+    
+    if ( opPoint || ( (frequency <= ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000)) 
+                   && (frequency >= ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000) ) ) )
     {   
       _pin = pin;
       
       if (_frequency != frequency)
       {
-        if (!calc_TOP_and_DIV(frequency))
+        if (!calc_TOP_and_DIV(frequency, opPoint))
         {
           _frequency  = 0;
         }
@@ -588,39 +1231,38 @@ class RP2040_PWM
       
       if ( (!_enabled) || newFreq || newDutyCycle )
       {
+        // Claim the channel, and the TOP / DIV shared with the other channel of the slice
+        if ( !newDutyCycle && !claimResource(_pin) )
+        {
+          _frequency = 0;
+          
+          return false;
+        }
+        
         gpio_set_function(_pin, GPIO_FUNC_PWM);
         
         _slice_num = pwm_gpio_to_slice_num(_pin);
         
-        pwm_config config = pwm_get_default_config();
-               
-        // Set phaseCorrect
-        pwm_set_phase_correct(_slice_num, phaseCorrect);
-           
-        pwm_config_set_clkdiv_int(&config, _PWM_config.div);
-        pwm_config_set_wrap(&config, _PWM_config.top);
+        // KH, to fix glitch when changing dutycycle from v1.4.0
+        // Check https://github.com/khoih-prog/RP2040_PWM/issues/10
+        // From pico-sdk/src/rp2_common/hardware_pwm/include/hardware/pwm.h
+        // Only take effect after the next time the PWM slice wraps
+        // (or, in phase-correct mode, the next time the slice reaches 0). 
+        // If the PWM is not running, the write is latched in immediately
+        // The shadow writes TOP only if changed, and the counter is restarted only for new frequency
+        PWM_shadow_set_div(_slice_num, ((uint32_t) _PWM_config.div) << PWM_CH0_DIV_INT_LSB);
+        PWM_shadow_set_top(_slice_num, _PWM_config.top);
         
-        if ( newDutyCycle )
-        {
-          // KH, to fix glitch when changing dutycycle from v1.4.0
-          // Check https://github.com/khoih-prog/RP2040_PWM/issues/10
-          // From pico-sdk/src/rp2_common/hardware_pwm/include/hardware/pwm.h
-          // Only take effect after the next time the PWM slice wraps
-          // (or, in phase-correct mode, the next time the slice reaches 0). 
-          // If the PWM is not running, the write is latched in immediately
-          //pwm_set_wrap(uint slice_num, uint16_t wrap)
-          pwm_set_wrap(_slice_num, _PWM_config.top);
-        }
-        else
-        {
-          // auto start running once configured
-          pwm_init(_slice_num, &config, true);
-        }
+        // Set phaseCorrect and auto start running once configured.
+        // Output polarity is kept only when changing dutycycle, as pwm_init() cleared it before
+        uint32_t csr = newDutyCycle ? PWM_slice_shadow_data[_slice_num].csr & (PWM_CH0_CSR_A_INV_BITS | PWM_CH0_CSR_B_INV_BITS) : 0;
+        
+        PWM_shadow_set_csr(_slice_num, csr | (phaseCorrect ? PWM_CH0_CSR_PH_CORRECT_BITS : 0) | PWM_CH0_CSR_EN_BITS);
         
-        uint32_t PWM_level = ( _PWM_config.top * (_dutycycle / 2) ) / 50000;
+        uint32_t PWM_level = dutyToLevel(_dutycycle);
         
-        // To avoid uint32_t overflow and still keep accuracy as _dutycycle max = 100,000 > 65536 of uint16_t
-        pwm_set_gpio_level(_pin, PWM_level );
+        _level    = PWM_level;
+        _pushPull = false;
                
         // From v1.1.0
         ////////////////////////////////
@@ -632,10 +1274,14 @@ class RP2040_PWM
           PWM_slice_data[_slice_num].channelA_div     = PWM_level;
           PWM_slice_data[_slice_num].channelA_Active  = true;
           
-          // If B is active, set the data now
-          if (PWM_slice_data[_slice_num].channelB_Active)
+          PWM_shadow_set_level(_slice_num, PWM_CHAN_A, PWM_level);
+          
+          // New frequency : B level kept only if active, as cleared by pwm_init() in v1.7.0.
+          // Dutycycle only : B half of the shadow CC kept as is, whoever drives it
+          if (!newDutyCycle)
           {
-            pwm_set_chan_level(_slice_num, PWM_CHAN_B, PWM_slice_data[_slice_num].channelB_div);
+            PWM_shadow_set_level(_slice_num, PWM_CHAN_B, PWM_slice_data[_slice_num].channelB_Active ? 
+                                 PWM_slice_data[_slice_num].channelB_div : 0);
           }
         }
         else if ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_B)
@@ -643,10 +1289,14 @@ class RP2040_PWM
           PWM_slice_data[_slice_num].channelB_div     = PWM_level;
           PWM_slice_data[_slice_num].channelB_Active  = true;
           
-          // If A is active, set the data now
-          if (PWM_slice_data[_slice_num].channelA_Active)
+          PWM_shadow_set_level(_slice_num, PWM_CHAN_B, PWM_level);
+          
+          // New frequency : A level kept only if active, as cleared by pwm_init() in v1.7.0.
+          // Dutycycle only : A half of the shadow CC kept as is, whoever drives it
+          if (!newDutyCycle)
           {
-            pwm_set_chan_level(_slice_num, PWM_CHAN_A, PWM_slice_data[_slice_num].channelA_div);
+            PWM_shadow_set_level(_slice_num, PWM_CHAN_A, PWM_slice_data[_slice_num].channelA_Active ? 
+                                 PWM_slice_data[_slice_num].channelA_div : 0);
           }
         }
         else
@@ -656,7 +1306,12 @@ class RP2040_PWM
           return false;
         }
         
-        pwm_set_enabled(_slice_num, true);
+        PWM_SHADOW_COUNT_WRITTEN(PWM_shadow_flush(_slice_num, !newDutyCycle));
+        
+        // v1.7.0 : pwm_set_phase_correct(), pwm_set_wrap() or pwm_init(), pwm_set_gpio_level(),
+        // other channel level if active, pwm_set_enabled()
+        PWM_SHADOW_COUNT_LEGACY( (newDutyCycle ? 4 : 9) + ( (pwm_gpio_to_channel(_pin) == PWM_CHAN_A) ? 
+                                 PWM_slice_data[_slice_num].channelB_Active : PWM_slice_data[_slice_num].channelA_Active ) );
           
         PWM_LOGINFO3("pin = ", _pin, ", PWM_CHAN =", pwm_gpio_to_channel(_pin));
         
@@ -705,7 +1360,9 @@ class RP2040_PWM
   
   void enablePWM()
   {
-    pwm_set_enabled(_slice_num, true);
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, true);
+    PWM_SHADOW_COUNT_WRITTEN(PWM_shadow_flush(_slice_num));
+    PWM_SHADOW_COUNT_LEGACY(1);
     _enabled = true;
   }
   
@@ -713,7 +1370,9 @@ class RP2040_PWM
   
   void disablePWM()
   {
-    pwm_set_enabled(_slice_num, false);
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, false);
+    PWM_SHADOW_COUNT_WRITTEN(PWM_shadow_flush(_slice_num));
+    PWM_SHADOW_COUNT_LEGACY(1);
     _enabled = false;
   }
   
@@ -760,6 +1419,46 @@ class RP2040_PWM
     return _pin;
   }
   
+  ///////////////////////////////////////////
+  
+  // Register bits intended by this instance for its channel(s), as mask and values. False if not enabled
+  // CSR polarity bits are owned only in PushPull mode, CC only the half of the channel, both in PushPull mode
+  bool getIntendedRegs(PWM_slice_regs& mask, PWM_slice_regs& value)
+  {
+    if (!_enabled)
+      return false;
+    
+    mask.csr  = PWM_CH0_CSR_EN_BITS | PWM_CH0_CSR_PH_CORRECT_BITS;
+    value.csr = PWM_CH0_CSR_EN_BITS | (_phaseCorrect ? PWM_CH0_CSR_PH_CORRECT_BITS : 0);
+    
+    mask.div  = PWM_CH0_DIV_INT_BITS | PWM_CH0_DIV_FRAC_BITS;
+    value.div = ((uint32_t) _PWM_config.div) << PWM_CH0_DIV_INT_LSB;
+    
+    mask.top  = PWM_CH0_TOP_BITS;
+    value.top = _PWM_config.top;
+    
+    if (_pushPull)
+    {
+      mask.csr  |= PWM_CH0_CSR_A_INV_BITS | PWM_CH0_CSR_B_INV_BITS;
+      value.csr |= PWM_CH0_CSR_B_INV_BITS;
+      
+      mask.cc   = PWM_CH0_CC_A_BITS | PWM_CH0_CC_B_BITS;
+      value.cc  = ( ((uint32_t) _level) << PWM_CH0_CC_A_LSB ) | ( ((uint32_t) (_PWM_config.top - _level)) << PWM_CH0_CC_B_LSB );
+    }
+    else if (pwm_gpio_to_channel(_pin) == PWM_CHAN_A)
+    {
+      mask.cc   = PWM_CH0_CC_A_BITS;
+      value.cc  = ((uint32_t) _level) << PWM_CH0_CC_A_LSB;
+    }
+    else
+    {
+      mask.cc   = PWM_CH0_CC_B_BITS;
+      value.cc  = ((uint32_t) _level) << PWM_CH0_CC_B_LSB;
+    }
+    
+    return true;
+  }
+  
   ///////////////////////////////////////////////////////////////////
   
   private:
@@ -770,6 +1469,9 @@ class RP2040_PWM
   float       _actualFrequency;
   float       _frequency;
   
+  // Duty to level scale factor of the current operating point, 0 if not known
+  uint64_t    _levelScale;
+  
   // dutycycle from 0-100,000 for 0%-100% to make use of 16-bit top register
   // dutycycle = real_dutycycle * 1000 for better accuracy
   uint32_t    _dutycycle;
@@ -779,56 +1481,116 @@ class RP2040_PWM
   uint8_t     _slice_num;  
   bool        _phaseCorrect;
   bool        _enabled;
+  bool        _pushPull;
+  
+  // Level of the channel last written, channel A in PushPull mode
+  uint16_t    _level;
   
   ///////////////////////////////////////////
   
-  // https://datasheets.raspberrypi.org/rp2040/rp2040-datasheet.pdf, page 549
-  // https://raspberrypi.github.io/pico-sdk-doxygen/group__hardware__pwm.html
+  // Other channel of the slice also set by setPWM_manual()
+  inline bool manualSiblingActive()
+  {
+    return (pwm_gpio_to_channel(_pin) == PWM_CHAN_A) ? PWM_slice_manual_data[_slice_num].channelB_Active :
+                                                        PWM_slice_manual_data[_slice_num].channelA_Active;
+  }
   
   ///////////////////////////////////////////
   
-  bool calc_TOP_and_DIV(const float& freq)
-  {           
-    if (freq > 2000.0)
-    {
-      _PWM_config.div = 1;
-    }
-    else if (freq >= 200.0) 
-    {
-      _PWM_config.div = 10;
-    }
-    else if (freq >= 20.0) 
-    {
-      _PWM_config.div = 100;
-    }
-    else if (freq >= 10.0) 
+  // Update PWM_slice_manual_data[] and keep the active sibling level in the same shadow CC word
+  bool updateManualSliceData(const uint16_t& level)
+  {
+    if ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_A)
     {
-      _PWM_config.div = 200;
+      PWM_slice_manual_data[_slice_num].channelA_div    = level;
+      PWM_slice_manual_data[_slice_num].channelA_Active = true;
+      
+      // If B is active, set the data now
+      if (PWM_slice_manual_data[_slice_num].channelB_Active)
+      {
+        PWM_shadow_set_level(_slice_num, PWM_CHAN_B, PWM_slice_manual_data[_slice_num].channelB_div);
+      }
     }
-    else if (freq >= ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000))
+    else if ( (pwm_gpio_to_channel(_pin)) == PWM_CHAN_B)
     {
-      _PWM_config.div = 255;
+      PWM_slice_manual_data[_slice_num].channelB_div     = level;
+      PWM_slice_manual_data[_slice_num].channelB_Active  = true;
+      
+      // If A is active, set the data now
+      if (PWM_slice_manual_data[_slice_num].channelA_Active)
+      {
+        PWM_shadow_set_level(_slice_num, PWM_CHAN_A, PWM_slice_manual_data[_slice_num].channelA_div);
+      }
     }
     else
     {
-      PWM_LOGERROR1("Error, freq must be >=", ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000));
+      PWM_LOGERROR1("Error, not correct PWM pin = ", _pin);
       
       return false;
     }
     
-    // Formula => PWM_Freq = ( F_CPU ) / [ ( TOP + 1 ) * ( DIV + DIV_FRAC/16) ]
-    _PWM_config.top = ( freq_CPU / freq / _PWM_config.div ) - 1;
-       
-    _actualFrequency = ( freq_CPU  ) / ( (_PWM_config.top + 1) * _PWM_config.div );
+    return true;
+  }
+  
+  ///////////////////////////////////////////
+  
+  // https://datasheets.raspberrypi.org/rp2040/rp2040-datasheet.pdf, page 549
+  // https://raspberrypi.github.io/pico-sdk-doxygen/group__hardware__pwm.html
+  
+  ///////////////////////////////////////////
+  
+  // opPoint = cached operating point of freq if already found, else solved and cached
+  bool calc_TOP_and_DIV(const float& freq, const PWM_OpPoint* opPoint = NULL)
+  {
+    if (opPoint)
+    {
+      _PWM_config.top   = opPoint->top;
+      _PWM_config.div   = opPoint->div;
+      _actualFrequency  = opPoint->actualFreq;
+      _levelScale       = opPoint->levelScale;
+      
+      return true;
+    }
+    
+    uint32_t top;
+    uint32_t div;
+    
+    if (!PWM_calc_TOP_and_DIV(freq_CPU, freq, _phaseCorrect, top, div, _actualFrequency))
+      return false;
+      
+    _PWM_config.top = top;
+    _PWM_config.div = div;
     
-    // Compensate half freq if _phaseCorrect
-    if (_phaseCorrect)
-      _PWM_config.top /= 2;
+    // Only points valid for setPWM_Int(), as a hit skips its range checks. Not checked from the constructor
+    if (freq <= ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000))
+      opPoint       = PWM_opCacheInsert(freq, _phaseCorrect, top, div, _actualFrequency);
+      
+    _levelScale     = opPoint ? opPoint->levelScale : 0;
     
     PWM_LOGINFO3("_PWM_config.top =", _PWM_config.top, ", _actualFrequency =", _actualFrequency);
     
     return true; 
   }
+  
+  ///////////////////////////////////////////
+  
+  // dutycycle from 0-100,000. Multiply by the scale factor of the operating point if known, else divide
+  inline uint32_t dutyToLevel(const uint32_t& dutycycle)
+  {
+    if (_levelScale)
+      return PWM_opLevel(_levelScale, dutycycle);
+      
+    // To avoid uint32_t overflow and still keep accuracy as _dutycycle max = 100,000 > 65536 of uint16_t
+    return ( _PWM_config.top * (dutycycle / 2) ) / 50000;
+  }
+  
+  ///////////////////////////////////////////
+  
+  // Claim the channel of pin with the current TOP / DIV / phaseCorrect. False only if refused in strict mode
+  bool claimResource(const uint8_t& pin)
+  {
+    return PWM_resourceCheck(PWM_resourceClaim(pin, this, _PWM_config.top, _PWM_config.div, _phaseCorrect), pin);
+  }
 };
 
 ///////////////////////////////////////////
@@ -0,0 +1,488 @@
+/****************************************************************************************************************************
+  RP2040_PWM_3Phase.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// 3-phase sinusoidal (SPWM) / space-vector (SVPWM) modulation for BLDC / PMSM inverters.
+// Each phase is one push-pull slice : channel A high-side, channel B inverted low-side, with optional dead time.
+// The 3 slices run phase-correct, started together by one pwm_hw->en write, so that their CC are latched
+// at the same time. Duties are computed with a Q15 sin table and integer math only, no soft-float.
+// Updates are done from the wrap IRQ of the first slice, every updateDivider wraps.
+
+#pragma once
+
+#ifndef RP2040_PWM_3PHASE_H
+#define RP2040_PWM_3PHASE_H
+
+#include "RP2040_PWM.h"
+#include "PWM_Wrap_IRQ.h"
+
+///////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+  // Sinusoidal PWM, modulation index up to 1.0
+  PWM_3PHASE_SPWM       = 0,
+  // Sinusoidal PWM + 1/6 third harmonic, modulation index up to 1.155
+  PWM_3PHASE_SPWM_THI   = 1,
+  // Space vector PWM by min-max zero sequence injection, modulation index up to 1.155
+  PWM_3PHASE_SVPWM      = 2
+} PWM_3Phase_Mode;
+
+// Electrical angle : 0-65535 for 0-360 degrees
+#define PWM_3PHASE_ANGLE_120      21845
+#define PWM_3PHASE_ANGLE_240      43691
+
+// Modulation index in Q15 : 32768 = 1.0. Max 2 / sqrt(3) = 1.1547
+#define PWM_3PHASE_MI_ONE         32768
+#define PWM_3PHASE_MI_MAX         37837
+
+///////////////////////////////////////////////////////////////////
+
+// sin(2 * PI * i / 256) in Q15
+static const int16_t PWM_3Phase_sin_table[256] =
+{
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+    6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+   12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+   18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+   23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+   27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+   32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+   32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+   32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+   30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+   27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+   18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+   12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+    6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+       0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+   -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+  -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+  -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+  -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+  -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+  -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+  -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+  -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+  -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+  -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+  -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+   -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804
+};
+
+////////////////////////////////////////
+
+// Q15 sin of 16-bit angle, linear interpolation between table entries
+inline int32_t PWM_3Phase_sin(const uint16_t& angle)
+{
+  uint8_t index = angle >> 8;
+  int32_t frac  = angle & 0xFF;
+  int32_t a     = PWM_3Phase_sin_table[index];
+  int32_t b     = PWM_3Phase_sin_table[(uint8_t) (index + 1)];
+
+  return a + ( ( (b - a) * frac ) >> 8 );
+}
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_3Phase
+{
+  public:
+
+  // pinU, pinV, pinW = channel A of 3 different slices. Low-side on channel B of the same slice
+  RP2040_PWM_3Phase(const uint8_t& pinU, const uint8_t& pinV, const uint8_t& pinW)
+  {
+#if defined(F_CPU)
+    freq_CPU = F_CPU;
+#else
+    freq_CPU = 125000000;
+#endif
+
+    _pins[0]    = pinU;
+    _pins[1]    = pinV;
+    _pins[2]    = pinW;
+    _mode       = PWM_3PHASE_SVPWM;
+    _angle      = 0;
+    _modIndex   = 0;
+    _angleStep  = 0;
+    _anglePhase = 0;
+    _updateRate = 0;
+    _running    = false;
+    _configured = false;
+    _updateCount = 0;
+
+    for (uint8_t i = 0; i < 3; i++)
+      _slice_num[i] = pwm_gpio_to_slice_num(_pins[i]);
+  }
+
+  ///////////////////////////////////////////
+
+  ~RP2040_PWM_3Phase()
+  {
+    end();
+  }
+
+  ///////////////////////////////////////////
+
+  // carrierFreq in Hz, phase-correct. deadTime in counter ticks (F_CPU / DIV), added to the low-side CC
+  // updateDivider = number of carrier periods between duty updates
+  bool begin(const uint32_t& carrierFreq, const PWM_3Phase_Mode& mode = PWM_3PHASE_SVPWM,
+             const uint16_t& deadTime = 0, const uint16_t& updateDivider = 1)
+  {
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      if ( (pwm_gpio_to_channel(_pins[i]) != PWM_CHAN_A) ||
+           (_slice_num[i] == _slice_num[(i + 1) % 3]) )
+      {
+        PWM_LOGERROR1("Error, phase pins must be channel A of 3 different slices, pin =", _pins[i]);
+
+        return false;
+      }
+    }
+
+    // Phase-correct : period = 2 * (TOP + 1) ticks
+    uint32_t ticks = (carrierFreq == 0) ? 0 : freq_CPU / carrierFreq / 2;
+
+    if ( (ticks < 16) || (ticks > 255 * 65536) )
+    {
+      PWM_LOGERROR1("Error, invalid carrier frequency =", carrierFreq);
+
+      return false;
+    }
+
+    // Each phase needs its whole slice, channel B being the low side. None kept if one is refused
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      if (!PWM_resourceCheck(PWM_resourceClaimSlice(_slice_num[i], this), _slice_num[i]))
+      {
+        PWM_resourceReleaseAll(this);
+
+        return false;
+      }
+    }
+
+    _div            = (ticks >> 16) + 1;
+    _top            = ticks / _div - 1;
+    _mode           = mode;
+    _deadTime       = deadTime;
+    _updateDivider  = (updateDivider == 0) ? 1 : updateDivider;
+    _wrapCount      = 0;
+    _updateRate     = (float) freq_CPU / (2 * (_top + 1) * _div) / _updateDivider;
+
+    // All slices stopped, configured, counters cleared, at 50% with 0 modulation
+    uint32_t levels[3];
+
+    compute(0, 0, levels);
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      uint slice_num = _slice_num[i];
+
+      PWM_shadow_set_csr(slice_num, PWM_CH0_CSR_PH_CORRECT_BITS | PWM_CH0_CSR_B_INV_BITS);
+      PWM_shadow_set_div(slice_num, _div << PWM_CH0_DIV_INT_LSB);
+      PWM_shadow_set_top(slice_num, _top);
+      PWM_slice_shadow_data[slice_num].cc     = toCC(levels[i]);
+      PWM_slice_shadow_data[slice_num].dirty |= PWM_SHADOW_CC;
+      PWM_shadow_flush(slice_num, true);
+
+      PWM_slice_data[slice_num].channelA_Active = true;
+      PWM_slice_data[slice_num].channelB_Active = true;
+
+      gpio_set_function(_pins[i], GPIO_FUNC_PWM);
+      gpio_set_function(_pins[i] + 1, GPIO_FUNC_PWM);
+    }
+
+    _configured = true;
+
+    PWM_LOGINFO5("3Phase: TOP =", _top, ", DIV =", _div, ", update rate =", _updateRate);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Start the 3 slices in phase
+  void start()
+  {
+    uint32_t mask = (1u << _slice_num[0]) | (1u << _slice_num[1]) | (1u << _slice_num[2]);
+
+    PWM_attachWrapInterrupt(_slice_num[0], RP2040_PWM_3Phase::wrapHandler, this);
+
+    pwm_hw->en |= mask;
+
+    for (uint8_t i = 0; i < 3; i++)
+      PWM_slice_shadow_data[_slice_num[i]].csr |= PWM_CH0_CSR_EN_BITS;
+
+    _running = true;
+  }
+
+  ///////////////////////////////////////////
+
+  void stop()
+  {
+    uint32_t mask = (1u << _slice_num[0]) | (1u << _slice_num[1]) | (1u << _slice_num[2]);
+
+    PWM_detachWrapInterrupt(_slice_num[0]);
+
+    pwm_hw->en &= ~mask;
+
+    for (uint8_t i = 0; i < 3; i++)
+      PWM_slice_shadow_data[_slice_num[i]].csr &= ~PWM_CH0_CSR_EN_BITS;
+
+    _running = false;
+  }
+
+  ///////////////////////////////////////////
+
+  // Stop, and release the 3 slices claimed by begin()
+  void end()
+  {
+    if (_running)
+      stop();
+
+    if (_configured)
+    {
+      for (uint8_t i = 0; i < 3; i++)
+      {
+        PWM_slice_data[_slice_num[i]].channelA_Active = false;
+        PWM_slice_data[_slice_num[i]].channelB_Active = false;
+      }
+
+      _configured = false;
+    }
+
+    PWM_resourceReleaseAll(this);
+  }
+
+  ///////////////////////////////////////////
+
+  // Voltage vector for the next update. modIndex in Q15, PWM_3PHASE_MI_ONE = 1.0
+  // With a rotation, the angle is advanced from this one
+  inline void setVector(const uint16_t& angle, const uint16_t& modIndex)
+  {
+    _angle      = angle;
+    _anglePhase = (uint32_t) angle << 16;
+    _modIndex   = (modIndex > PWM_3PHASE_MI_MAX) ? PWM_3PHASE_MI_MAX : modIndex;
+  }
+
+  ///////////////////////////////////////////
+
+  // Open-loop rotation : angle advanced at every update for an electrical frequency in Hz, 0 to stop
+  void setRotation(const float& electricalFreq)
+  {
+    if (_updateRate <= 0)
+      return;
+
+    // 16.16 angle step per update
+    _angleStep = (int32_t) (electricalFreq * 65536.0f * 65536.0f / _updateRate);
+  }
+
+  ///////////////////////////////////////////
+
+  inline void setMode(const PWM_3Phase_Mode& mode)
+  {
+    _mode = mode;
+  }
+
+  ///////////////////////////////////////////
+
+  // Levels of the high-side channel for angle / modIndex. Integer only, to be also used for benchmark
+  void compute(const uint16_t& angle, const uint16_t& modIndex, uint32_t* levels)
+  {
+    int32_t v[3];
+
+    v[0] = PWM_3Phase_sin(angle);
+    v[1] = PWM_3Phase_sin(angle - PWM_3PHASE_ANGLE_120);
+    v[2] = PWM_3Phase_sin(angle - PWM_3PHASE_ANGLE_240);
+
+    int32_t offset = 0;
+
+    if (_mode == PWM_3PHASE_SPWM_THI)
+    {
+      // 1/6 of third harmonic, common to the 3 phases
+      offset = PWM_3Phase_sin( (uint16_t) (3 * angle) ) / 6;
+    }
+    else if (_mode == PWM_3PHASE_SVPWM)
+    {
+      int32_t vmax = v[0], vmin = v[0];
+
+      for (uint8_t i = 1; i < 3; i++)
+      {
+        if (v[i] > vmax)
+          vmax = v[i];
+
+        if (v[i] < vmin)
+          vmin = v[i];
+      }
+
+      offset = -(vmax + vmin) / 2;
+    }
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      // Q15 phase voltage, scaled by modIndex, then 0..TOP centered at TOP / 2
+      int32_t voltage = ( (v[i] + offset) * (int32_t) modIndex ) >> 15;
+      int32_t duty    = 32768 + voltage;
+
+      // Duty clamped to 0..65535 first : (TOP + 1) * duty then fits in 32 bits unsigned for any TOP
+      levels[i] = (duty <= 0) ? 0 : ( (duty >= 65536) ? _top + 1 : ( (_top + 1) * (uint32_t) duty ) >> 16 );
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  // At every wrap of the first slice. The new CC are latched by the 3 slices at the next counter 0
+  void handleWrap()
+  {
+    if (++_wrapCount < _updateDivider)
+      return;
+
+    _wrapCount = 0;
+
+    if (_angleStep)
+    {
+      _anglePhase += _angleStep;
+      _angle = _anglePhase >> 16;
+    }
+    else
+    {
+      _anglePhase = (uint32_t) _angle << 16;
+    }
+
+    uint32_t levels[3];
+    uint16_t angle    = _angle;
+    uint16_t modIndex = _modIndex;
+
+    compute(angle, modIndex, levels);
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      uint32_t cc = toCC(levels[i]);
+
+      PWM_slice_shadow_data[_slice_num[i]].cc = cc;
+      pwm_hw->slice[_slice_num[i]].cc         = cc;
+    }
+
+    _updateCount++;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint16_t getAngle()
+  {
+    return _angle;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getUpdateCount()
+  {
+    return _updateCount;
+  }
+
+  ///////////////////////////////////////////
+
+  inline float getUpdateRate()
+  {
+    return _updateRate;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t get_TOP()
+  {
+    return _top;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t get_DIV()
+  {
+    return _div;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  uint32_t          freq_CPU;
+  float             _updateRate;
+
+  uint32_t          _top;
+  uint32_t          _div;
+  uint16_t          _deadTime;
+  uint16_t          _updateDivider;
+  uint16_t          _wrapCount;
+
+  PWM_3Phase_Mode   _mode;
+
+  volatile uint16_t _angle;
+  volatile uint16_t _modIndex;
+  volatile int32_t  _angleStep;
+  volatile uint32_t _anglePhase;
+  volatile uint32_t _updateCount;
+
+  uint8_t           _pins[3];
+  uint8_t           _slice_num[3];
+  bool              _running;
+  // Set by begin(), the 3 slices then marked active in PWM_slice_data
+  bool              _configured;
+
+  ///////////////////////////////////////////
+
+  static void wrapHandler(const uint& slice_num, void* param)
+  {
+    (void) slice_num;
+
+    ( (RP2040_PWM_3Phase*) param)->handleWrap();
+  }
+
+  ///////////////////////////////////////////
+
+  // High-side level on A. Low-side on inverted B, delayed by the dead time on both edges in phase-correct mode
+  inline uint32_t toCC(const uint32_t& level)
+  {
+    uint32_t levelB = level + _deadTime;
+
+    if (levelB > _top + 1)
+      levelB = _top + 1;
+
+    return (level << PWM_CH0_CC_A_LSB) | (levelB << PWM_CH0_CC_B_LSB);
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_3PHASE_H
@@ -0,0 +1,554 @@
+/****************************************************************************************************************************
+  RP2040_PWM_ADC.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// ADC sampling synchronized to a PWM output, e.g. for current sensing in the middle of the on-time.
+// A DMA channel paced by the PWM wrap DREQ writes START_ONCE to the ADC at each wrap of the trigger slice,
+// and a second DMA channel paced by the ADC DREQ moves the results into a ring buffer. No CPU is involved
+// per sample. The trigger slice is either the PWM slice itself, whose wrap is the middle of the on-time in
+// phase-correct mode, or a spare slice with the same period, started with a counter offset to delay the
+// trigger by a number of ticks. Sample n is taken in period n after start(), and is tagged with n when read.
+
+#pragma once
+
+#ifndef RP2040_PWM_ADC_H
+#define RP2040_PWM_ADC_H
+
+#include "RP2040_PWM.h"
+
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+///////////////////////////////////////////////////////////////////
+
+// Ring buffer of 2^(PWM_ADC_RING_BITS - 1) samples, aligned to its size in bytes for the DMA ring
+#if !defined(PWM_ADC_RING_BITS)
+  #define PWM_ADC_RING_BITS         9
+#elif (PWM_ADC_RING_BITS < 2) || (PWM_ADC_RING_BITS > 15)
+  #error PWM_ADC_RING_BITS must be from 2 to 15
+#endif
+
+#define PWM_ADC_RING_SIZE           (1u << (PWM_ADC_RING_BITS - 1))
+
+// Trigger from the wrap of the PWM slice itself
+#define PWM_ADC_SAME_SLICE          0xFF
+
+// ADC inputs : 0-3 for GP26-GP29, 4 for the temperature sensor
+#define PWM_ADC_MAX_INPUT           4
+
+// 96 ADC clocks of 48MHz per conversion
+#define PWM_ADC_MAX_RATE            500000.0f
+
+// DMA transfers before the channels are re-armed
+#define PWM_ADC_TRANSFERS           0xFFFFFFFFu
+
+// Sample and index of the PWM period it was taken in, counted from start()
+typedef struct
+{
+  uint32_t  period;
+  uint16_t  value;
+} PWM_ADC_Sample;
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_ADC;
+
+// Only one ADC, so only one instance and one ring buffer
+static RP2040_PWM_ADC* PWM_ADC_instance = NULL;
+
+static uint16_t PWM_ADC_ring[PWM_ADC_RING_SIZE] __attribute__((aligned(PWM_ADC_RING_SIZE * sizeof(uint16_t))));
+
+static void PWM_ADC_DMA_handler();
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_ADC
+{
+  public:
+
+  // The slice of pin must be configured, e.g. by setPWM(), before begin()
+  RP2040_PWM_ADC(const uint8_t& pin)
+  {
+#if defined(F_CPU)
+    freq_CPU = F_CPU;
+#else
+    freq_CPU = 125000000;
+#endif
+
+    _pin          = pin;
+    _slice_num    = pwm_gpio_to_slice_num(pin);
+    _trigSlice    = _slice_num;
+    _delay        = 0;
+    _period       = 0;
+    _sampleRate   = 0;
+    _running      = false;
+    _dma_chan[0]  = _dma_chan[1] = -1;
+    _base         = 0;
+    _readCount    = 0;
+    _overruns     = 0;
+  }
+
+  ///////////////////////////////////////////
+
+  ~RP2040_PWM_ADC()
+  {
+    end();
+  }
+
+  ///////////////////////////////////////////
+
+  // triggerSlice = PWM_ADC_SAME_SLICE to trigger at the wrap of the PWM slice, then delayTicks must be 0.
+  // Else a spare slice, not otherwise used, triggers delayTicks counter ticks after each wrap of the PWM slice
+  bool begin(const uint8_t& adcInput, const uint8_t& triggerSlice = PWM_ADC_SAME_SLICE, const uint32_t& delayTicks = 0)
+  {
+    PWM_slice_shadow* shadow = &PWM_slice_shadow_data[_slice_num];
+
+    if (!shadow->loaded || (shadow->top == 0) || (adcInput > PWM_ADC_MAX_INPUT))
+    {
+      PWM_LOGERROR3("Error, PWM slice not configured or bad ADC input, slice =", _slice_num, ", input =", adcInput);
+
+      return false;
+    }
+
+    // Counter ticks per period, twice TOP + 1 in phase-correct mode
+    _period = (shadow->top + 1) * ( (shadow->csr & PWM_CH0_CSR_PH_CORRECT_BITS) ? 2 : 1 );
+    _delay  = delayTicks;
+
+    uint32_t div = (shadow->div & PWM_CH0_DIV_INT_BITS) >> PWM_CH0_DIV_INT_LSB;
+
+    if (div == 0)
+      div = 256;
+
+    _sampleRate = (float) freq_CPU / ( (float) _period * div );
+
+    if (triggerSlice == PWM_ADC_SAME_SLICE)
+    {
+      if (delayTicks != 0)
+      {
+        PWM_LOGERROR("Error, delayTicks needs a separate trigger slice");
+
+        return false;
+      }
+
+      _trigSlice = _slice_num;
+    }
+    else if ( (triggerSlice >= NUM_PWM_SLICES) || (triggerSlice == _slice_num) || (_period > 0x10000) ||
+              (delayTicks >= _period) )
+    {
+      PWM_LOGERROR3("Error, bad trigger slice or delay, slice =", triggerSlice, ", delay =", delayTicks);
+
+      return false;
+    }
+    else if (!PWM_resourceCheck(PWM_resourceClaimSlice(triggerSlice, this), triggerSlice))
+    {
+      return false;
+    }
+    else
+    {
+      _trigSlice = triggerSlice;
+    }
+
+    if (_sampleRate > PWM_ADC_MAX_RATE)
+    {
+      PWM_LOGERROR1("Error, PWM frequency too high for the ADC =", _sampleRate);
+
+      return false;
+    }
+
+    stop();
+
+    adc_init();
+
+    if (adcInput == PWM_ADC_MAX_INPUT)
+      adc_set_temp_sensor_enabled(true);
+    else
+      adc_gpio_init(26 + adcInput);
+
+    adc_select_input(adcInput);
+
+    // One result per DREQ, without error bit, 12-bit
+    adc_fifo_setup(true, true, 1, false, false);
+
+    _startCS = (adc_hw->cs & ~ADC_CS_START_MANY_BITS) | ADC_CS_START_ONCE_BITS;
+
+    if (_dma_chan[0] < 0)
+    {
+      _dma_chan[0] = dma_claim_unused_channel(false);
+      _dma_chan[1] = dma_claim_unused_channel(false);
+
+      if ( (_dma_chan[0] < 0) || (_dma_chan[1] < 0) )
+      {
+        PWM_LOGERROR("Error, no free DMA channel");
+
+        releaseDMA();
+
+        return false;
+      }
+
+      PWM_ADC_instance = this;
+      irq_add_shared_handler(DMA_IRQ_1, PWM_ADC_DMA_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+      irq_set_enabled(DMA_IRQ_1, true);
+    }
+
+    PWM_LOGINFO5("ADC: trigger slice =", _trigSlice, ", delay =", _delay, ", sample rate =", _sampleRate);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Ticks from the wrap to the middle of the on-time of the PWM pin, for begin() with a trigger slice.
+  // 0 in phase-correct mode, where the wrap at counter 0 is already the middle of the on-time
+  uint32_t getCenterDelay()
+  {
+    PWM_slice_shadow* shadow = &PWM_slice_shadow_data[_slice_num];
+
+    bool chanB      = (pwm_gpio_to_channel(_pin) == PWM_CHAN_B);
+    uint32_t level  = chanB ? (shadow->cc & PWM_CH0_CC_B_BITS) >> PWM_CH0_CC_B_LSB
+                            : (shadow->cc & PWM_CH0_CC_A_BITS) >> PWM_CH0_CC_A_LSB;
+    bool inverted   = shadow->csr & (chanB ? PWM_CH0_CSR_B_INV_BITS : PWM_CH0_CSR_A_INV_BITS);
+
+    if (shadow->csr & PWM_CH0_CSR_PH_CORRECT_BITS)
+    {
+      // Inverted output is high around TOP, half a period after the wrap
+      return inverted ? shadow->top + 1 : 0;
+    }
+
+    // High while counter < level, or counter >= level if inverted
+    return inverted ? (level + shadow->top + 1) / 2 : level / 2;
+  }
+
+  ///////////////////////////////////////////
+
+  // Restart the PWM slice, so that period 0 starts now, then sample once per period
+  bool start()
+  {
+    if (_dma_chan[0] < 0)
+      return false;
+
+    stop();
+
+    _base       = 0;
+    _readCount  = 0;
+    _overruns   = 0;
+
+    adc_run(false);
+    adc_fifo_drain();
+
+    uint32_t mask = (1u << _slice_num) | (1u << _trigSlice);
+
+    // Both slices stopped, counters restarted, so that no wrap DREQ is counted before period 0 ends
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, false);
+    PWM_shadow_flush(_slice_num, true);
+
+    if (_trigSlice != _slice_num)
+    {
+      // Normal mode, same DIV, one wrap per period of the PWM slice
+      PWM_shadow_set_csr(_trigSlice, 0);
+      PWM_shadow_set_div(_trigSlice, PWM_slice_shadow_data[_slice_num].div);
+      PWM_shadow_set_top(_trigSlice, _period - 1);
+      PWM_shadow_flush(_trigSlice, true);
+
+      // Counter ahead by period - delay : wraps delay ticks after the PWM slice
+      pwm_hw->slice[_trigSlice].ctr = (_period - _delay) % _period;
+    }
+
+    // Data : ADC FIFO to the ring buffer
+    dma_channel_config config = dma_channel_get_default_config(_dma_chan[1]);
+
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_ring(&config, true, PWM_ADC_RING_BITS);
+    channel_config_set_dreq(&config, DREQ_ADC);
+
+    dma_channel_configure(_dma_chan[1], &config, PWM_ADC_ring, &adc_hw->fifo, PWM_ADC_TRANSFERS, true);
+
+    // Trigger : START_ONCE at each wrap of the trigger slice
+    config = dma_channel_get_default_config(_dma_chan[0]);
+
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, DREQ_PWM_WRAP0 + _trigSlice);
+
+    dma_channel_configure(_dma_chan[0], &config, &adc_hw->cs, &_startCS, PWM_ADC_TRANSFERS, true);
+
+    dma_hw->ints1 = (1u << _dma_chan[0]) | (1u << _dma_chan[1]);
+    dma_channel_set_irq1_enabled(_dma_chan[0], true);
+    dma_channel_set_irq1_enabled(_dma_chan[1], true);
+
+    _running = true;
+
+    pwm_hw->en |= mask;
+
+    PWM_slice_shadow_data[_slice_num].csr |= PWM_CH0_CSR_EN_BITS;
+    PWM_slice_shadow_data[_trigSlice].csr |= PWM_CH0_CSR_EN_BITS;
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Stop sampling. The PWM slice keeps running, the trigger slice is stopped
+  void stop()
+  {
+    if (!_running)
+      return;
+
+    dma_channel_set_irq1_enabled(_dma_chan[0], false);
+    dma_channel_set_irq1_enabled(_dma_chan[1], false);
+
+    // Trigger first, so that no conversion is started without its transfer
+    dma_channel_abort(_dma_chan[0]);
+    dma_channel_abort(_dma_chan[1]);
+
+    dma_hw->ints1 = (1u << _dma_chan[0]) | (1u << _dma_chan[1]);
+
+    if (_trigSlice != _slice_num)
+    {
+      PWM_shadow_set_csr_bits(_trigSlice, PWM_CH0_CSR_EN_BITS, false);
+      PWM_shadow_flush(_trigSlice);
+    }
+
+    adc_fifo_drain();
+
+    _running = false;
+  }
+
+  ///////////////////////////////////////////
+
+  // Stop, release the DMA channels and the trigger slice. The PWM slice keeps running
+  void end()
+  {
+    stop();
+
+    if ( (_dma_chan[0] >= 0) && (PWM_ADC_instance == this) )
+    {
+      irq_remove_handler(DMA_IRQ_1, PWM_ADC_DMA_handler);
+      PWM_ADC_instance = NULL;
+    }
+
+    releaseDMA();
+
+    PWM_resourceReleaseAll(this);
+  }
+
+  ///////////////////////////////////////////
+
+  inline bool isRunning()
+  {
+    return _running;
+  }
+
+  ///////////////////////////////////////////
+
+  // Samples written to the ring buffer since start()
+  uint32_t getSampleCount()
+  {
+    if (_dma_chan[1] < 0)
+      return 0;
+
+    uint32_t status = save_and_disable_interrupts();
+
+    // Write address first : the transfer count may already include a transfer not yet written
+    uint32_t written  = (dma_hw->ch[_dma_chan[1]].write_addr - (uintptr_t) PWM_ADC_ring) / sizeof(uint16_t);
+    uint32_t count    = _base + (PWM_ADC_TRANSFERS - dma_hw->ch[_dma_chan[1]].transfer_count);
+
+    restore_interrupts(status);
+
+    return count - ( (count - written) & (PWM_ADC_RING_SIZE - 1) );
+  }
+
+  ///////////////////////////////////////////
+
+  // Samples not yet read, at most PWM_ADC_RING_SIZE - 1
+  uint32_t available()
+  {
+    uint32_t count = getSampleCount() - _readCount;
+
+    return (count < PWM_ADC_RING_SIZE) ? count : PWM_ADC_RING_SIZE - 1;
+  }
+
+  ///////////////////////////////////////////
+
+  // Oldest sample not yet read. Samples overwritten before being read are counted as overruns
+  bool read(PWM_ADC_Sample& sample)
+  {
+    while (true)
+    {
+      uint32_t count = getSampleCount();
+
+      if (count == _readCount)
+        return false;
+
+      // The slot after the last sample is being written by the next one
+      if (count - _readCount > PWM_ADC_RING_SIZE - 1)
+      {
+        _overruns  += count - _readCount - (PWM_ADC_RING_SIZE - 1);
+        _readCount  = count - (PWM_ADC_RING_SIZE - 1);
+      }
+
+      sample.period = _readCount;
+      sample.value  = PWM_ADC_ring[_readCount & (PWM_ADC_RING_SIZE - 1)];
+
+      // Still valid if not overwritten while being read
+      if (getSampleCount() - _readCount <= PWM_ADC_RING_SIZE - 1)
+      {
+        _readCount++;
+
+        return true;
+      }
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  // Newest sample, discarding the older ones not yet read
+  bool readLatest(PWM_ADC_Sample& sample)
+  {
+    uint32_t count = getSampleCount();
+
+    if (count == _readCount)
+      return false;
+
+    sample.period = count - 1;
+    sample.value  = PWM_ADC_ring[(count - 1) & (PWM_ADC_RING_SIZE - 1)];
+    _readCount    = count;
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getOverruns()
+  {
+    return _overruns;
+  }
+
+  ///////////////////////////////////////////
+
+  inline float getSampleRate()
+  {
+    return _sampleRate;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint8_t getTriggerSlice()
+  {
+    return _trigSlice;
+  }
+
+  ///////////////////////////////////////////
+
+  // Called from DMA_IRQ_1 after PWM_ADC_TRANSFERS transfers, to re-arm the channel where it stopped
+  void handleDMA()
+  {
+    for (uint8_t i = 0; i < 2; i++)
+    {
+      uint32_t mask = 1u << _dma_chan[i];
+
+      if (dma_hw->ints1 & mask)
+      {
+        dma_hw->ints1 = mask;
+
+        if (i == 1)
+          _base += PWM_ADC_TRANSFERS;
+
+        dma_channel_set_trans_count(_dma_chan[i], PWM_ADC_TRANSFERS, true);
+      }
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  inline bool ownsDMA(const uint32_t& ints)
+  {
+    return (_dma_chan[0] >= 0) && (ints & ( (1u << _dma_chan[0]) | (1u << _dma_chan[1]) ) );
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  uint32_t            freq_CPU;
+
+  // Counter ticks per period of the PWM slice, and trigger delay after its wrap
+  uint32_t            _period;
+  uint32_t            _delay;
+  float               _sampleRate;
+
+  // ADC CS with START_ONCE, written at each trigger
+  uint32_t            _startCS;
+
+  int                 _dma_chan[2];
+
+  // Sample count at the last re-arm, and samples read
+  volatile uint32_t   _base;
+  uint32_t            _readCount;
+  uint32_t            _overruns;
+
+  uint8_t             _pin;
+  uint8_t             _slice_num;
+  uint8_t             _trigSlice;
+  bool                _running;
+
+  ///////////////////////////////////////////
+
+  // Unclaim the DMA channels, also after a failed claim, so that the next begin() claims both again
+  void releaseDMA()
+  {
+    for (uint8_t i = 0; i < 2; i++)
+    {
+      if (_dma_chan[i] >= 0)
+        dma_channel_unclaim(_dma_chan[i]);
+
+      _dma_chan[i] = -1;
+    }
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+
+static void PWM_ADC_DMA_handler()
+{
+  uint32_t ints = dma_hw->ints1;
+
+  if (PWM_ADC_instance && PWM_ADC_instance->ownsDMA(ints))
+  {
+    PWM_ADC_instance->handleDMA();
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_ADC_H
@@ -0,0 +1,616 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Analyzer.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// Accuracy and cost analyzer for the frequency and duty-cycle mapping of RP2040_PWM.
+// Frequency x dutycycle x phaseCorrect is swept through setPWM_Int() on a real slice. The actual output of every
+// point is computed from the TOP, DIV, CSR and CC registers read back, not from the library variables, and the
+// average time of a frequency change, solved and from the operating-point cache, and of a dutycycle change is
+// measured. Results are printed as CSV and collected in histograms, to be compared as a baseline whenever
+// calc_TOP_and_DIV() or the duty mapping changes. The operating-point cache is left as it was before run().
+
+#pragma once
+
+#ifndef RP2040_PWM_ANALYZER_H
+#define RP2040_PWM_ANALYZER_H
+
+#include <string.h>
+
+#include "RP2040_PWM.h"
+
+#include "pico/time.h"
+
+///////////////////////////////////////////////////////////////////
+
+// Decade bins of the absolute errors, in ppm : < 1, < 10, < 100, < 1K, < 10K, < 100K, >= 100K
+#define PWM_ANALYZER_ERROR_BINS     7
+
+// Bins of the effective bits, 0 to 16
+#define PWM_ANALYZER_BITS_BINS      17
+
+// Longest histogram bar, in characters
+#define PWM_ANALYZER_BAR_WIDTH      50
+
+// Default calls per cost measurement. 0 to skip the cost measurement
+#define PWM_ANALYZER_COST_REPEATS   100
+
+///////////////////////////////////////////////////////////////////
+
+// Result of one operating point
+typedef struct
+{
+  float     frequency;        // Requested
+  float     actualFreq;       // From the slice registers
+  float     reportedFreq;     // From getActualFreq()
+  float     freqError;        // ppm of requested frequency, actualFreq vs frequency
+  float     reportError;      // ppm of actual frequency, reportedFreq vs actualFreq
+  uint32_t  dutycycle;        // Requested, 0-100,000
+  float     actualDuty;       // From the slice registers, 0-100,000
+  float     dutyError;        // ppm of full scale
+  float     effectiveBits;    // log2 of the levels reachable by the duty mapping, 0 to TOP
+  uint32_t  top;
+  float     div;
+  uint16_t  level;
+  bool      phaseCorrect;
+} PWM_Analyzer_Point;
+
+// Summary of all the points since resetStats()
+typedef struct
+{
+  uint32_t  points;
+  uint32_t  failed;           // Rejected by setPWM_Int()
+  float     maxFreqError;     // Absolute, ppm
+  float     sumFreqError;     // Absolute, ppm
+  float     maxReportError;   // Absolute, ppm
+  float     maxDutyError;     // Absolute, ppm
+  float     sumDutyError;     // Absolute, ppm
+  float     minBits;
+  float     maxBits;
+  uint32_t  costPoints;
+  uint32_t  maxFreqCost;      // ns per call, solved
+  uint32_t  sumFreqCost;
+  uint32_t  maxFreqCostCached; // ns per call, from the operating-point cache
+  uint32_t  sumFreqCostCached;
+  uint32_t  maxDutyCost;      // ns per call
+  uint32_t  sumDutyCost;
+} PWM_Analyzer_Stats;
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Analyzer
+{
+  public:
+
+  // The slice of pin is reprogrammed during the analysis
+  RP2040_PWM_Analyzer(const uint8_t& pin)
+  {
+    _pin          = pin;
+    // Any valid frequency, reprogrammed by each point
+    _PWM_Instance = new RP2040_PWM(pin, 1000.0f, 0);
+
+    float scale   = (float) _PWM_Instance->get_freq_CPU() / 125000000;
+
+    _minFreq          = (float) MIN_PWM_FREQUENCY * scale;
+    _maxFreq          = (float) MAX_PWM_FREQUENCY * scale;
+    _pointsPerDecade  = 10;
+    _dutySteps        = 11;
+    _costRepeats      = PWM_ANALYZER_COST_REPEATS;
+    _freqCost         = 0;
+    _freqCostCached   = 0;
+    _dutyCost         = 0;
+
+    resetStats();
+  }
+
+  ///////////////////////////////////////////
+
+  ~RP2040_PWM_Analyzer()
+  {
+    delete _PWM_Instance;
+  }
+
+  // Owns _PWM_Instance, not to be copied
+  RP2040_PWM_Analyzer(const RP2040_PWM_Analyzer&) = delete;
+  RP2040_PWM_Analyzer& operator=(const RP2040_PWM_Analyzer&) = delete;
+
+  ///////////////////////////////////////////
+
+  // Logarithmic frequency points, from minFreq to maxFreq inclusive
+  void setFreqRange(const float& minFreq, const float& maxFreq, const uint16_t& pointsPerDecade = 10)
+  {
+    _minFreq          = minFreq;
+    _maxFreq          = (maxFreq < minFreq) ? minFreq : maxFreq;
+    _pointsPerDecade  = (pointsPerDecade == 0) ? 1 : pointsPerDecade;
+  }
+
+  ///////////////////////////////////////////
+
+  // Linear dutycycle points, from 0 to 100,000 inclusive
+  inline void setDutySteps(const uint16_t& dutySteps = 11)
+  {
+    _dutySteps = (dutySteps < 2) ? 2 : dutySteps;
+  }
+
+  ///////////////////////////////////////////
+
+  // Calls averaged per cost measurement, 0 to skip
+  inline void setCostRepeats(const uint16_t& costRepeats = PWM_ANALYZER_COST_REPEATS)
+  {
+    _costRepeats = costRepeats;
+  }
+
+  ///////////////////////////////////////////
+
+  void resetStats()
+  {
+    memset(&_stats, 0, sizeof(_stats));
+    memset(_freqHist, 0, sizeof(_freqHist));
+    memset(_dutyHist, 0, sizeof(_dutyHist));
+    memset(_bitsHist, 0, sizeof(_bitsHist));
+
+    _stats.minBits = 16;
+  }
+
+  ///////////////////////////////////////////
+
+  // Program one operating point and compute its actual output. Return false if rejected by setPWM_Int()
+  bool analyzePoint(const float& frequency, const uint32_t& dutycycle, const bool& phaseCorrect,
+                    PWM_Analyzer_Point& point)
+  {
+    memset(&point, 0, sizeof(point));
+
+    point.frequency     = frequency;
+    point.dutycycle     = dutycycle;
+    point.phaseCorrect  = phaseCorrect;
+
+    if (!_PWM_Instance->setPWM_Int(_pin, frequency, dutycycle, phaseCorrect))
+    {
+      _stats.failed++;
+
+      return false;
+    }
+
+    readOutput(point);
+
+    point.reportedFreq  = _PWM_Instance->getActualFreq();
+    point.freqError     = (point.actualFreq - frequency) * 1000000.0f / frequency;
+    point.reportError   = (point.actualFreq > 0) ? (point.reportedFreq - point.actualFreq) * 1000000.0f / point.actualFreq : 0;
+    point.dutyError     = (point.actualDuty - dutycycle) * 10.0f;
+
+    addStats(point);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Average time in ns of setPWM_Int() changing frequency, solved then from the operating-point cache, and changing
+  // only dutycycle, at this point. The slice is left at the point. Called alone, the cached points are replaced
+  void measureCost(const float& frequency, const uint32_t& dutycycle, const bool& phaseCorrect)
+  {
+    _freqCost       = 0;
+    _freqCostCached = 0;
+    _dutyCost       = 0;
+
+    if (_costRepeats == 0)
+      return;
+
+    // Nearby values, to go through the same TOP / DIV range and avoid the 'no change' path
+    float     step      = (frequency * 1.001f <= _maxFreq) ? 0.0001f : -0.0001f;
+    float     otherFreq = frequency * (1.0f + 10 * step);
+    uint32_t  otherDuty = (dutycycle < 100000) ? dutycycle + 1 : dutycycle - 1;
+
+    // One more frequency than the cache entries, used in turn : always the least recently used one, never cached
+    float     solveFreq[PWM_OP_CACHE_SIZE + 1];
+
+    for (uint8_t i = 0; i <= PWM_OP_CACHE_SIZE; i++)
+      solveFreq[i] = frequency * (1.0f + i * step);
+
+    uint32_t startTime = time_us_32();
+
+    for (uint16_t i = 0; i < _costRepeats; i++)
+    {
+      _PWM_Instance->setPWM_Int(_pin, solveFreq[i % (PWM_OP_CACHE_SIZE + 1)], dutycycle, phaseCorrect);
+    }
+
+    _freqCost = (time_us_32() - startTime) * 1000 / _costRepeats;
+
+    // Both cached by the first 2 calls
+    _PWM_Instance->setPWM_Int(_pin, frequency, dutycycle, phaseCorrect);
+    _PWM_Instance->setPWM_Int(_pin, otherFreq, dutycycle, phaseCorrect);
+
+    startTime = time_us_32();
+
+    for (uint16_t i = 0; i < _costRepeats; i++)
+    {
+      _PWM_Instance->setPWM_Int(_pin, (i & 1) ? otherFreq : frequency, dutycycle, phaseCorrect);
+    }
+
+    _freqCostCached = (time_us_32() - startTime) * 1000 / _costRepeats;
+
+    _PWM_Instance->setPWM_Int(_pin, frequency, dutycycle, phaseCorrect);
+
+    startTime = time_us_32();
+
+    for (uint16_t i = 0; i < _costRepeats; i++)
+    {
+      _PWM_Instance->setPWM_Int(_pin, frequency, (i & 1) ? dutycycle : otherDuty, phaseCorrect);
+    }
+
+    _dutyCost = (time_us_32() - startTime) * 1000 / _costRepeats;
+
+    _PWM_Instance->setPWM_Int(_pin, frequency, dutycycle, phaseCorrect);
+
+    _stats.costPoints++;
+    _stats.sumFreqCost += _freqCost;
+    _stats.sumFreqCostCached += _freqCostCached;
+    _stats.sumDutyCost += _dutyCost;
+
+    if (_freqCost > _stats.maxFreqCost)
+      _stats.maxFreqCost = _freqCost;
+
+    if (_freqCostCached > _stats.maxFreqCostCached)
+      _stats.maxFreqCostCached = _freqCostCached;
+
+    if (_dutyCost > _stats.maxDutyCost)
+      _stats.maxDutyCost = _dutyCost;
+  }
+
+  ///////////////////////////////////////////
+
+  // Sweep phaseCorrect x frequency x dutycycle. Print a CSV line per point if out is not NULL.
+  // Return the number of points analyzed
+  uint32_t run(Print* out = &PWM_DBG_PORT)
+  {
+    PWM_Analyzer_Point point;
+    uint32_t count = 0;
+
+    // Cached points of the other instances, and the cache statistics, put back at the end
+    PWM_OpCache_Stats cacheStats = PWM_op_cache_stats_data;
+
+#if (PWM_OP_CACHE_SIZE > 0)
+    PWM_OpPoint cacheData[PWM_OP_CACHE_SIZE];
+
+    memcpy(cacheData, PWM_op_cache_data, sizeof(cacheData));
+#endif
+
+    if (out)
+      printHeader(*out);
+
+    for (uint8_t phaseCorrect = 0; phaseCorrect < 2; phaseCorrect++)
+    {
+      for (uint16_t i = 0; ; i++)
+      {
+        float frequency = _minFreq * powf(10.0f, (float) i / _pointsPerDecade);
+
+        if (frequency > _maxFreq)
+        {
+          // Last point exactly at maxFreq
+          if ( (i > 0) && (_minFreq * powf(10.0f, (float) (i - 1) / _pointsPerDecade) < _maxFreq) )
+            frequency = _maxFreq;
+          else
+            break;
+        }
+
+        // Cost first, as it leaves the slice at this frequency
+        measureCost(frequency, 0, phaseCorrect);
+
+        for (uint16_t j = 0; j < _dutySteps; j++)
+        {
+          uint32_t dutycycle = (uint32_t) ( (uint64_t) j * 100000 / (_dutySteps - 1) );
+
+          if (analyzePoint(frequency, dutycycle, phaseCorrect, point))
+          {
+            count++;
+
+            if (out)
+              printPoint(point, *out);
+          }
+        }
+
+        if (frequency >= _maxFreq)
+          break;
+      }
+    }
+
+#if (PWM_OP_CACHE_SIZE > 0)
+    memcpy(PWM_op_cache_data, cacheData, sizeof(cacheData));
+#endif
+
+    PWM_op_cache_stats_data = cacheStats;
+
+    return count;
+  }
+
+  ///////////////////////////////////////////
+
+  void printHeader(Print& out = PWM_DBG_PORT)
+  {
+    out.println(F("phaseCorrect,freq,duty,actualFreq,reportedFreq,freqErr_ppm,reportErr_ppm,actualDuty,dutyErr_ppm,"
+                  "top,div,level,bits,freqCost_ns,freqCostCached_ns,dutyCost_ns"));
+  }
+
+  ///////////////////////////////////////////
+
+  // CSV line. Costs are the last ones measured
+  void printPoint(const PWM_Analyzer_Point& point, Print& out = PWM_DBG_PORT)
+  {
+    out.print(point.phaseCorrect);        out.print(F(","));
+    out.print(point.frequency, 3);        out.print(F(","));
+    out.print(point.dutycycle);           out.print(F(","));
+    out.print(point.actualFreq, 3);       out.print(F(","));
+    out.print(point.reportedFreq, 3);     out.print(F(","));
+    out.print(point.freqError, 2);        out.print(F(","));
+    out.print(point.reportError, 2);      out.print(F(","));
+    out.print(point.actualDuty, 2);       out.print(F(","));
+    out.print(point.dutyError, 2);        out.print(F(","));
+    out.print(point.top);                 out.print(F(","));
+    out.print(point.div, 4);              out.print(F(","));
+    out.print(point.level);               out.print(F(","));
+    out.print(point.effectiveBits, 2);    out.print(F(","));
+    out.print(_freqCost);                 out.print(F(","));
+    out.print(_freqCostCached);           out.print(F(","));
+    out.println(_dutyCost);
+  }
+
+  ///////////////////////////////////////////
+
+  void printHistograms(Print& out = PWM_DBG_PORT)
+  {
+    out.println(F("\nFrequency error (ppm)"));
+    printErrorHistogram(_freqHist, out);
+
+    out.println(F("\nDutycycle error (ppm of full scale)"));
+    printErrorHistogram(_dutyHist, out);
+
+    out.println(F("\nEffective bits"));
+
+    for (uint8_t bin = 0; bin < PWM_ANALYZER_BITS_BINS; bin++)
+    {
+      out.print(F("  "));
+
+      if (bin < 10)
+        out.print(F(" "));
+
+      out.print(bin);
+      out.print(F("     "));
+      printBar(_bitsHist, PWM_ANALYZER_BITS_BINS, bin, out);
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  void printSummary(Print& out = PWM_DBG_PORT)
+  {
+    out.print(F("\nPoints = "));            out.print(_stats.points);
+    out.print(F(", Failed = "));            out.println(_stats.failed);
+
+    if (_stats.points)
+    {
+      out.print(F("Freq error ppm : max = "));      out.print(_stats.maxFreqError, 2);
+      out.print(F(", mean = "));                    out.println(_stats.sumFreqError / _stats.points, 2);
+      out.print(F("Reported freq error ppm : max = "));
+      out.println(_stats.maxReportError, 2);
+      out.print(F("Duty error ppm : max = "));      out.print(_stats.maxDutyError, 2);
+      out.print(F(", mean = "));                    out.println(_stats.sumDutyError / _stats.points, 2);
+      out.print(F("Effective bits : min = "));      out.print(_stats.minBits, 2);
+      out.print(F(", max = "));                     out.println(_stats.maxBits, 2);
+    }
+
+    if (_stats.costPoints)
+    {
+      out.print(F("Freq change ns : max = "));      out.print(_stats.maxFreqCost);
+      out.print(F(", mean = "));                    out.println(_stats.sumFreqCost / _stats.costPoints);
+      out.print(F("Cached freq change ns : max = ")); out.print(_stats.maxFreqCostCached);
+      out.print(F(", mean = "));                    out.println(_stats.sumFreqCostCached / _stats.costPoints);
+      out.print(F("Duty change ns : max = "));      out.print(_stats.maxDutyCost);
+      out.print(F(", mean = "));                    out.println(_stats.sumDutyCost / _stats.costPoints);
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  inline const PWM_Analyzer_Stats& getStats()
+  {
+    return _stats;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getFreqCost()
+  {
+    return _freqCost;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getFreqCostCached()
+  {
+    return _freqCostCached;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getDutyCost()
+  {
+    return _dutyCost;
+  }
+
+  ///////////////////////////////////////////
+
+  inline RP2040_PWM* getPWM()
+  {
+    return _PWM_Instance;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  RP2040_PWM*         _PWM_Instance;
+  uint8_t             _pin;
+
+  float               _minFreq;
+  float               _maxFreq;
+  uint16_t            _pointsPerDecade;
+  uint16_t            _dutySteps;
+  uint16_t            _costRepeats;
+
+  uint32_t            _freqCost;
+  uint32_t            _freqCostCached;
+  uint32_t            _dutyCost;
+
+  PWM_Analyzer_Stats  _stats;
+  uint32_t            _freqHist[PWM_ANALYZER_ERROR_BINS];
+  uint32_t            _dutyHist[PWM_ANALYZER_ERROR_BINS];
+  uint32_t            _bitsHist[PWM_ANALYZER_BITS_BINS];
+
+  ///////////////////////////////////////////
+
+  // Actual output from the registers. Same period formula as calc_TOP_and_DIV(), doubled in phase-correct mode
+  void readOutput(PWM_Analyzer_Point& point)
+  {
+    uint slice_num  = pwm_gpio_to_slice_num(_pin);
+    uint32_t csr    = pwm_hw->slice[slice_num].csr;
+    uint32_t div    = pwm_hw->slice[slice_num].div;
+    uint32_t cc     = pwm_hw->slice[slice_num].cc;
+
+    point.top       = pwm_hw->slice[slice_num].top;
+    point.div       = (float) ( (div & PWM_CH0_DIV_INT_BITS) >> PWM_CH0_DIV_INT_LSB )
+                      + (float) (div & PWM_CH0_DIV_FRAC_BITS) / 16;
+
+    // DIV INT = 0 is a divider of 256
+    if (point.div < 1.0f)
+      point.div += 256;
+
+    point.phaseCorrect = (csr & PWM_CH0_CSR_PH_CORRECT_BITS);
+    point.level = (pwm_gpio_to_channel(_pin) == PWM_CHAN_A) ? (cc & PWM_CH0_CC_A_BITS) >> PWM_CH0_CC_A_LSB
+                                                              : (cc & PWM_CH0_CC_B_BITS) >> PWM_CH0_CC_B_LSB;
+
+    point.actualFreq    = (float) _PWM_Instance->get_freq_CPU() / ( (point.top + 1) * point.div * (point.phaseCorrect ? 2 : 1) );
+
+    // Output is high while counter < level, so level > TOP is 100%
+    point.actualDuty    = (float) ( (point.level > point.top) ? point.top + 1 : point.level ) * 100000 / (point.top + 1);
+
+    point.effectiveBits = log2f(point.top + 1);
+  }
+
+  ///////////////////////////////////////////
+
+  void addStats(const PWM_Analyzer_Point& point)
+  {
+    float freqError   = fabsf(point.freqError);
+    float reportError = fabsf(point.reportError);
+    float dutyError   = fabsf(point.dutyError);
+
+    _stats.points++;
+    _stats.sumFreqError += freqError;
+    _stats.sumDutyError += dutyError;
+
+    if (freqError > _stats.maxFreqError)
+      _stats.maxFreqError = freqError;
+
+    if (reportError > _stats.maxReportError)
+      _stats.maxReportError = reportError;
+
+    if (dutyError > _stats.maxDutyError)
+      _stats.maxDutyError = dutyError;
+
+    if (point.effectiveBits < _stats.minBits)
+      _stats.minBits = point.effectiveBits;
+
+    if (point.effectiveBits > _stats.maxBits)
+      _stats.maxBits = point.effectiveBits;
+
+    _freqHist[errorBin(freqError)]++;
+    _dutyHist[errorBin(dutyError)]++;
+
+    uint8_t bitsBin = (uint8_t) point.effectiveBits;
+
+    _bitsHist[ (bitsBin < PWM_ANALYZER_BITS_BINS) ? bitsBin : PWM_ANALYZER_BITS_BINS - 1 ]++;
+  }
+
+  ///////////////////////////////////////////
+
+  uint8_t errorBin(float error)
+  {
+    uint8_t bin = 0;
+
+    while ( (error >= 1.0f) && (bin < PWM_ANALYZER_ERROR_BINS - 1) )
+    {
+      error /= 10;
+      bin++;
+    }
+
+    return bin;
+  }
+
+  ///////////////////////////////////////////
+
+  void printErrorHistogram(const uint32_t* hist, Print& out)
+  {
+    static const char* labels[PWM_ANALYZER_ERROR_BINS] =
+    {
+      "  < 1      ", "  < 10     ", "  < 100    ", "  < 1K     ", "  < 10K    ", "  < 100K   ", "  >= 100K  "
+    };
+
+    for (uint8_t bin = 0; bin < PWM_ANALYZER_ERROR_BINS; bin++)
+    {
+      out.print(labels[bin]);
+      printBar(hist, PWM_ANALYZER_ERROR_BINS, bin, out);
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  // Count, then a bar scaled to the largest bin
+  void printBar(const uint32_t* hist, const uint8_t& bins, const uint8_t& bin, Print& out)
+  {
+    uint32_t maxCount = 1;
+
+    for (uint8_t i = 0; i < bins; i++)
+    {
+      if (hist[i] > maxCount)
+        maxCount = hist[i];
+    }
+
+    out.print(hist[bin]);
+    out.print(F("\t"));
+
+    for (uint32_t i = 0; i < (hist[bin] * PWM_ANALYZER_BAR_WIDTH + maxCount - 1) / maxCount; i++)
+      out.print(F("#"));
+
+    out.println();
+  }
+};
+
+///////////////////////////////////////////
+
+#endif    // RP2040_PWM_ANALYZER_H
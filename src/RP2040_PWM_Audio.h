@@ -0,0 +1,661 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Audio.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// PCM audio playback over PWM.
+// The carrier runs at F_CPU / 2^bitDepth (488KHz for 8-bit @ 125MHz). The samples are converted to CC words,
+// both channels of the slice in one word for stereo, and written by DMA paced by a DMA timer at the audio rate.
+// Two DMA channels chained to each other play a double buffer, refilled in DMA_IRQ_0.
+
+#pragma once
+
+#ifndef RP2040_PWM_AUDIO_H
+#define RP2040_PWM_AUDIO_H
+
+#include "RP2040_PWM.h"
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+///////////////////////////////////////////////////////////////////
+
+// Number of output frames (CC words) per DMA half buffer
+#if !defined(PWM_AUDIO_BUFFER_FRAMES)
+  #define PWM_AUDIO_BUFFER_FRAMES       256
+#endif
+
+// Number of source frames requested from the stream callback at each call
+#if !defined(PWM_AUDIO_STREAM_FRAMES)
+  #define PWM_AUDIO_STREAM_FRAMES       64
+#endif
+
+#define PWM_AUDIO_MIN_BITS              6
+#define PWM_AUDIO_MAX_BITS              12
+
+#define PWM_AUDIO_NO_PIN                0xFF
+
+// 8-bit unsigned (as in WAV) or 16-bit signed samples, interleaved L/R if stereo
+typedef enum
+{
+  PWM_AUDIO_FORMAT_U8  = 0,
+  PWM_AUDIO_FORMAT_S16 = 1
+} PWM_Audio_Format;
+
+// Fill buffer with up to frames of interleaved 16-bit signed samples. Return the number of frames, 0 to stop
+typedef uint32_t (*PWM_Audio_Callback)(int16_t* buffer, const uint32_t& frames);
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Audio;
+
+static RP2040_PWM_Audio* PWM_Audio_instance = NULL;
+
+static void PWM_Audio_DMA_handler();
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Audio
+{
+  public:
+
+  // pinR = PWM_AUDIO_NO_PIN for mono. For stereo, pinL and pinR must be channel A and B of the same slice
+  RP2040_PWM_Audio(const uint8_t& pinL, const uint8_t& pinR = PWM_AUDIO_NO_PIN)
+  {
+#if defined(F_CPU)
+    freq_CPU = F_CPU;
+#else
+    freq_CPU = 125000000;
+#endif
+
+    _pinL       = pinL;
+    _pinR       = pinR;
+    _slice_num  = pwm_gpio_to_slice_num(pinL);
+    _stereo     = (pinR != PWM_AUDIO_NO_PIN);
+    _playing    = false;
+    _started    = false;
+    _dma_chan[0] = _dma_chan[1] = -1;
+    _dma_timer   = -1;
+  }
+
+  ///////////////////////////////////////////
+
+  ~RP2040_PWM_Audio()
+  {
+    end();
+  }
+
+  ///////////////////////////////////////////
+
+  // sampleRate is the output rate of the DMA timer. bitDepth from 6 to 12, carrier = F_CPU / 2^bitDepth
+  bool begin(const uint32_t& sampleRate, const uint8_t& bitDepth = 8)
+  {
+    if ( (bitDepth < PWM_AUDIO_MIN_BITS) || (bitDepth > PWM_AUDIO_MAX_BITS) )
+    {
+      PWM_LOGERROR1("Error, bitDepth must be from 6 to 12, bitDepth =", bitDepth);
+
+      return false;
+    }
+
+    // New carrier and sampleRate, never changed under a running DMA
+    stop();
+
+    _bitDepth = bitDepth;
+    _top      = (1UL << bitDepth) - 1;
+    _carrier  = freq_CPU / (_top + 1);
+
+    if (_carrier < 2 * sampleRate)
+    {
+      PWM_LOGERROR3("Error, carrier =", _carrier, "too low for sampleRate =", sampleRate);
+
+      return false;
+    }
+
+    if (_stereo && (pwm_gpio_to_slice_num(_pinR) != _slice_num) )
+    {
+      PWM_LOGERROR3("Error, not correct PWM stereo pair of pins = ", _pinL, "and", _pinR);
+
+      return false;
+    }
+
+    _shiftL = pwm_gpio_to_channel(_pinL) ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB;
+    _shiftR = _stereo ? (pwm_gpio_to_channel(_pinR) ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB) : _shiftL;
+
+    if (_stereo && (_shiftL == _shiftR) )
+    {
+      PWM_LOGERROR3("Error, stereo pins on the same channel = ", _pinL, "and", _pinR);
+
+      return false;
+    }
+
+    if (!calcTimerFraction(sampleRate))
+      return false;
+
+    // CC words are written by DMA for both channels
+    if (!PWM_resourceCheck(PWM_resourceClaimSlice(_slice_num, this), _slice_num))
+      return false;
+
+    gpio_set_function(_pinL, GPIO_FUNC_PWM);
+
+    if (_stereo)
+      gpio_set_function(_pinR, GPIO_FUNC_PWM);
+
+    // Start at mid-scale to avoid a click
+    _silence = frameToCC(0, 0);
+
+    PWM_shadow_set_div(_slice_num, 1 << PWM_CH0_DIV_INT_LSB);
+    PWM_shadow_set_top(_slice_num, _top);
+    PWM_shadow_set_csr(_slice_num, PWM_CH0_CSR_EN_BITS);
+    PWM_slice_shadow_data[_slice_num].cc = _silence;
+    PWM_slice_shadow_data[_slice_num].dirty |= PWM_SHADOW_CC;
+    PWM_shadow_flush(_slice_num, true);
+
+    if (!claimDMA())
+      return false;
+
+    PWM_LOGINFO5("Audio: carrier =", _carrier, ", sampleRate =", _sampleRate, ", bitDepth =", _bitDepth);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Play frames from a buffer. srcRate is converted to the output sampleRate
+  bool play(const void* data, const uint32_t& frames, const PWM_Audio_Format& format, const uint8_t& channels,
+            const uint32_t& srcRate, const bool& interpolate = true, const bool& loop = false)
+  {
+    if ( (data == NULL) || (frames == 0) )
+      return false;
+
+    stop();
+
+    _data       = data;
+    _dataFrames = frames;
+    _dataIndex  = 0;
+    _format     = format;
+    _loop       = loop;
+    _callback   = NULL;
+
+    return start(channels, srcRate, interpolate);
+  }
+
+  ///////////////////////////////////////////
+
+  // Play frames of 16-bit signed samples from a streaming callback
+  bool play(PWM_Audio_Callback callback, const uint8_t& channels, const uint32_t& srcRate, const bool& interpolate = true)
+  {
+    if (callback == NULL)
+      return false;
+
+    stop();
+
+    _data       = NULL;
+    _callback   = callback;
+    _format     = PWM_AUDIO_FORMAT_S16;
+    _loop       = false;
+    _streamCount = 0;
+    _streamIndex = 0;
+
+    return start(channels, srcRate, interpolate);
+  }
+
+  ///////////////////////////////////////////
+
+  void stop()
+  {
+    if (!_started)
+      return;
+
+    dma_channel_set_irq0_enabled(_dma_chan[0], false);
+    dma_channel_set_irq0_enabled(_dma_chan[1], false);
+
+    // Abort both, as a chained channel can be triggered while aborting the other
+    dma_hw->abort = (1u << _dma_chan[0]) | (1u << _dma_chan[1]);
+
+    while (dma_hw->abort & ( (1u << _dma_chan[0]) | (1u << _dma_chan[1]) ) )
+      tight_loop_contents();
+
+    dma_hw->ints0 = (1u << _dma_chan[0]) | (1u << _dma_chan[1]);
+
+    pwm_hw->slice[_slice_num].cc         = _silence;
+    PWM_slice_shadow_data[_slice_num].cc = _silence;
+
+    _playing = false;
+    _started = false;
+  }
+
+  ///////////////////////////////////////////
+
+  // Stop, release the DMA channels and timer, then the slice. begin() is needed again before play()
+  void end()
+  {
+    stop();
+
+    if (_dma_chan[0] >= 0)
+    {
+      if (PWM_Audio_instance == this)
+      {
+        irq_remove_handler(DMA_IRQ_0, PWM_Audio_DMA_handler);
+        PWM_Audio_instance = NULL;
+      }
+
+      releaseDMA();
+
+      PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, false);
+      PWM_shadow_flush(_slice_num);
+    }
+
+    PWM_resourceReleaseAll(this);
+  }
+
+  ///////////////////////////////////////////
+
+  // Still true while the last buffers holding data are being played
+  inline bool isPlaying()
+  {
+    return _started;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getCarrierFreq()
+  {
+    return _carrier;
+  }
+
+  ///////////////////////////////////////////
+
+  // Real output sample rate, from the DMA timer fraction
+  inline float getActualSampleRate()
+  {
+    return _sampleRate;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint16_t get_TOP()
+  {
+    return _top;
+  }
+
+  ///////////////////////////////////////////
+
+  // Called from DMA_IRQ_0
+  void handleIRQ()
+  {
+    for (uint8_t i = 0; i < 2; i++)
+    {
+      uint32_t mask = 1u << _dma_chan[i];
+
+      if (dma_hw->ints0 & mask)
+      {
+        dma_hw->ints0 = mask;
+
+        if (!_playing)
+        {
+          // Finished buffer was the last one holding data. Let the other play silence, then stop
+          if (++_drained >= 2)
+          {
+            stop();
+
+            return;
+          }
+        }
+
+        fillBuffer(i);
+        dma_channel_set_read_addr(_dma_chan[i], _buffer[i], false);
+      }
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  uint32_t    freq_CPU;
+  uint32_t    _carrier;
+  float       _sampleRate;
+  uint16_t    _timerX;
+  uint16_t    _timerY;
+
+  uint16_t    _top;
+  uint8_t     _bitDepth;
+  uint8_t     _pinL;
+  uint8_t     _pinR;
+  uint8_t     _slice_num;
+  uint8_t     _shiftL;
+  uint8_t     _shiftR;
+  bool        _stereo;
+
+  int         _dma_chan[2];
+  int         _dma_timer;
+
+  uint32_t    _buffer[2][PWM_AUDIO_BUFFER_FRAMES];
+  uint32_t    _silence;
+
+  // Source
+  const void*         _data;
+  uint32_t            _dataFrames;
+  uint32_t            _dataIndex;
+  PWM_Audio_Format    _format;
+  uint8_t             _channels;
+  bool                _loop;
+
+  PWM_Audio_Callback  _callback;
+  int16_t             _stream[PWM_AUDIO_STREAM_FRAMES * 2];
+  uint32_t            _streamCount;
+  uint32_t            _streamIndex;
+
+  // Rate converter, 16.16 fixed-point phase between _prev and _next source frames
+  uint32_t    _step;
+  uint32_t    _phase;
+  int16_t     _prev[2];
+  int16_t     _next[2];
+  bool        _interpolate;
+
+  volatile bool     _playing;
+  volatile bool     _started;
+  volatile uint8_t  _drained;
+
+  ///////////////////////////////////////////
+
+  // DMA timer rate = F_CPU * X / Y, with X and Y 16-bit. Best approximation by continued fractions
+  bool calcTimerFraction(const uint32_t& sampleRate)
+  {
+    uint32_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    uint32_t num = sampleRate, den = freq_CPU;
+
+    while (den != 0)
+    {
+      uint32_t a  = num / den;
+      uint32_t p2 = a * p1 + p0;
+      uint32_t q2 = a * q1 + q0;
+
+      if ( (p2 > 0xFFFF) || (q2 > 0xFFFF) )
+        break;
+
+      p0 = p1; q0 = q1;
+      p1 = p2; q1 = q2;
+
+      uint32_t rem = num - a * den;
+      num = den;
+      den = rem;
+    }
+
+    if ( (p1 == 0) || (q1 == 0) || (q1 > 0xFFFF) )
+    {
+      PWM_LOGERROR1("Error, can't pace DMA at sampleRate =", sampleRate);
+
+      return false;
+    }
+
+    _timerX     = p1;
+    _timerY     = q1;
+    _sampleRate = (float) freq_CPU * _timerX / _timerY;
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  bool claimDMA()
+  {
+    if (_dma_chan[0] < 0)
+    {
+      _dma_chan[0] = dma_claim_unused_channel(false);
+      _dma_chan[1] = dma_claim_unused_channel(false);
+      _dma_timer   = dma_claim_unused_timer(false);
+
+      if ( (_dma_chan[0] < 0) || (_dma_chan[1] < 0) || (_dma_timer < 0) )
+      {
+        PWM_LOGERROR("Error, no free DMA channel or timer");
+
+        releaseDMA();
+
+        return false;
+      }
+
+      for (uint8_t i = 0; i < 2; i++)
+      {
+        dma_channel_config config = dma_channel_get_default_config(_dma_chan[i]);
+
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, dma_get_timer_dreq(_dma_timer));
+        channel_config_set_chain_to(&config, _dma_chan[i ^ 1]);
+
+        dma_channel_configure(_dma_chan[i], &config, &pwm_hw->slice[_slice_num].cc, _buffer[i], PWM_AUDIO_BUFFER_FRAMES, false);
+      }
+
+      PWM_Audio_instance = this;
+      irq_add_shared_handler(DMA_IRQ_0, PWM_Audio_DMA_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+      irq_set_enabled(DMA_IRQ_0, true);
+    }
+
+    // Channels and timer are kept by a new begin(), but the sampleRate may have changed
+    dma_timer_set_fraction(_dma_timer, _timerX, _timerY);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Unclaim what a failed claimDMA() got, so that the next begin() claims all again
+  void releaseDMA()
+  {
+    for (uint8_t i = 0; i < 2; i++)
+    {
+      if (_dma_chan[i] >= 0)
+        dma_channel_unclaim(_dma_chan[i]);
+
+      _dma_chan[i] = -1;
+    }
+
+    if (_dma_timer >= 0)
+      dma_timer_unclaim(_dma_timer);
+
+    _dma_timer = -1;
+  }
+
+  ///////////////////////////////////////////
+
+  bool start(const uint8_t& channels, const uint32_t& srcRate, const bool& interpolate)
+  {
+    if ( (_dma_chan[0] < 0) || (channels < 1) || (channels > 2) || (srcRate == 0) )
+      return false;
+
+    _channels    = channels;
+    _interpolate = interpolate;
+    _step        = (uint32_t) ( ( (uint64_t) srcRate << 16 ) / _sampleRate );
+    _phase       = 0;
+    _playing     = true;
+    _drained     = 0;
+
+    // Prime the converter with the first 2 source frames
+    if ( !fetchFrame(_prev) )
+      return false;
+
+    if ( !fetchFrame(_next) )
+    {
+      _next[0] = _prev[0];
+      _next[1] = _prev[1];
+    }
+
+    fillBuffer(0);
+    fillBuffer(1);
+
+    dma_channel_set_read_addr(_dma_chan[0], _buffer[0], false);
+    dma_channel_set_read_addr(_dma_chan[1], _buffer[1], false);
+
+    dma_hw->ints0 = (1u << _dma_chan[0]) | (1u << _dma_chan[1]);
+    dma_channel_set_irq0_enabled(_dma_chan[0], true);
+    dma_channel_set_irq0_enabled(_dma_chan[1], true);
+
+    _started = true;
+
+    dma_channel_start(_dma_chan[0]);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Get next source frame as 16-bit signed L/R. Mono source is copied to both
+  bool fetchFrame(int16_t* frame)
+  {
+    if (_callback)
+    {
+      if (_streamIndex >= _streamCount)
+      {
+        _streamCount = _callback(_stream, PWM_AUDIO_STREAM_FRAMES);
+        _streamIndex = 0;
+
+        if (_streamCount == 0)
+          return false;
+      }
+
+      const int16_t* src = &_stream[_streamIndex++ * _channels];
+
+      frame[0] = src[0];
+      frame[1] = src[_channels - 1];
+
+      return true;
+    }
+
+    if (_dataIndex >= _dataFrames)
+    {
+      if (!_loop)
+        return false;
+
+      _dataIndex = 0;
+    }
+
+    uint32_t index = _dataIndex++ * _channels;
+
+    if (_format == PWM_AUDIO_FORMAT_U8)
+    {
+      const uint8_t* src = (const uint8_t*) _data + index;
+
+      frame[0] = ( (int16_t) src[0] - 128 ) << 8;
+      frame[1] = ( (int16_t) src[_channels - 1] - 128 ) << 8;
+    }
+    else
+    {
+      const int16_t* src = (const int16_t*) _data + index;
+
+      frame[0] = src[0];
+      frame[1] = src[_channels - 1];
+    }
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t frameToCC(const int16_t& left, const int16_t& right)
+  {
+    // 16-bit signed to 0..TOP
+    uint32_t levelL = ( (uint32_t) (left  + 32768) ) >> (16 - _bitDepth);
+    uint32_t levelR = ( (uint32_t) (right + 32768) ) >> (16 - _bitDepth);
+
+    if (!_stereo)
+      return levelL << _shiftL;
+
+    return (levelL << _shiftL) | (levelR << _shiftR);
+  }
+
+  ///////////////////////////////////////////
+
+  void fillBuffer(const uint8_t& index)
+  {
+    uint32_t* buffer = _buffer[index];
+
+    for (uint32_t i = 0; i < PWM_AUDIO_BUFFER_FRAMES; i++)
+    {
+      if (!_playing)
+      {
+        buffer[i] = _silence;
+
+        continue;
+      }
+
+      // Advance source while phase >= 1.0
+      while (_phase >= 0x10000)
+      {
+        _phase -= 0x10000;
+
+        _prev[0] = _next[0];
+        _prev[1] = _next[1];
+
+        if (!fetchFrame(_next))
+        {
+          _playing = false;
+
+          break;
+        }
+      }
+
+      if (!_playing)
+      {
+        buffer[i] = _silence;
+
+        continue;
+      }
+
+      if (_interpolate)
+      {
+        // 15-bit fraction to keep the product inside int32_t
+        int32_t frac  = _phase >> 1;
+        int16_t left  = _prev[0] + ( ( (int32_t) (_next[0] - _prev[0]) * frac ) >> 15 );
+        int16_t right = _prev[1] + ( ( (int32_t) (_next[1] - _prev[1]) * frac ) >> 15 );
+
+        buffer[i] = frameToCC(left, right);
+      }
+      else
+      {
+        buffer[i] = frameToCC(_prev[0], _prev[1]);
+      }
+
+      _phase += _step;
+    }
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+
+static void PWM_Audio_DMA_handler()
+{
+  if (PWM_Audio_instance)
+    PWM_Audio_instance->handleIRQ();
+}
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_AUDIO_H
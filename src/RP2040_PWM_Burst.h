@@ -0,0 +1,542 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Burst.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// Burst / N-pulse generation. Each PWM period is one pulse, so the pulses are counted by the wraps.
+// CC is double-buffered : a level written during period k is latched at wrap k and used in period k + 1.
+// So the zero level ending a burst of N pulses is written during period N, and the last pulse is never truncated.
+// PWM_BURST_IRQ   : levels written from PWM_IRQ_WRAP, with any number of bursts and gaps (in periods).
+//                   Limited by the IRQ latency, up to PWM_BURST_IRQ_MAX_FREQUENCY. Above, one burst uses PWM_BURST_DMA
+// PWM_BURST_DMA   : one DMA channel paced by the wrap DREQ counts N - 1 wraps, then chains to another writing
+//                   the zero level. Exact at any frequency, one burst per start()
+
+#pragma once
+
+#ifndef RP2040_PWM_BURST_H
+#define RP2040_PWM_BURST_H
+
+#include "RP2040_PWM.h"
+#include "PWM_Wrap_IRQ.h"
+
+#include "hardware/dma.h"
+
+///////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+  PWM_BURST_IRQ = 0,
+  PWM_BURST_DMA = 1
+} PWM_Burst_Mode;
+
+typedef void (*PWM_Burst_Callback)(const uint& slice_num);
+
+#if !defined(DREQ_FORCE)
+  #define DREQ_FORCE      0x3F
+#endif
+
+// Highest frequency of PWM_BURST_IRQ at 125MHz, scaled with F_CPU. Each wrap IRQ must end before the next wrap
+#if !defined(PWM_BURST_IRQ_MAX_FREQUENCY)
+  #define PWM_BURST_IRQ_MAX_FREQUENCY     (100000.0f)
+#endif
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Burst;
+
+static RP2040_PWM_Burst* PWM_Burst_DMA_instance[NUM_PWM_SLICES] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+
+static void PWM_Burst_DMA_handler();
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Burst
+{
+  public:
+
+  RP2040_PWM_Burst(const uint8_t& pin)
+  {
+#if defined(F_CPU)
+    freq_CPU = F_CPU;
+#else
+    freq_CPU = 125000000;
+#endif
+
+    _pin        = pin;
+    _slice_num  = pwm_gpio_to_slice_num(pin);
+    _chan       = pwm_gpio_to_channel(pin);
+    _callback   = NULL;
+    _pulses     = 0;
+    _running    = false;
+    _done       = false;
+    _dma_chan[0] = _dma_chan[1] = -1;
+  }
+
+  ///////////////////////////////////////////
+
+  ~RP2040_PWM_Burst()
+  {
+    stop();
+
+    if (_dma_chan[0] >= 0)
+    {
+      PWM_Burst_DMA_instance[_slice_num] = NULL;
+
+      dma_channel_unclaim(_dma_chan[0]);
+      dma_channel_unclaim(_dma_chan[1]);
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  // dutycycle from 0-100,000 for 0%-100%. bursts of pulses, separated by gapPeriods periods at 0
+  bool setBurst_Int(const float& frequency, const uint32_t& dutycycle, const uint32_t& pulses, const uint32_t& bursts = 1,
+                    const uint32_t& gapPeriods = 0, const PWM_Burst_Mode& mode = PWM_BURST_IRQ)
+  {
+    if ( (frequency > ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000)) ||
+         (frequency < ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000)) || (pulses == 0) || (bursts == 0) ||
+         (dutycycle > 100000) )
+    {
+      PWM_LOGERROR3("Error, invalid burst, frequency =", frequency, ", pulses =", pulses);
+
+      return false;
+    }
+
+    if ( (mode == PWM_BURST_DMA) && (bursts > 1) )
+    {
+      PWM_LOGERROR("Error, PWM_BURST_DMA supports only one burst per start()");
+
+      return false;
+    }
+
+    _mode = mode;
+
+    if ( (mode == PWM_BURST_IRQ) && (frequency > ( (float) PWM_BURST_IRQ_MAX_FREQUENCY * freq_CPU / 125000000)) )
+    {
+      if (bursts > 1)
+      {
+        PWM_LOGERROR1("Error, frequency too high for repeated bursts from the wrap IRQ =", frequency);
+
+        return false;
+      }
+
+      // The wraps are counted by DMA instead
+      _mode = PWM_BURST_DMA;
+
+      PWM_LOGINFO1("Burst: PWM_BURST_DMA used for frequency =", frequency);
+    }
+
+    uint32_t ticks = freq_CPU / frequency;
+
+    _div    = (ticks >> 16) + 1;
+    _top    = ticks / _div - 1;
+
+    // Same mapping as setPWM_Int()
+    _level  = ( _top * (dutycycle / 2) ) / 50000;
+
+    _actualFrequency  = (float) freq_CPU / ( (_top + 1) * _div );
+    _pulses           = pulses;
+    _bursts           = bursts;
+    _gap              = gapPeriods;
+
+    PWM_LOGINFO5("Burst: TOP =", _top, ", DIV =", _div, ", actual freq =", _actualFrequency);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  bool setBurst(const float& frequency, const float& dutycycle, const uint32_t& pulses, const uint32_t& bursts = 1,
+                const uint32_t& gapPeriods = 0, const PWM_Burst_Mode& mode = PWM_BURST_IRQ)
+  {
+    return setBurst_Int(frequency, dutycycle * 1000, pulses, bursts, gapPeriods, mode);
+  }
+
+  ///////////////////////////////////////////
+
+  // Called once all bursts are output, from IRQ context
+  inline void attachCallback(PWM_Burst_Callback callback)
+  {
+    _callback = callback;
+  }
+
+  ///////////////////////////////////////////
+
+  bool start()
+  {
+    if (_pulses == 0)
+      return false;
+
+    stop();
+
+    // Both channels, as the whole slice is restarted, then stopped at the end. Released by stop() or the end
+    if (!PWM_resourceCheck(PWM_resourceClaimSlice(_slice_num, this), _slice_num))
+      return false;
+
+    _done         = false;
+    _burstCount   = 0;
+    _wraps        = 0;
+    _progPeriod   = 0;
+    _progPos      = 0;
+    _totalPeriods = _bursts * (_pulses + _gap) - _gap;
+
+    gpio_set_function(_pin, GPIO_FUNC_PWM);
+
+    // Slice stopped, counter cleared : the writes are latched immediately
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, false);
+    PWM_shadow_flush(_slice_num, true);
+
+    PWM_shadow_set_div(_slice_num, _div << PWM_CH0_DIV_INT_LSB);
+    PWM_shadow_set_top(_slice_num, _top);
+    PWM_shadow_set_level(_slice_num, _chan, nextLevel());
+    PWM_shadow_set_csr(_slice_num, PWM_slice_shadow_data[_slice_num].csr & ~PWM_CH0_CSR_PH_CORRECT_BITS);
+    PWM_shadow_flush(_slice_num);
+
+    _running = true;
+
+    if ( (_mode == PWM_BURST_DMA) && (_pulses > 1) )
+    {
+      if (!startDMA())
+      {
+        _running = false;
+
+        return false;
+      }
+    }
+    else
+    {
+      PWM_attachWrapInterrupt(_slice_num, RP2040_PWM_Burst::wrapHandler, this);
+    }
+
+    // Start, then at once the level of period 2, latched at wrap 1
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, true);
+    PWM_shadow_flush(_slice_num);
+
+    if ( (_mode == PWM_BURST_IRQ) || (_pulses == 1) )
+    {
+      PWM_shadow_set_level(_slice_num, _chan, nextLevel());
+      PWM_shadow_flush(_slice_num);
+    }
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  void stop()
+  {
+    if (!_running)
+      return;
+
+    PWM_detachWrapInterrupt(_slice_num);
+
+    if (_dma_chan[0] >= 0)
+    {
+      dma_channel_set_irq1_enabled(_dma_chan[1], false);
+      dma_channel_abort(_dma_chan[0]);
+      dma_channel_abort(_dma_chan[1]);
+    }
+
+    PWM_shadow_set_level(_slice_num, _chan, 0);
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, false);
+    PWM_shadow_flush(_slice_num);
+
+    PWM_resourceReleaseAll(this);
+
+    _running = false;
+  }
+
+  ///////////////////////////////////////////
+
+  inline bool isDone()
+  {
+    return _done;
+  }
+
+  ///////////////////////////////////////////
+
+  inline bool isRunning()
+  {
+    return _running;
+  }
+
+  ///////////////////////////////////////////
+
+  // Completed bursts. Updated at the end of the burst only with PWM_BURST_DMA
+  inline uint32_t getBurstCount()
+  {
+    return _burstCount;
+  }
+
+  ///////////////////////////////////////////
+
+  // Periods output since start()
+  inline uint32_t getPeriodCount()
+  {
+    return _wraps;
+  }
+
+  ///////////////////////////////////////////
+
+  inline float getActualFreq()
+  {
+    return _actualFrequency;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t get_TOP()
+  {
+    return _top;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t get_DIV()
+  {
+    return _div;
+  }
+
+  ///////////////////////////////////////////
+
+  // Mode really used, PWM_BURST_DMA above PWM_BURST_IRQ_MAX_FREQUENCY
+  inline PWM_Burst_Mode getMode()
+  {
+    return _mode;
+  }
+
+  ///////////////////////////////////////////
+
+  // At every wrap, program the level of the period after the next one
+  void handleWrap()
+  {
+    _wraps++;
+
+    // Wrap ending the last pulse of a burst
+    if ( (_mode == PWM_BURST_IRQ) && ( (_wraps % (_pulses + _gap)) == (_pulses % (_pulses + _gap)) ) )
+      _burstCount++;
+
+    if (_wraps >= _totalPeriods)
+    {
+      // Period _totalPeriods + 1 is running with zero level, safe to stop
+      finish();
+
+      return;
+    }
+
+    if (_mode == PWM_BURST_IRQ)
+    {
+      PWM_shadow_set_level(_slice_num, _chan, nextLevel());
+      PWM_shadow_flush(_slice_num);
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  // PWM_BURST_DMA : zero level written at the start of period N. Stop at the next wrap
+  void handleDMA()
+  {
+    _wraps = _totalPeriods - 1;
+
+    PWM_attachWrapInterrupt(_slice_num, RP2040_PWM_Burst::wrapHandler, this);
+  }
+
+  ///////////////////////////////////////////
+
+  inline int getDMAChannel()
+  {
+    return _dma_chan[1];
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  uint32_t            freq_CPU;
+  float               _actualFrequency;
+
+  uint32_t            _top;
+  uint32_t            _div;
+  uint32_t            _level;
+  uint32_t            _pulses;
+  uint32_t            _bursts;
+  uint32_t            _gap;
+  uint32_t            _totalPeriods;
+
+  // Period index and position in burst + gap of the last level programmed
+  uint32_t            _progPeriod;
+  uint32_t            _progPos;
+
+  volatile uint32_t   _wraps;
+  volatile uint32_t   _burstCount;
+
+  PWM_Burst_Mode      _mode;
+  PWM_Burst_Callback  _callback;
+
+  int                 _dma_chan[2];
+  uint32_t            _dmaDummy;
+  uint32_t            _dmaZeroCC;
+
+  uint8_t             _pin;
+  uint8_t             _slice_num;
+  uint8_t             _chan;
+  volatile bool       _running;
+  volatile bool       _done;
+
+  ///////////////////////////////////////////
+
+  static void wrapHandler(const uint& slice_num, void* param)
+  {
+    (void) slice_num;
+
+    ( (RP2040_PWM_Burst*) param)->handleWrap();
+  }
+
+  ///////////////////////////////////////////
+
+  // Level of the next period to program : pulse inside a burst, 0 in a gap or after the last burst
+  uint32_t nextLevel()
+  {
+    uint32_t level = ( (_progPeriod < _totalPeriods) && (_progPos < _pulses) ) ? _level : 0;
+
+    _progPeriod++;
+
+    if (++_progPos >= _pulses + _gap)
+      _progPos = 0;
+
+    return level;
+  }
+
+  ///////////////////////////////////////////
+
+  void finish()
+  {
+    PWM_detachWrapInterrupt(_slice_num);
+
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, false);
+    PWM_shadow_flush(_slice_num);
+
+    if (_mode == PWM_BURST_DMA)
+      _burstCount = 1;
+
+    PWM_resourceReleaseAll(this);
+
+    _running  = false;
+    _done     = true;
+
+    if (_callback)
+      _callback(_slice_num);
+  }
+
+  ///////////////////////////////////////////
+
+  // Configured before the slice is enabled, so that no wrap DREQ is counted before period 1
+  bool startDMA()
+  {
+    if (_dma_chan[0] < 0)
+    {
+      _dma_chan[0] = dma_claim_unused_channel(false);
+      _dma_chan[1] = dma_claim_unused_channel(false);
+
+      if ( (_dma_chan[0] < 0) || (_dma_chan[1] < 0) )
+      {
+        PWM_LOGERROR("Error, no free DMA channel");
+
+        // Claimed again by the next start()
+        for (uint8_t i = 0; i < 2; i++)
+        {
+          if (_dma_chan[i] >= 0)
+            dma_channel_unclaim(_dma_chan[i]);
+
+          _dma_chan[i] = -1;
+        }
+
+        return false;
+      }
+
+      PWM_Burst_DMA_instance[_slice_num] = this;
+      irq_add_shared_handler(DMA_IRQ_1, PWM_Burst_DMA_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+      irq_set_enabled(DMA_IRQ_1, true);
+    }
+
+    // Zero level on this channel, sibling level kept
+    _dmaZeroCC = PWM_slice_shadow_data[_slice_num].cc & (_chan ? ~PWM_CH0_CC_B_BITS : ~PWM_CH0_CC_A_BITS);
+
+    // Written by DMA, so the shadow is updated now
+    PWM_slice_shadow_data[_slice_num].cc = _dmaZeroCC;
+
+    // Channel 1 : N - 1 dummy transfers, one per wrap
+    dma_channel_config config = dma_channel_get_default_config(_dma_chan[0]);
+
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, DREQ_PWM_WRAP0 + _slice_num);
+    channel_config_set_chain_to(&config, _dma_chan[1]);
+
+    dma_channel_configure(_dma_chan[0], &config, &_dmaDummy, &_dmaDummy, _pulses - 1, false);
+
+    // Channel 2 : zero level at once, then IRQ
+    config = dma_channel_get_default_config(_dma_chan[1]);
+
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, DREQ_FORCE);
+
+    dma_channel_configure(_dma_chan[1], &config, &pwm_hw->slice[_slice_num].cc, &_dmaZeroCC, 1, false);
+
+    dma_hw->ints1 = 1u << _dma_chan[1];
+    dma_channel_set_irq1_enabled(_dma_chan[1], true);
+
+    dma_channel_start(_dma_chan[0]);
+
+    return true;
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+
+static void PWM_Burst_DMA_handler()
+{
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    RP2040_PWM_Burst* burst = PWM_Burst_DMA_instance[slice_num];
+
+    if ( burst && (burst->getDMAChannel() >= 0) && (dma_hw->ints1 & (1u << burst->getDMAChannel())) )
+    {
+      dma_hw->ints1 = 1u << burst->getDMAChannel();
+      burst->handleDMA();
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_BURST_H
@@ -0,0 +1,420 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Resource.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// Pin / slice resource allocator.
+// GPIO n drives slice (n >> 1) & 7, channel n & 1, so GP0 and GP16 are the same channel A of slice 0.
+// Compile-time checks for constant pins, a printout of the ownership kept by RP2040_PWM.h, and automatic
+// placement of a set of frequencies and channel counts, grouping the outputs with the same TOP / DIV /
+// phaseCorrect on the same slices, to use as many of the 16 channels as possible.
+
+#pragma once
+
+#ifndef RP2040_PWM_RESOURCE_H
+#define RP2040_PWM_RESOURCE_H
+
+#include <string.h>
+
+#include "RP2040_PWM.h"
+
+///////////////////////////////////////////////////////////////////
+
+// Channels of all slices
+#define PWM_RESOURCE_CHANNELS       (2 * NUM_PWM_SLICES)
+
+// All GPIOs usable for placement. Restrict it, e.g. to the header pins of the board
+#define PWM_RESOURCE_ALL_PINS       ( (1UL << NUM_PWM_PINS) - 1 )
+
+// No pin assigned
+#define PWM_RESOURCE_NO_PIN         0xFF
+
+///////////////////////////////////////////////////////////////////
+
+// Compile-time helpers, also usable at runtime
+
+constexpr bool PWM_pinValid(const uint8_t pin)
+{
+  return pin < NUM_PWM_PINS;
+}
+
+constexpr uint8_t PWM_pinSlice(const uint8_t pin)
+{
+  return (pin >> 1) & (NUM_PWM_SLICES - 1);
+}
+
+constexpr uint8_t PWM_pinChannel(const uint8_t pin)
+{
+  return pin & 1;
+}
+
+// 0-15 : slice * 2 + channel
+constexpr uint8_t PWM_pinResource(const uint8_t pin)
+{
+  return (PWM_pinSlice(pin) << 1) | PWM_pinChannel(pin);
+}
+
+// pinA and pinB as channel A and B of the same slice, as needed by setPWMPushPull()
+constexpr bool PWM_pinsPushPull(const uint8_t pinA, const uint8_t pinB)
+{
+  return PWM_pinValid(pinA) && PWM_pinValid(pinB) && (PWM_pinSlice(pinA) == PWM_pinSlice(pinB)) &&
+         (PWM_pinChannel(pinA) == 0) && (PWM_pinChannel(pinB) == 1);
+}
+
+constexpr bool PWM_pinFree(const uint8_t pin)
+{
+  return PWM_pinValid(pin);
+}
+
+// pin on another channel than all the others
+template<typename... Pins>
+constexpr bool PWM_pinFree(const uint8_t pin, const uint8_t other, const Pins... pins)
+{
+  return (PWM_pinResource(pin) != PWM_pinResource(other)) && PWM_pinFree(pin, pins...);
+}
+
+constexpr bool PWM_pinsUnique()
+{
+  return true;
+}
+
+// All pins valid and on different channels
+template<typename... Pins>
+constexpr bool PWM_pinsUnique(const uint8_t pin, const Pins... pins)
+{
+  return PWM_pinFree(pin, pins...) && PWM_pinsUnique(pins...);
+}
+
+// Use at file or function scope with constant pins, e.g. PWM_ASSERT_PINS_UNIQUE(pin0, pin1, pin16)
+#define PWM_ASSERT_PINS_UNIQUE(...)     static_assert(PWM_pinsUnique(__VA_ARGS__), \
+                                                      "PWM pins not valid or sharing the same slice channel")
+
+#define PWM_ASSERT_PUSHPULL(pinA, pinB) static_assert(PWM_pinsPushPull(pinA, pinB), \
+                                                      "PWM push-pull pins must be channel A and B of the same slice")
+
+///////////////////////////////////////////////////////////////////
+
+// One placement request : channels outputs at frequency
+typedef struct
+{
+  // In
+  float     frequency;
+  bool      phaseCorrect;
+  uint8_t   channels;
+  // Out, PWM_RESOURCE_NO_PIN after the last one
+  uint8_t   pins[PWM_RESOURCE_CHANNELS];
+  float     actualFreq;
+} PWM_Placement;
+
+///////////////////////////////////////////////////////////////////
+
+// GPIO of slice channel, among the 2 possible, free in pinMask. PWM_RESOURCE_NO_PIN if none
+inline uint8_t PWM_resourcePin(const uint& slice_num, const uint& chan, const uint32_t& pinMask)
+{
+  for (uint8_t pin = (slice_num << 1) | chan; pin < NUM_PWM_PINS; pin += PWM_RESOURCE_CHANNELS)
+  {
+    if (pinMask & (1UL << pin))
+      return pin;
+  }
+
+  return PWM_RESOURCE_NO_PIN;
+}
+
+////////////////////////////////////////
+
+// Assign pins to all requests, on free channels of pins in pinMask. Requests with the same TOP / DIV /
+// phaseCorrect share slices. With reserve, the channels are reserved so that only users with the same
+// TOP / DIV / phaseCorrect can claim them. All or nothing : return false and reserve nothing if not possible
+inline bool PWM_resourcePlace(PWM_Placement* requests, const uint8_t& count,
+                              const uint32_t& pinMask = PWM_RESOURCE_ALL_PINS, const bool& reserve = true)
+{
+#if defined(F_CPU)
+  uint32_t freq_CPU = F_CPU;
+#else
+  uint32_t freq_CPU = 125000000;
+#endif
+
+  // At most one request per channel
+  uint32_t  top[PWM_RESOURCE_CHANNELS];
+  uint32_t  div[PWM_RESOURCE_CHANNELS];
+  uint8_t   placed[PWM_RESOURCE_CHANNELS];
+  bool      done[PWM_RESOURCE_CHANNELS];
+
+  // Working copy of the slices : key of the request group using it, channels still free
+  int16_t   sliceKey[NUM_PWM_SLICES];
+  uint8_t   sliceFree[NUM_PWM_SLICES];
+  uint8_t   sliceNew[NUM_PWM_SLICES];
+
+  if ( (requests == NULL) || (count > PWM_RESOURCE_CHANNELS) )
+    return false;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if ( (requests[i].frequency > ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000)) ||
+         !PWM_calc_TOP_and_DIV(freq_CPU, requests[i].frequency, requests[i].phaseCorrect, top[i], div[i],
+                               requests[i].actualFreq) )
+    {
+      PWM_LOGERROR1("Error, placement frequency out of range =", requests[i].frequency);
+
+      return false;
+    }
+
+    memset(requests[i].pins, PWM_RESOURCE_NO_PIN, sizeof(requests[i].pins));
+
+    placed[i] = 0;
+    done[i]   = false;
+  }
+
+  // -1 : slice unused. -2 : used by other users with another TOP / DIV. Else the first request of the group
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    PWM_slice_resource* resource = &PWM_resourceData()[slice_num];
+
+    sliceKey[slice_num]   = -1;
+    sliceFree[slice_num]  = 0;
+    sliceNew[slice_num]   = 0;
+
+    for (uint chan = 0; chan < 2; chan++)
+    {
+      bool taken = resource->exclusive || resource->owner[chan] || (resource->reserved & (1 << chan));
+
+      if (taken)
+        sliceKey[slice_num] = -2;
+      else if (PWM_resourcePin(slice_num, chan, pinMask) != PWM_RESOURCE_NO_PIN)
+        sliceFree[slice_num] |= 1 << chan;
+    }
+
+    // A group with the same configuration can still use the free channel
+    if ( (sliceKey[slice_num] == -2) && !resource->exclusive )
+    {
+      for (uint8_t i = 0; i < count; i++)
+      {
+        if ( (top[i] == resource->top) && (div[i] == resource->div) && (requests[i].phaseCorrect == resource->phaseCorrect) )
+        {
+          sliceKey[slice_num] = i;
+          break;
+        }
+      }
+    }
+  }
+
+  // Groups of requests with the same configuration, largest group first
+  while (true)
+  {
+    int16_t   group     = -1;
+    uint16_t  groupSize = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+      if (done[i])
+        continue;
+
+      uint16_t size = 0;
+
+      for (uint8_t j = i; j < count; j++)
+      {
+        if ( (top[j] == top[i]) && (div[j] == div[i]) && (requests[j].phaseCorrect == requests[i].phaseCorrect) )
+          size += requests[j].channels;
+      }
+
+      if ( (group < 0) || (size > groupSize) )
+      {
+        group     = i;
+        groupSize = size;
+      }
+    }
+
+    if (group < 0)
+      break;
+
+    // Key of a slice is the first request of its group, as for the slices already used
+    int16_t key = group;
+
+    for (uint8_t i = 0; i < group; i++)
+    {
+      if ( (top[i] == top[group]) && (div[i] == div[group]) && (requests[i].phaseCorrect == requests[group].phaseCorrect) )
+      {
+        key = i;
+        break;
+      }
+    }
+
+    uint8_t req = group;
+
+    while (groupSize > 0)
+    {
+      // Partly used slice of the group, then a single free channel if only one is needed, then a whole slice
+      int16_t best      = -1;
+      uint8_t bestRank  = 0;
+
+      for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+      {
+        if (!sliceFree[slice_num] || ( (sliceKey[slice_num] != -1) && (sliceKey[slice_num] != key) ) )
+          continue;
+
+        uint8_t channels  = (sliceFree[slice_num] == 3) ? 2 : 1;
+        uint8_t rank;
+
+        if (sliceKey[slice_num] == key)
+          rank = 3;
+        else if (channels == 1)
+          rank = (groupSize == 1) ? 2 : 0;
+        else
+          rank = 1;
+
+        if ( (best < 0) || (rank > bestRank) )
+        {
+          best      = slice_num;
+          bestRank  = rank;
+        }
+      }
+
+      if (best < 0)
+      {
+        PWM_LOGERROR3("Error, not enough PWM channels for frequency =", requests[group].frequency, ", missing =", groupSize);
+
+        return false;
+      }
+
+      sliceKey[best] = key;
+
+      for (uint chan = 0; (chan < 2) && (groupSize > 0); chan++)
+      {
+        if ( !(sliceFree[best] & (1 << chan)) )
+          continue;
+
+        // Next request of the group still needing channels
+        while ( done[req] || (placed[req] >= requests[req].channels) || (top[req] != top[group]) ||
+                (div[req] != div[group]) || (requests[req].phaseCorrect != requests[group].phaseCorrect) )
+        {
+          req++;
+        }
+
+        requests[req].pins[placed[req]++] = PWM_resourcePin(best, chan, pinMask);
+
+        sliceFree[best] &= ~(1 << chan);
+        sliceNew[best]  |= 1 << chan;
+        groupSize--;
+      }
+    }
+
+    for (uint8_t i = group; i < count; i++)
+    {
+      if ( (top[i] == top[group]) && (div[i] == div[group]) && (requests[i].phaseCorrect == requests[group].phaseCorrect) )
+        done[i] = true;
+    }
+  }
+
+  if (reserve)
+  {
+    for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+    {
+      if (sliceNew[slice_num])
+      {
+        PWM_slice_resource* resource = &PWM_resourceData()[slice_num];
+        uint8_t key = sliceKey[slice_num];
+
+        resource->reserved     |= sliceNew[slice_num];
+        resource->top           = top[key];
+        resource->div           = div[key];
+        resource->phaseCorrect  = requests[key].phaseCorrect;
+      }
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+// Release the reservations of PWM_resourcePlace() not yet claimed
+inline void PWM_resourceUnreserveAll()
+{
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+    PWM_resourceData()[slice_num].reserved = 0;
+}
+
+////////////////////////////////////////
+
+// One line per slice : owner or reservation of each channel, and TOP / DIV / phaseCorrect
+inline void PWM_resourcePrint(Print& out = PWM_DBG_PORT)
+{
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    PWM_slice_resource* resource = &PWM_resourceData()[slice_num];
+
+    out.print(F("Slice "));
+    out.print(slice_num);
+
+    for (uint chan = 0; chan < 2; chan++)
+    {
+      out.print(chan ? F(", B (GP") : F(" : A (GP"));
+      out.print( (slice_num << 1) | chan);
+
+      if ( ( (slice_num << 1) | chan) + PWM_RESOURCE_CHANNELS < NUM_PWM_PINS)
+      {
+        out.print(F("/GP"));
+        out.print( ( (slice_num << 1) | chan) + PWM_RESOURCE_CHANNELS);
+      }
+
+      out.print(F(") = "));
+
+      if (resource->owner[chan])
+      {
+        out.print(F("0x"));
+        out.print( (uint32_t) (uintptr_t) resource->owner[chan], HEX);
+      }
+      else
+      {
+        out.print( (resource->reserved & (1 << chan)) ? F("reserved") : F("free") );
+      }
+    }
+
+    if (resource->exclusive)
+    {
+      out.println(F(", exclusive"));
+    }
+    else if (resource->owner[0] || resource->owner[1] || resource->reserved)
+    {
+      out.print(F(", TOP = "));
+      out.print(resource->top);
+      out.print(F(", DIV = "));
+      out.print(resource->div);
+      out.println(resource->phaseCorrect ? F(", phaseCorrect") : F(""));
+    }
+    else
+    {
+      out.println();
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_RESOURCE_H
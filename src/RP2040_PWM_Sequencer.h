@@ -0,0 +1,625 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Sequencer.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// Sequencer for timed multi-channel PWM scripts.
+// A script is a packed table of 8-byte ops (time delta, opcode, channel, value), with loop and jump opcodes,
+// run from a hardware alarm at exact timestamps without the main loop. All ops of the same timestamp
+// are staged in the register shadow, then flushed once, so both channels of a slice share one CC write.
+// TOP and CC are latched by the hardware at the next wrap, but DIV is not. So a new DIV of a running slice is
+// written from PWM_IRQ_WRAP after the wrap latching TOP and CC. Only the first counts of the new period, for the IRQ
+// latency, still run at the old DIV, instead of whole periods of the new TOP with the old DIV.
+// execute() is independent of the alarm, to be also used to replay or benchmark a script.
+
+#pragma once
+
+#ifndef RP2040_PWM_SEQUENCER_H
+#define RP2040_PWM_SEQUENCER_H
+
+#include "RP2040_PWM.h"
+#include "PWM_Wrap_IRQ.h"
+
+#include "hardware/gpio.h"
+#include "hardware/timer.h"
+
+///////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+  // Set raw CC level of channel, value = level
+  PWM_SEQ_LEVEL   = 0,
+  // Set dutycycle of channel, value from 0-100,000 for 0%-100%
+  PWM_SEQ_DUTY    = 1,
+  // Set frequency of the slice of channel in Hz, levels rescaled to keep the dutycycles. Applied at the next wrap
+  PWM_SEQ_FREQ    = 2,
+  // Enable / disable the slice of channel
+  PWM_SEQ_ENABLE  = 3,
+  PWM_SEQ_DISABLE = 4,
+  // Only wait for delta
+  PWM_SEQ_WAIT    = 5,
+  // Jump back to op index (value & 0xFFFF) for (value >> 16) more times, 0 = forever
+  PWM_SEQ_LOOP    = 6,
+  // Jump to op index value
+  PWM_SEQ_JUMP    = 7,
+  // End of script
+  PWM_SEQ_END     = 8
+} PWM_Seq_Opcode;
+
+typedef struct
+{
+  // Ticks to wait after the previous op, before executing this one
+  uint16_t  delta;
+  uint8_t   opcode;
+  // PWM channel = slice * 2 + (A = 0, B = 1)
+  uint8_t   channel;
+  uint32_t  value;
+} PWM_Seq_Op;
+
+// PWM channel of a GPIO, e.g. GP0 and GP16 are both channel 0 (slice 0, A)
+#define PWM_SEQ_CHANNEL(pin)                    ( (pin) & 0x0F )
+
+#define PWM_SEQ_OP_LEVEL(delta, pin, level)     { (delta), PWM_SEQ_LEVEL,   PWM_SEQ_CHANNEL(pin), (level) }
+#define PWM_SEQ_OP_DUTY(delta, pin, duty)       { (delta), PWM_SEQ_DUTY,    PWM_SEQ_CHANNEL(pin), (duty) }
+#define PWM_SEQ_OP_FREQ(delta, pin, freq)       { (delta), PWM_SEQ_FREQ,    PWM_SEQ_CHANNEL(pin), (freq) }
+#define PWM_SEQ_OP_ENABLE(delta, pin)           { (delta), PWM_SEQ_ENABLE,  PWM_SEQ_CHANNEL(pin), 0 }
+#define PWM_SEQ_OP_DISABLE(delta, pin)          { (delta), PWM_SEQ_DISABLE, PWM_SEQ_CHANNEL(pin), 0 }
+#define PWM_SEQ_OP_WAIT(delta)                  { (delta), PWM_SEQ_WAIT,    0, 0 }
+#define PWM_SEQ_OP_LOOP(delta, target, count)   { (delta), PWM_SEQ_LOOP,    0, ( ( (uint32_t) (count) ) << 16 ) | (target) }
+#define PWM_SEQ_OP_JUMP(delta, target)          { (delta), PWM_SEQ_JUMP,    0, (target) }
+#define PWM_SEQ_OP_END(delta)                   { (delta), PWM_SEQ_END,     0, 0 }
+
+// Returned by execute() at the end of script
+#define PWM_SEQ_STOPPED             0xFFFFFFFF
+
+#if !defined(PWM_SEQ_LOOP_DEPTH)
+  #define PWM_SEQ_LOOP_DEPTH        4
+#endif
+
+// Max ops run at the same timestamp, to catch an infinite loop of zero delta
+#if !defined(PWM_SEQ_MAX_BURST)
+  #define PWM_SEQ_MAX_BURST         256
+#endif
+
+#define PWM_SEQ_NUM_ALARMS          4
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Sequencer;
+
+static RP2040_PWM_Sequencer* PWM_Sequencer_instance[PWM_SEQ_NUM_ALARMS] = { NULL, NULL, NULL, NULL };
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Sequencer
+{
+  public:
+
+  // tick_us = time unit of op delta, default 1ms
+  RP2040_PWM_Sequencer(const uint32_t& tick_us = 1000)
+  {
+#if defined(F_CPU)
+    freq_CPU = F_CPU;
+#else
+    freq_CPU = 125000000;
+#endif
+
+    _tick_us  = tick_us;
+    _ops      = NULL;
+    _numOps   = 0;
+    _alarm      = -1;
+    _running    = false;
+    _pendingDiv = 0;
+
+    reset();
+  }
+
+  ///////////////////////////////////////////
+
+  ~RP2040_PWM_Sequencer()
+  {
+    end();
+  }
+
+  ///////////////////////////////////////////
+
+  // Switch the GPIO to PWM function, to be done for every pin used in the script.
+  // The script may change the frequency of the slice, so the whole slice is claimed
+  bool attachPin(const uint8_t& pin)
+  {
+    if (!PWM_resourceCheck(PWM_resourceClaimSlice(pwm_gpio_to_slice_num(pin), this), pin))
+      return false;
+
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  bool load(const PWM_Seq_Op* ops, const uint16_t& numOps)
+  {
+    if ( (ops == NULL) || (numOps == 0) )
+      return false;
+
+    // A target out of the script would run whatever is after it
+    for (uint16_t i = 0; i < numOps; i++)
+    {
+      if ( ( (ops[i].opcode == PWM_SEQ_JUMP) && (ops[i].value >= numOps) ) ||
+           ( (ops[i].opcode == PWM_SEQ_LOOP) && ( (ops[i].value & 0xFFFF) >= numOps) ) )
+      {
+        PWM_LOGERROR1("Error, jump target out of script, op =", i);
+
+        return false;
+      }
+    }
+
+    stop();
+
+    _ops    = ops;
+    _numOps = numOps;
+
+    reset();
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Back to the first op, loop counters cleared
+  void reset()
+  {
+    _pc         = 0;
+    _loopDepth  = 0;
+    _opCount    = 0;
+    _touched    = 0;
+  }
+
+  ///////////////////////////////////////////
+
+  bool start()
+  {
+    if (_ops == NULL)
+      return false;
+
+    stop();
+
+    if (_alarm < 0)
+    {
+      _alarm = hardware_alarm_claim_unused(false);
+
+      if (_alarm < 0)
+      {
+        PWM_LOGERROR("Error, no free hardware alarm");
+
+        return false;
+      }
+
+      PWM_Sequencer_instance[_alarm] = this;
+      hardware_alarm_set_callback(_alarm, RP2040_PWM_Sequencer::alarmHandler);
+    }
+
+    reset();
+
+    _running  = true;
+    _target   = time_us_64();
+
+    schedule(_ops[0].delta);
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  void stop()
+  {
+    if (_alarm >= 0)
+      hardware_alarm_cancel(_alarm);
+
+    _running = false;
+  }
+
+  ///////////////////////////////////////////
+
+  // Stop, and release the hardware alarm and the slices claimed by attachPin(). DIV still waiting for a wrap written now
+  void end()
+  {
+    stop();
+
+    if (_alarm >= 0)
+    {
+      hardware_alarm_set_callback(_alarm, NULL);
+      hardware_alarm_unclaim(_alarm);
+
+      PWM_Sequencer_instance[_alarm] = NULL;
+      _alarm = -1;
+    }
+
+    for (uint slice_num = 0; _pendingDiv; slice_num++)
+    {
+      if (_pendingDiv & (1 << slice_num))
+      {
+        PWM_detachWrapInterrupt(slice_num);
+        pwm_hw->slice[slice_num].div = PWM_slice_shadow_data[slice_num].div;
+
+        _pendingDiv &= ~(1 << slice_num);
+      }
+    }
+
+    PWM_resourceReleaseAll(this);
+  }
+
+  ///////////////////////////////////////////
+
+  inline bool isRunning()
+  {
+    return _running;
+  }
+
+  ///////////////////////////////////////////
+
+  // Index of the next op to execute
+  inline uint16_t getPC()
+  {
+    return _pc;
+  }
+
+  ///////////////////////////////////////////
+
+  // Number of ops executed since reset()
+  inline uint32_t getOpCount()
+  {
+    return _opCount;
+  }
+
+  ///////////////////////////////////////////
+
+  // Execute the op at PC (its delta is considered elapsed), then all following ops of zero delta.
+  // Return the delta in ticks before the next op, or PWM_SEQ_STOPPED
+  uint32_t execute()
+  {
+    if ( (_ops == NULL) || (_pc >= _numOps) )
+      return PWM_SEQ_STOPPED;
+
+    uint32_t burst = 0;
+
+    do
+    {
+      if (!executeOp(_ops[_pc]))
+      {
+        flush();
+
+        return PWM_SEQ_STOPPED;
+      }
+
+      _opCount++;
+
+      if (_pc >= _numOps)
+      {
+        flush();
+
+        return PWM_SEQ_STOPPED;
+      }
+
+      if (++burst >= PWM_SEQ_MAX_BURST)
+      {
+        PWM_LOGERROR1("Error, too many ops at the same time, PC =", _pc);
+
+        flush();
+
+        return PWM_SEQ_STOPPED;
+      }
+    } while (_ops[_pc].delta == 0);
+
+    // All ops of the same timestamp written together
+    flush();
+
+    return _ops[_pc].delta;
+  }
+
+  ///////////////////////////////////////////
+
+  // From hardware alarm IRQ
+  void handleAlarm()
+  {
+    uint32_t delta = execute();
+
+    if (delta == PWM_SEQ_STOPPED)
+    {
+      _running = false;
+
+      return;
+    }
+
+    schedule(delta);
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  uint32_t          freq_CPU;
+  uint32_t          _tick_us;
+  uint64_t          _target;
+
+  const PWM_Seq_Op* _ops;
+  uint16_t          _numOps;
+  volatile uint16_t _pc;
+  volatile uint32_t _opCount;
+
+  struct
+  {
+    uint16_t pc;
+    uint16_t remaining;
+  } _loops[PWM_SEQ_LOOP_DEPTH];
+
+  uint8_t           _loopDepth;
+
+  // Slices changed at this timestamp, to be flushed
+  uint8_t           _touched;
+
+  // Running slices with a new DIV, to be written at the next wrap
+  volatile uint8_t  _pendingDiv;
+
+  int               _alarm;
+  volatile bool     _running;
+
+  ///////////////////////////////////////////
+
+  static void alarmHandler(uint alarm_num)
+  {
+    if ( (alarm_num < PWM_SEQ_NUM_ALARMS) && PWM_Sequencer_instance[alarm_num] )
+      PWM_Sequencer_instance[alarm_num]->handleAlarm();
+  }
+
+  ///////////////////////////////////////////
+
+  // At the wrap latching the new TOP and CC, the new DIV can be written
+  static void wrapHandler(const uint& slice_num, void* param)
+  {
+    RP2040_PWM_Sequencer* sequencer = (RP2040_PWM_Sequencer*) param;
+
+    pwm_hw->slice[slice_num].div = PWM_slice_shadow_data[slice_num].div;
+
+    PWM_detachWrapInterrupt(slice_num);
+    sequencer->_pendingDiv &= ~(1 << slice_num);
+  }
+
+  ///////////////////////////////////////////
+
+  // Absolute timestamps, so that the delays never drift. A missed target is run at once
+  void schedule(uint32_t delta)
+  {
+    while (_running)
+    {
+      _target += (uint64_t) delta * _tick_us;
+
+      absolute_time_t target;
+      update_us_since_boot(&target, _target);
+
+      if (!hardware_alarm_set_target(_alarm, target))
+        return;
+
+      delta = execute();
+
+      if (delta == PWM_SEQ_STOPPED)
+      {
+        _running = false;
+
+        return;
+      }
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  inline void flush()
+  {
+    for (uint slice_num = 0; _touched; slice_num++, _touched >>= 1)
+    {
+      if (_touched & 0x01)
+        flushSlice(slice_num);
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  void flushSlice(const uint& slice_num)
+  {
+    PWM_slice_shadow* shadow = &PWM_slice_shadow_data[slice_num];
+    uint8_t mask = 1 << slice_num;
+
+    // Running now and after this flush
+    bool running = (pwm_hw->slice[slice_num].csr & PWM_CH0_CSR_EN_BITS) && (shadow->csr & PWM_CH0_CSR_EN_BITS);
+
+    if (running && (shadow->dirty & PWM_SHADOW_DIV))
+    {
+      // Wrap flag cleared before TOP and CC are written, so the next wrap is the one latching them
+      shadow->dirty &= ~PWM_SHADOW_DIV;
+
+      if ( !(_pendingDiv & mask) )
+      {
+        _pendingDiv |= mask;
+        PWM_attachWrapInterrupt(slice_num, RP2040_PWM_Sequencer::wrapHandler, this);
+      }
+    }
+    else if (!running && (_pendingDiv & mask))
+    {
+      // Stopped, or disabled now : DIV written at once with the others
+      PWM_detachWrapInterrupt(slice_num);
+
+      _pendingDiv     &= ~mask;
+      shadow->dirty   |= PWM_SHADOW_DIV;
+    }
+
+    PWM_shadow_flush(slice_num);
+  }
+
+  ///////////////////////////////////////////
+
+  // Return false at PWM_SEQ_END
+  bool executeOp(const PWM_Seq_Op& op)
+  {
+    uint slice_num = (op.channel >> 1) & 0x07;
+    uint chan      = op.channel & 0x01;
+
+    switch (op.opcode)
+    {
+      case PWM_SEQ_LEVEL:
+        PWM_shadow_set_level(slice_num, chan, op.value);
+        _touched |= (1 << slice_num);
+        break;
+
+      case PWM_SEQ_DUTY:
+        // Same mapping as setPWM_Int()
+        PWM_shadow_set_level(slice_num, chan, ( getTOP(slice_num) * (op.value / 2) ) / 50000);
+        _touched |= (1 << slice_num);
+        break;
+
+      case PWM_SEQ_FREQ:
+        setFrequency(slice_num, op.value);
+        _touched |= (1 << slice_num);
+        break;
+
+      case PWM_SEQ_ENABLE:
+      case PWM_SEQ_DISABLE:
+        PWM_shadow_set_csr_bits(slice_num, PWM_CH0_CSR_EN_BITS, (op.opcode == PWM_SEQ_ENABLE));
+        _touched |= (1 << slice_num);
+        break;
+
+      case PWM_SEQ_WAIT:
+        break;
+
+      case PWM_SEQ_LOOP:
+        if (loop(op.value & 0xFFFF, op.value >> 16))
+          return true;
+
+        break;
+
+      case PWM_SEQ_JUMP:
+        _pc = op.value;
+        return true;
+
+      case PWM_SEQ_END:
+      default:
+        _pc = _numOps;
+        return false;
+    }
+
+    _pc++;
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Return true if jumping back to target
+  bool loop(const uint16_t& target, const uint16_t& count)
+  {
+    if (count == 0)
+    {
+      _pc = target;
+
+      return true;
+    }
+
+    if ( (_loopDepth > 0) && (_loops[_loopDepth - 1].pc == _pc) )
+    {
+      if (--_loops[_loopDepth - 1].remaining == 0)
+      {
+        _loopDepth--;
+
+        return false;
+      }
+    }
+    else
+    {
+      if (_loopDepth >= PWM_SEQ_LOOP_DEPTH)
+      {
+        PWM_LOGERROR1("Error, too many nested loops, PC =", _pc);
+
+        return false;
+      }
+
+      _loops[_loopDepth].pc        = _pc;
+      _loops[_loopDepth].remaining = count;
+      _loopDepth++;
+    }
+
+    _pc = target;
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getTOP(const uint& slice_num)
+  {
+    if (!PWM_slice_shadow_data[slice_num].loaded)
+      PWM_shadow_load(slice_num);
+
+    return PWM_slice_shadow_data[slice_num].top;
+  }
+
+  ///////////////////////////////////////////
+
+  // Integer only, using the hardware divider. Levels rescaled to keep the dutycycles
+  void setFrequency(const uint& slice_num, const uint32_t& freq)
+  {
+    if (freq == 0)
+      return;
+
+    bool phaseCorrect = PWM_slice_shadow_data[slice_num].csr & PWM_CH0_CSR_PH_CORRECT_BITS;
+    uint32_t ticks    = freq_CPU / freq / (phaseCorrect ? 2 : 1);
+    uint32_t div      = (ticks >> 16) + 1;
+
+    if ( (div > 255) || (ticks < 2) )
+    {
+      PWM_LOGERROR1("Error, invalid frequency =", freq);
+
+      return;
+    }
+
+    uint32_t oldTop = getTOP(slice_num);
+    uint32_t newTop = ticks / div - 1;
+    uint32_t cc     = PWM_slice_shadow_data[slice_num].cc;
+
+    uint32_t levelA = ( (cc & PWM_CH0_CC_A_BITS) >> PWM_CH0_CC_A_LSB ) * (newTop + 1) / (oldTop + 1);
+    uint32_t levelB = ( (cc & PWM_CH0_CC_B_BITS) >> PWM_CH0_CC_B_LSB ) * (newTop + 1) / (oldTop + 1);
+
+    PWM_shadow_set_div(slice_num, div << PWM_CH0_DIV_INT_LSB);
+    PWM_shadow_set_top(slice_num, newTop);
+    PWM_shadow_set_level(slice_num, PWM_CHAN_A, levelA);
+    PWM_shadow_set_level(slice_num, PWM_CHAN_B, levelB);
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_SEQUENCER_H
@@ -0,0 +1,308 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Snapshot.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// Compact snapshot of all slice configurations, to be stored in flash or as a const array,
+// and restored at boot straight into the registers, without float calculation.
+// All restored slices are started together by one write to pwm_hw->en.
+
+#pragma once
+
+#ifndef RP2040_PWM_SNAPSHOT_H
+#define RP2040_PWM_SNAPSHOT_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include "RP2040_PWM.h"
+
+#include "hardware/gpio.h"
+
+///////////////////////////////////////////////////////////////////
+
+#define PWM_SNAPSHOT_MAGIC        0x4D575053      // "SPWM"
+// 2 : manualMask in place of the reserved byte of version 1
+#define PWM_SNAPSHOT_VERSION      2
+
+#if !defined(NUM_PWM_GPIOS)
+  #define NUM_PWM_GPIOS           30
+#endif
+
+// CSR bits kept in the snapshot. EN is kept in enableMask
+#define PWM_SNAPSHOT_CSR_BITS     ( PWM_CH0_CSR_PH_CORRECT_BITS | PWM_CH0_CSR_A_INV_BITS | PWM_CH0_CSR_B_INV_BITS )
+
+typedef struct
+{
+  uint32_t cc;
+  uint16_t top;
+  uint16_t div;
+  uint8_t  csr;
+  uint8_t  reserved[3];
+} PWM_slice_config;
+
+typedef struct
+{
+  uint32_t          magic;
+  uint8_t           version;
+  // Slices stored in the snapshot
+  uint8_t           sliceMask;
+  // Slices to be enabled after restore
+  uint8_t           enableMask;
+  // Slices set by setPWM_manual(), so that setPWM_manual() with level only still works after restore
+  uint8_t           manualMask;
+  // GPIOs to be switched to PWM function
+  uint32_t          gpioMask;
+  PWM_slice_config  slice[NUM_PWM_SLICES];
+  uint32_t          checksum;
+} PWM_Snapshot;
+
+///////////////////////////////////////////////////////////////////
+
+// FNV-1a of all the bytes before checksum
+inline uint32_t PWM_snapshotChecksum(const PWM_Snapshot& snapshot)
+{
+  const uint8_t* data = (const uint8_t*) &snapshot;
+  uint32_t hash = 2166136261UL;
+
+  for (uint32_t i = 0; i < offsetof(PWM_Snapshot, checksum); i++)
+  {
+    hash ^= data[i];
+    hash *= 16777619UL;
+  }
+
+  return hash;
+}
+
+////////////////////////////////////////
+
+inline bool PWM_snapshotValid(const PWM_Snapshot& snapshot)
+{
+  return ( (snapshot.magic == PWM_SNAPSHOT_MAGIC) && (snapshot.version == PWM_SNAPSHOT_VERSION) &&
+           (snapshot.checksum == PWM_snapshotChecksum(snapshot)) );
+}
+
+////////////////////////////////////////
+
+// Build the snapshot from the slices used by PWM_slice_data[] / PWM_slice_manual_data[]
+// Registers are taken from the shadow, or read back if the slice was not written through it
+inline bool PWM_snapshotCapture(PWM_Snapshot& snapshot)
+{
+  memset(&snapshot, 0, sizeof(snapshot));
+
+  snapshot.magic    = PWM_SNAPSHOT_MAGIC;
+  snapshot.version  = PWM_SNAPSHOT_VERSION;
+
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    bool activeA = PWM_slice_data[slice_num].channelA_Active || PWM_slice_manual_data[slice_num].channelA_Active;
+    bool activeB = PWM_slice_data[slice_num].channelB_Active || PWM_slice_manual_data[slice_num].channelB_Active;
+
+    if (!activeA && !activeB)
+      continue;
+
+    if (!PWM_slice_shadow_data[slice_num].loaded)
+      PWM_shadow_load(slice_num);
+
+    PWM_slice_shadow* shadow = &PWM_slice_shadow_data[slice_num];
+    PWM_slice_config* config = &snapshot.slice[slice_num];
+
+    config->cc  = shadow->cc;
+    config->top = shadow->top;
+    config->div = shadow->div;
+    config->csr = shadow->csr & PWM_SNAPSHOT_CSR_BITS;
+
+    snapshot.sliceMask |= (1 << slice_num);
+
+    if (shadow->csr & PWM_CH0_CSR_EN_BITS)
+      snapshot.enableMask |= (1 << slice_num);
+
+    if (PWM_slice_manual_data[slice_num].initialized)
+      snapshot.manualMask |= (1 << slice_num);
+
+    // Each channel can be on 2 GPIOs, e.g. GP0 and GP16 for slice 0 channel A
+    for (uint pin = 2 * slice_num; pin < NUM_PWM_GPIOS; pin += 16)
+    {
+      if ( activeA && (gpio_get_function(pin) == GPIO_FUNC_PWM) )
+        snapshot.gpioMask |= (1UL << pin);
+
+      if ( activeB && (pin + 1 < NUM_PWM_GPIOS) && (gpio_get_function(pin + 1) == GPIO_FUNC_PWM) )
+        snapshot.gpioMask |= (1UL << (pin + 1));
+    }
+  }
+
+  snapshot.checksum = PWM_snapshotChecksum(snapshot);
+
+  PWM_LOGINFO7("Snapshot: slices =", snapshot.sliceMask, ", enabled =", snapshot.enableMask, ", manual =", snapshot.manualMask,
+               ", GPIOs =", snapshot.gpioMask);
+
+  return (snapshot.sliceMask != 0);
+}
+
+////////////////////////////////////////
+
+// Program all the slices from the snapshot, then start them together with one pwm_hw->en write
+inline bool PWM_snapshotRestore(const PWM_Snapshot& snapshot)
+{
+  if (!PWM_snapshotValid(snapshot))
+  {
+    PWM_LOGERROR("Error, invalid PWM snapshot");
+
+    return false;
+  }
+
+#if defined(F_CPU)
+  uint32_t freq_CPU = F_CPU;
+#else
+  uint32_t freq_CPU = 125000000;
+#endif
+
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    if ( !(snapshot.sliceMask & (1 << slice_num)) )
+      continue;
+
+    const PWM_slice_config* config = &snapshot.slice[slice_num];
+
+    // Stopped while programmed, started later by pwm_hw->en
+    pwm_hw->slice[slice_num].csr = config->csr;
+    pwm_hw->slice[slice_num].ctr = PWM_CH0_CTR_RESET;
+    pwm_hw->slice[slice_num].div = config->div;
+    pwm_hw->slice[slice_num].top = config->top;
+    pwm_hw->slice[slice_num].cc  = config->cc;
+
+    // Keep the shadow in sync, including EN written below
+    PWM_slice_shadow* shadow = &PWM_slice_shadow_data[slice_num];
+
+    shadow->csr    = config->csr | ( (snapshot.enableMask & (1 << slice_num)) ? PWM_CH0_CSR_EN_BITS : 0 );
+    shadow->div    = config->div;
+    shadow->top    = config->top;
+    shadow->cc     = config->cc;
+    shadow->dirty  = 0;
+    shadow->loaded = true;
+
+    // Update PWM_slice_data[] so that later setPWM() on the sibling channel keeps this one
+    float divider = (float) config->div / (1 << PWM_CH0_DIV_INT_LSB);
+
+    PWM_slice_data[slice_num].freq            = (float) freq_CPU / ( (config->top + 1) * divider *
+                                                ( (config->csr & PWM_CH0_CSR_PH_CORRECT_BITS) ? 2 : 1 ) );
+    PWM_slice_data[slice_num].channelA_div    = (config->cc & PWM_CH0_CC_A_BITS) >> PWM_CH0_CC_A_LSB;
+    PWM_slice_data[slice_num].channelB_div    = (config->cc & PWM_CH0_CC_B_BITS) >> PWM_CH0_CC_B_LSB;
+
+    // Same for PWM_slice_manual_data[], where setPWM_manual() with level only needs initialized
+    if (snapshot.manualMask & (1 << slice_num))
+    {
+      PWM_slice_manual_data[slice_num].channelA_div = (config->cc & PWM_CH0_CC_A_BITS) >> PWM_CH0_CC_A_LSB;
+      PWM_slice_manual_data[slice_num].channelB_div = (config->cc & PWM_CH0_CC_B_BITS) >> PWM_CH0_CC_B_LSB;
+      PWM_slice_manual_data[slice_num].initialized  = true;
+    }
+  }
+
+  for (uint pin = 0; pin < NUM_PWM_GPIOS; pin++)
+  {
+    if (snapshot.gpioMask & (1UL << pin))
+    {
+      uint slice_num = pwm_gpio_to_slice_num(pin);
+      bool manual    = snapshot.manualMask & (1 << slice_num);
+
+      if (pwm_gpio_to_channel(pin) == PWM_CHAN_A)
+      {
+        if (manual)
+          PWM_slice_manual_data[slice_num].channelA_Active = true;
+        else
+          PWM_slice_data[slice_num].channelA_Active = true;
+      }
+      else
+      {
+        if (manual)
+          PWM_slice_manual_data[slice_num].channelB_Active = true;
+        else
+          PWM_slice_data[slice_num].channelB_Active = true;
+      }
+    }
+  }
+
+  // One write starts all restored slices in phase, others unchanged
+  pwm_hw->en = (pwm_hw->en & ~( (uint32_t) snapshot.sliceMask) ) | snapshot.enableMask;
+
+  for (uint pin = 0; pin < NUM_PWM_GPIOS; pin++)
+  {
+    if (snapshot.gpioMask & (1UL << pin))
+      gpio_set_function(pin, GPIO_FUNC_PWM);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+// Print the snapshot as a C initializer, to be pasted as a const PWM_Snapshot in flash
+inline void PWM_snapshotPrint(const PWM_Snapshot& snapshot, Print& out = PWM_DBG_PORT)
+{
+  out.println(F("const PWM_Snapshot PWM_bootSnapshot ="));
+  out.println(F("{"));
+  out.print(F("  0x"));
+  out.print(snapshot.magic, HEX);
+  out.print(F(", "));
+  out.print(snapshot.version);
+  out.print(F(", 0x"));
+  out.print(snapshot.sliceMask, HEX);
+  out.print(F(", 0x"));
+  out.print(snapshot.enableMask, HEX);
+  out.print(F(", 0x"));
+  out.print(snapshot.manualMask, HEX);
+  out.print(F(", 0x"));
+  out.print(snapshot.gpioMask, HEX);
+  out.println(F(","));
+  out.println(F("  {"));
+
+  for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+  {
+    const PWM_slice_config* config = &snapshot.slice[slice_num];
+
+    out.print(F("    { 0x"));
+    out.print(config->cc, HEX);
+    out.print(F(", "));
+    out.print(config->top);
+    out.print(F(", 0x"));
+    out.print(config->div, HEX);
+    out.print(F(", 0x"));
+    out.print(config->csr, HEX);
+    out.println( (slice_num < NUM_PWM_SLICES - 1) ? F(", { 0, 0, 0 } },") : F(", { 0, 0, 0 } }") );
+  }
+
+  out.println(F("  },"));
+  out.print(F("  0x"));
+  out.println(snapshot.checksum, HEX);
+  out.println(F("};"));
+}
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_SNAPSHOT_H
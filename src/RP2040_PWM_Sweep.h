@@ -0,0 +1,404 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Sweep.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// Frequency sweep / chirp generator.
+// DIV is fixed for the whole sweep, so that only TOP and CC change. Both are double-buffered by the hardware :
+// values written during period k are latched at wrap k and used in period k + 1. Period 1 is written with the
+// slice stopped, period 2 at once after the start, then period k + 2 at every wrap k from PWM_IRQ_WRAP.
+// The frequency law is advanced by the real period produced, so the sweep duration stays exact.
+// Each period must be longer than the IRQ latency and handler time, so the highest frequency is limited
+// to PWM_SWEEP_MAX_FREQUENCY.
+
+#pragma once
+
+#ifndef RP2040_PWM_SWEEP_H
+#define RP2040_PWM_SWEEP_H
+
+#include "RP2040_PWM.h"
+#include "PWM_Wrap_IRQ.h"
+
+///////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+  // Frequency changes linearly with time
+  PWM_SWEEP_LINEAR  = 0,
+  // Frequency changes exponentially with time, same time per octave
+  PWM_SWEEP_LOG     = 1
+} PWM_Sweep_Mode;
+
+// Repeat the sweep forever
+#define PWM_SWEEP_FOREVER       0
+
+// Highest sweep frequency at 125MHz, scaled with F_CPU. The wrap handler must end before the next wrap
+#if !defined(PWM_SWEEP_MAX_FREQUENCY)
+  #define PWM_SWEEP_MAX_FREQUENCY     (100000.0f)
+#endif
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Sweep
+{
+  public:
+
+  RP2040_PWM_Sweep(const uint8_t& pin)
+  {
+#if defined(F_CPU)
+    freq_CPU = F_CPU;
+#else
+    freq_CPU = 125000000;
+#endif
+
+    _pin        = pin;
+    _slice_num  = pwm_gpio_to_slice_num(pin);
+    _tickFreq   = 0;
+    _running    = false;
+    _finished   = false;
+  }
+
+  ///////////////////////////////////////////
+
+  // dutycycle from 0-100,000 for 0%-100%, held constant over the sweep
+  // repeat = number of sweeps, PWM_SWEEP_FOREVER to repeat until stop()
+  bool setSweep_Int(const float& startFreq, const float& stopFreq, const float& duration_ms, const uint32_t& dutycycle,
+                    const PWM_Sweep_Mode& mode = PWM_SWEEP_LINEAR, const uint32_t& repeat = PWM_SWEEP_FOREVER,
+                    bool phaseCorrect = false)
+  {
+    float minFreq = (startFreq < stopFreq) ? startFreq : stopFreq;
+    float maxFreq = (startFreq < stopFreq) ? stopFreq : startFreq;
+
+    if ( (minFreq < ( (float) MIN_PWM_FREQUENCY * freq_CPU / 125000000) ) ||
+         (maxFreq > ( (float) MAX_PWM_FREQUENCY * freq_CPU / 125000000) ) || (duration_ms <= 0) || (dutycycle > 100000) )
+    {
+      PWM_LOGERROR3("Error, invalid sweep from", startFreq, "to", stopFreq);
+
+      return false;
+    }
+
+    if (maxFreq > ( (float) PWM_SWEEP_MAX_FREQUENCY * freq_CPU / 125000000) )
+    {
+      PWM_LOGERROR1("Error, sweep frequency too high for the wrap IRQ =", maxFreq);
+
+      return false;
+    }
+
+    // Smallest DIV keeping TOP of the lowest frequency inside 16 bits
+    float ticks = (float) freq_CPU / minFreq / (phaseCorrect ? 2 : 1);
+    uint32_t div = (uint32_t) ( ticks / 65536.0f ) + 1;
+
+    if (div > 255)
+    {
+      PWM_LOGERROR1("Error, sweep start/stop frequency too low =", minFreq);
+
+      return false;
+    }
+
+    _div          = div;
+    _phaseCorrect = phaseCorrect;
+    _dutycycle    = dutycycle;
+    _mode         = mode;
+    _repeat       = repeat;
+    _startFreq    = startFreq;
+    _stopFreq     = stopFreq;
+    _duration     = duration_ms / 1000.0f;
+
+    // Counter clock, and seconds per TOP count
+    _tickFreq     = (float) freq_CPU / _div;
+    _tickPeriod   = (phaseCorrect ? 2.0f : 1.0f) / _tickFreq;
+
+    if (mode == PWM_SWEEP_LOG)
+      _rate = logf(stopFreq / startFreq) / _duration;
+    else
+      _rate = (stopFreq - startFreq) / _duration;
+
+    PWM_LOGINFO5("Sweep: DIV =", _div, ", TOP from", calcTOP(startFreq), "to", calcTOP(stopFreq));
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  bool setSweep(const float& startFreq, const float& stopFreq, const float& duration_ms, const float& dutycycle,
+                const PWM_Sweep_Mode& mode = PWM_SWEEP_LINEAR, const uint32_t& repeat = PWM_SWEEP_FOREVER,
+                bool phaseCorrect = false)
+  {
+    return setSweep_Int(startFreq, stopFreq, duration_ms, dutycycle * 1000, mode, repeat, phaseCorrect);
+  }
+
+  ///////////////////////////////////////////
+
+  bool start()
+  {
+    if (_tickFreq <= 0)
+      return false;
+
+    stop();
+
+    // TOP changes at every period. Released by stop(), at the end of the sweeps
+    if (!PWM_resourceCheck(PWM_resourceClaimSlice(_slice_num, this), _slice_num))
+      return false;
+
+    _sweepCount   = 0;
+    _periodCount  = 0;
+    _finished     = false;
+
+    restartSweep();
+
+    // First period programmed directly, the slice then runs free
+    uint16_t top = calcTOP(_freq);
+
+    gpio_set_function(_pin, GPIO_FUNC_PWM);
+
+    PWM_shadow_set_div(_slice_num, _div << PWM_CH0_DIV_INT_LSB);
+    PWM_shadow_set_top(_slice_num, top);
+    PWM_shadow_set_level(_slice_num, pwm_gpio_to_channel(_pin), calcLevel(top));
+    PWM_shadow_set_csr(_slice_num, (_phaseCorrect ? PWM_CH0_CSR_PH_CORRECT_BITS : 0) | PWM_CH0_CSR_EN_BITS);
+
+    advance(top);
+
+    _running = true;
+
+    PWM_attachWrapInterrupt(_slice_num, RP2040_PWM_Sweep::wrapHandler, this);
+    PWM_shadow_flush(_slice_num, true);
+
+    // Period 2, latched at wrap 1
+    programNext();
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  void stop()
+  {
+    if (!_running)
+      return;
+
+    PWM_detachWrapInterrupt(_slice_num);
+
+    PWM_shadow_set_csr_bits(_slice_num, PWM_CH0_CSR_EN_BITS, false);
+    PWM_shadow_flush(_slice_num);
+
+    PWM_resourceReleaseAll(this);
+
+    _running = false;
+  }
+
+  ///////////////////////////////////////////
+
+  // All the sweeps done, the output is held low
+  inline bool isFinished()
+  {
+    return _finished;
+  }
+
+  ///////////////////////////////////////////
+
+  inline bool isRunning()
+  {
+    return _running;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getSweepCount()
+  {
+    return _sweepCount;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getPeriodCount()
+  {
+    return _periodCount;
+  }
+
+  ///////////////////////////////////////////
+
+  // Frequency of the period to be programmed at the next wrap
+  inline float getCurrentFreq()
+  {
+    return _freq;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t get_DIV()
+  {
+    return _div;
+  }
+
+  ///////////////////////////////////////////
+
+  // Called at every wrap k. The values written now are latched at wrap k + 1
+  void handleWrap()
+  {
+    if (_finished)
+    {
+      stop();
+
+      return;
+    }
+
+    programNext();
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  uint32_t        freq_CPU;
+
+  float           _startFreq;
+  float           _stopFreq;
+  float           _duration;
+  float           _rate;
+  float           _tickFreq;
+  float           _tickPeriod;
+
+  // Current state
+  float           _freq;
+  float           _elapsed;
+
+  uint32_t        _dutycycle;
+  uint32_t        _repeat;
+  volatile uint32_t _sweepCount;
+  volatile uint32_t _periodCount;
+
+  PWM_Sweep_Mode  _mode;
+  uint8_t         _div;
+  uint8_t         _pin;
+  uint8_t         _slice_num;
+  bool            _phaseCorrect;
+  bool            _sweepDone;
+  volatile bool   _running;
+  volatile bool   _finished;
+
+  ///////////////////////////////////////////
+
+  static void wrapHandler(const uint& slice_num, void* param)
+  {
+    (void) slice_num;
+
+    ( (RP2040_PWM_Sweep*) param)->handleWrap();
+  }
+
+  ///////////////////////////////////////////
+
+  // Write TOP and CC of the period after the current one
+  void programNext()
+  {
+    uint16_t top = calcTOP(_freq);
+
+    PWM_shadow_set_top(_slice_num, top);
+    PWM_shadow_set_level(_slice_num, pwm_gpio_to_channel(_pin), _sweepDone ? 0 : calcLevel(top));
+    PWM_shadow_flush(_slice_num);
+
+    if (_sweepDone)
+    {
+      // The zero level is latched at next wrap, then the slice is stopped
+      _finished = true;
+
+      return;
+    }
+
+    advance(top);
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint16_t calcTOP(const float& freq)
+  {
+    float top = ( _tickFreq / freq / (_phaseCorrect ? 2 : 1) ) - 1.0f + 0.5f;
+
+    return (top > 65535.0f) ? 65535 : (uint16_t) top;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint16_t calcLevel(const uint16_t& top)
+  {
+    // Same mapping as setPWM_Int()
+    return ( (uint32_t) top * (_dutycycle / 2) ) / 50000;
+  }
+
+  ///////////////////////////////////////////
+
+  inline void restartSweep()
+  {
+    _freq       = _startFreq;
+    _elapsed    = 0;
+    _sweepDone  = false;
+  }
+
+  ///////////////////////////////////////////
+
+  // Move the frequency law forward by the real period just programmed
+  void advance(const uint16_t& top)
+  {
+    float period = (top + 1) * _tickPeriod;
+
+    _periodCount++;
+    _elapsed += period;
+
+    if (_elapsed >= _duration)
+    {
+      _sweepCount++;
+
+      if ( (_repeat != PWM_SWEEP_FOREVER) && (_sweepCount >= _repeat) )
+      {
+        _sweepDone = true;
+
+        return;
+      }
+
+      restartSweep();
+
+      return;
+    }
+
+    if (_mode == PWM_SWEEP_LOG)
+    {
+      // f(t + T) = f(t) * exp(rate * T), with exp() to 3rd order as rate * T << 1
+      float x = _rate * period;
+
+      _freq *= 1.0f + x * (1.0f + x * (0.5f + x * (1.0f / 6)));
+    }
+    else
+    {
+      _freq += _rate * period;
+    }
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_SWEEP_H
@@ -0,0 +1,422 @@
+/****************************************************************************************************************************
+  RP2040_PWM_Verify.h
+  For RP2040 boards
+  Written by Khoi Hoang
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Version: 1.8.0
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K.Hoang      21/09/2021 Initial coding for RP2040 using ArduinoCore-mbed or arduino-pico core
+  1.0.1   K.Hoang      24/09/2021 Fix bug generating wrong frequency
+  1.0.2   K.Hoang      04/10/2021 Fix bug not changing frequency dynamically
+  1.0.3   K.Hoang      05/10/2021 Not reprogram if same PWM frequency. Add PIO strict `lib_compat_mode`
+  1.0.4   K Hoang      22/10/2021 Fix platform in library.json for PIO
+  1.0.5   K Hoang      06/01/2022 Permit changing dutyCycle and keep same frequency on-the-fly
+  1.1.0   K Hoang      24/02/2022 Permit PWM output for both channels of PWM slice. Use float instead of double
+  1.1.1   K Hoang      06/03/2022 Fix compiler warnings. Display informational warning when debug level > 3
+  1.2.0   K Hoang      16/04/2022 Add manual setPWM function to use in wafeform creation
+  1.3.0   K Hoang      16/04/2022 Add setPWM_Int function for optional uint32_t dutycycle = real_dutycycle * 1000
+  1.3.1   K Hoang      11/09/2022 Add minimal example `PWM_Basic`
+  1.4.0   K Hoang      15/10/2022 Fix glitch when changing dutycycle. Adjust MIN_PWM_FREQUENCY/MAX_PWM_FREQUENCY dynamically
+  1.4.1   K Hoang      21/01/2023 Add `PWM_StepperControl` example
+  1.5.0   K Hoang      24/01/2023 Add `PWM_manual` example and functions
+  1.6.0   K Hoang      26/01/2023 Optimize speed with new `setPWM_manual_Fast` function
+  1.7.0   K Hoang      31/01/2023 Add PushPull mode and related examples
+  1.8.0   K Hoang      19/10/2026 Add register shadow, operating-point cache, engines and host tests
+*****************************************************************************************************************************/
+
+// Output verification. The CSR, DIV, TOP and CC registers of the owned slices are read back and compared with
+// the register shadow, the intended state written by the library. A mismatch means another library or a stale
+// instance has reconfigured the slice. Mismatches are counted, reported by callback, and optionally repaired.
+// RP2040_PWM instances added by addInstance() are also checked against their own intended TOP, DIV, phaseCorrect and
+// level, both in the registers and in the shadow, to catch another instance silently overwriting the shared slice.
+// Slices are checked a few at a time, round-robin, so that a periodic pass has a bounded cost.
+
+#pragma once
+
+#ifndef RP2040_PWM_VERIFY_H
+#define RP2040_PWM_VERIFY_H
+
+#include "RP2040_PWM.h"
+
+#include "pico/time.h"
+
+///////////////////////////////////////////////////////////////////
+
+// Mismatch bits are the same as the shadow dirty bits : PWM_SHADOW_CSR, PWM_SHADOW_DIV, PWM_SHADOW_TOP, PWM_SHADOW_CC,
+// plus PWM_VERIFY_INSTANCE
+typedef void (*PWM_Verify_Callback)(const uint& slice_num, const uint8_t& mismatch);
+
+// Slices used by any channel in PWM_slice_data[] / PWM_slice_manual_data[]
+#define PWM_VERIFY_OWNED_SLICES     0
+
+// Mismatch bit of a register not as intended by an added instance, with the bit of the register
+#define PWM_VERIFY_INSTANCE         0x10
+
+#if !defined(PWM_VERIFY_MAX_INSTANCES)
+  #define PWM_VERIFY_MAX_INSTANCES  8
+#endif
+
+///////////////////////////////////////////////////////////////////
+
+class RP2040_PWM_Verify
+{
+  public:
+
+  // slicesPerPass = number of slices checked by each verify(), to bound the cost of a periodic pass
+  RP2040_PWM_Verify(const bool& repair = false, const uint8_t& slicesPerPass = 2)
+  {
+    _repair         = repair;
+    _slicesPerPass  = (slicesPerPass == 0) ? 1 : slicesPerPass;
+    _sliceMask      = PWM_VERIFY_OWNED_SLICES;
+    _nextSlice      = 0;
+    _callback       = NULL;
+    _timerRunning   = false;
+    _numInstances   = 0;
+
+    resetStats();
+  }
+
+  ///////////////////////////////////////////
+
+  // Slices to check. PWM_VERIFY_OWNED_SLICES to follow the slices used by the library.
+  // Exclude slices whose registers are changed by DMA, such as RP2040_PWM_Audio
+  inline void setSliceMask(const uint8_t& sliceMask)
+  {
+    _sliceMask = sliceMask;
+  }
+
+  ///////////////////////////////////////////
+
+  inline void setRepair(const bool& repair)
+  {
+    _repair = repair;
+  }
+
+  ///////////////////////////////////////////
+
+  // Called for every mismatching slice, from the context of verify()
+  inline void attachCallback(PWM_Verify_Callback callback)
+  {
+    _callback = callback;
+  }
+
+  ///////////////////////////////////////////
+
+  // Also check the slice of instance against its own TOP, DIV, phaseCorrect and level
+  bool addInstance(RP2040_PWM* instance)
+  {
+    if (instance == NULL)
+      return false;
+
+    for (uint8_t i = 0; i < _numInstances; i++)
+    {
+      if (_instances[i] == instance)
+        return true;
+    }
+
+    if (_numInstances >= PWM_VERIFY_MAX_INSTANCES)
+    {
+      PWM_LOGERROR1("Error, too many verified instances, max =", PWM_VERIFY_MAX_INSTANCES);
+
+      return false;
+    }
+
+    _instances[_numInstances++] = instance;
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  void removeInstance(RP2040_PWM* instance)
+  {
+    for (uint8_t i = 0; i < _numInstances; i++)
+    {
+      if (_instances[i] == instance)
+      {
+        _instances[i] = _instances[--_numInstances];
+
+        return;
+      }
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  // Check one slice. Return the mismatching registers, 0 if OK or not owned
+  uint8_t verifySlice(const uint& slice_num)
+  {
+    if ( (slice_num >= NUM_PWM_SLICES) || !(getSliceMask() & (1 << slice_num)) )
+      return 0;
+
+    PWM_slice_shadow* shadow = &PWM_slice_shadow_data[slice_num];
+
+    // Nothing intended yet, or intended values not yet flushed
+    if (!shadow->loaded || shadow->dirty)
+      return 0;
+
+    uint8_t mismatch = 0;
+
+    if (pwm_hw->slice[slice_num].csr != shadow->csr)
+      mismatch |= PWM_SHADOW_CSR;
+
+    if (pwm_hw->slice[slice_num].div != shadow->div)
+      mismatch |= PWM_SHADOW_DIV;
+
+    if (pwm_hw->slice[slice_num].top != shadow->top)
+      mismatch |= PWM_SHADOW_TOP;
+
+    if (pwm_hw->slice[slice_num].cc != shadow->cc)
+      mismatch |= PWM_SHADOW_CC;
+
+    // Bits of the added instances on this slice, in the registers and in the shadow
+    PWM_slice_regs mask;
+    PWM_slice_regs value;
+    PWM_slice_regs intendedMask  = { 0, 0, 0, 0 };
+    PWM_slice_regs intendedValue = { 0, 0, 0, 0 };
+
+    for (uint8_t i = 0; i < _numInstances; i++)
+    {
+      if ( (pwm_gpio_to_slice_num(_instances[i]->getPin()) != slice_num) || !_instances[i]->getIntendedRegs(mask, value) )
+        continue;
+
+      mismatch |= compareIntended(pwm_hw->slice[slice_num].csr, shadow->csr, mask.csr, value.csr, PWM_SHADOW_CSR);
+      mismatch |= compareIntended(pwm_hw->slice[slice_num].div, shadow->div, mask.div, value.div, PWM_SHADOW_DIV);
+      mismatch |= compareIntended(pwm_hw->slice[slice_num].top, shadow->top, mask.top, value.top, PWM_SHADOW_TOP);
+      mismatch |= compareIntended(pwm_hw->slice[slice_num].cc,  shadow->cc,  mask.cc,  value.cc,  PWM_SHADOW_CC);
+
+      // Later instances win on the same bits
+      mergeIntended(intendedMask.csr, intendedValue.csr, mask.csr, value.csr);
+      mergeIntended(intendedMask.div, intendedValue.div, mask.div, value.div);
+      mergeIntended(intendedMask.top, intendedValue.top, mask.top, value.top);
+      mergeIntended(intendedMask.cc,  intendedValue.cc,  mask.cc,  value.cc);
+    }
+
+    _checkCount++;
+
+    if (mismatch)
+    {
+      _mismatchCount++;
+      _lastMismatch   = mismatch;
+      _lastSlice      = slice_num;
+
+      if (_callback)
+        _callback(slice_num, mismatch);
+
+      if (_repair)
+      {
+        // Intended bits of the instances into the shadow, then rewrite only the wrong registers
+        shadow->csr   = (shadow->csr & ~intendedMask.csr) | intendedValue.csr;
+        shadow->div   = (shadow->div & ~intendedMask.div) | intendedValue.div;
+        shadow->top   = (shadow->top & ~intendedMask.top) | intendedValue.top;
+        shadow->cc    = (shadow->cc  & ~intendedMask.cc)  | intendedValue.cc;
+        shadow->dirty = mismatch & PWM_SHADOW_ALL;
+        PWM_shadow_flush(slice_num);
+
+        _repairCount++;
+      }
+    }
+
+    return mismatch;
+  }
+
+  ///////////////////////////////////////////
+
+  // Check the next slicesPerPass owned slices, round-robin. Return the mask of mismatching slices
+  uint8_t verify()
+  {
+    uint8_t sliceMask = getSliceMask();
+    uint8_t result    = 0;
+
+    if (sliceMask == 0)
+      return 0;
+
+    for (uint8_t checked = 0, tries = 0; (checked < _slicesPerPass) && (tries < NUM_PWM_SLICES); tries++)
+    {
+      uint slice_num = _nextSlice;
+
+      _nextSlice = (_nextSlice + 1) % NUM_PWM_SLICES;
+
+      if ( !(sliceMask & (1 << slice_num)) )
+        continue;
+
+      if (verifySlice(slice_num))
+        result |= (1 << slice_num);
+
+      checked++;
+    }
+
+    return result;
+  }
+
+  ///////////////////////////////////////////
+
+  // Check all owned slices at once
+  uint8_t verifyAll()
+  {
+    uint8_t result = 0;
+
+    for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+    {
+      if (verifySlice(slice_num))
+        result |= (1 << slice_num);
+    }
+
+    return result;
+  }
+
+  ///////////////////////////////////////////
+
+  // Run verify() every interval_ms from a repeating timer. Callback is then called from IRQ context
+  bool startTimer(const int32_t& interval_ms)
+  {
+    stopTimer();
+
+    _timerRunning = add_repeating_timer_ms(interval_ms, RP2040_PWM_Verify::timerHandler, this, &_timer);
+
+    if (!_timerRunning)
+    {
+      PWM_LOGERROR("Error, can't start verification timer");
+    }
+
+    return _timerRunning;
+  }
+
+  ///////////////////////////////////////////
+
+  void stopTimer()
+  {
+    if (_timerRunning)
+    {
+      cancel_repeating_timer(&_timer);
+      _timerRunning = false;
+    }
+  }
+
+  ///////////////////////////////////////////
+
+  inline void resetStats()
+  {
+    _checkCount     = 0;
+    _mismatchCount  = 0;
+    _repairCount    = 0;
+    _lastMismatch   = 0;
+    _lastSlice      = 0;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getCheckCount()
+  {
+    return _checkCount;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getMismatchCount()
+  {
+    return _mismatchCount;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint32_t getRepairCount()
+  {
+    return _repairCount;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint8_t getLastMismatch()
+  {
+    return _lastMismatch;
+  }
+
+  ///////////////////////////////////////////
+
+  inline uint8_t getLastSlice()
+  {
+    return _lastSlice;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+
+  private:
+
+  PWM_Verify_Callback _callback;
+  repeating_timer_t   _timer;
+
+  volatile uint32_t   _checkCount;
+  volatile uint32_t   _mismatchCount;
+  volatile uint32_t   _repairCount;
+  volatile uint8_t    _lastMismatch;
+  volatile uint8_t    _lastSlice;
+
+  RP2040_PWM*         _instances[PWM_VERIFY_MAX_INSTANCES];
+  uint8_t             _numInstances;
+
+  uint8_t             _sliceMask;
+  uint8_t             _slicesPerPass;
+  uint8_t             _nextSlice;
+  bool                _repair;
+  bool                _timerRunning;
+
+  ///////////////////////////////////////////
+
+  static bool timerHandler(repeating_timer_t* timer)
+  {
+    ( (RP2040_PWM_Verify*) timer->user_data)->verify();
+
+    return true;
+  }
+
+  ///////////////////////////////////////////
+
+  // Register and shadow bits of mask must both be value
+  static inline uint8_t compareIntended(const uint32_t& reg, const uint32_t& shadow, const uint32_t& mask,
+                                        const uint32_t& value, const uint8_t& bit)
+  {
+    return ( ( (reg ^ value) | (shadow ^ value) ) & mask ) ? (bit | PWM_VERIFY_INSTANCE) : 0;
+  }
+
+  ///////////////////////////////////////////
+
+  static inline void mergeIntended(uint32_t& intendedMask, uint32_t& intendedValue, const uint32_t& mask, const uint32_t& value)
+  {
+    intendedMask  |= mask;
+    intendedValue  = (intendedValue & ~mask) | (value & mask);
+  }
+
+  ///////////////////////////////////////////
+
+  uint8_t getSliceMask()
+  {
+    if (_sliceMask != PWM_VERIFY_OWNED_SLICES)
+      return _sliceMask;
+
+    uint8_t sliceMask = 0;
+
+    for (uint slice_num = 0; slice_num < NUM_PWM_SLICES; slice_num++)
+    {
+      if ( PWM_slice_data[slice_num].channelA_Active || PWM_slice_data[slice_num].channelB_Active ||
+           PWM_slice_manual_data[slice_num].channelA_Active || PWM_slice_manual_data[slice_num].channelB_Active )
+      {
+        sliceMask |= (1 << slice_num);
+      }
+    }
+
+    for (uint8_t i = 0; i < _numInstances; i++)
+      sliceMask |= (1 << pwm_gpio_to_slice_num(_instances[i]->getPin()));
+
+    return sliceMask;
+  }
+};
+
+///////////////////////////////////////////////////////////////////
+
+#endif    // RP2040_PWM_VERIFY_H
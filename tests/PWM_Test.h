@@ -0,0 +1,105 @@
+/****************************************************************************************************************************
+  PWM_Test.h
+  Minimal check macros and helpers of the host tests of RP2040_PWM
+  To include after the library headers under test
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef PWM_TEST_H
+#define PWM_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+#include <chrono>
+
+static int PWM_test_checks   = 0;
+static int PWM_test_failures = 0;
+
+#define PWM_TEST_CHECK(cond)                                                                              \
+  do                                                                                                      \
+  {                                                                                                       \
+    PWM_test_checks++;                                                                                    \
+                                                                                                          \
+    if (!(cond))                                                                                          \
+    {                                                                                                     \
+      PWM_test_failures++;                                                                                \
+      printf("FAIL %s:%d : %s\n", __FILE__, __LINE__, #cond);                                             \
+    }                                                                                                     \
+  } while (0)
+
+#define PWM_TEST_EQUAL(actual, expected)                                                                  \
+  do                                                                                                      \
+  {                                                                                                       \
+    long long _actual   = (long long) (actual);                                                           \
+    long long _expected = (long long) (expected);                                                         \
+                                                                                                          \
+    PWM_test_checks++;                                                                                    \
+                                                                                                          \
+    if (_actual != _expected)                                                                             \
+    {                                                                                                     \
+      PWM_test_failures++;                                                                                \
+      printf("FAIL %s:%d : %s = %lld, expected %s = %lld\n", __FILE__, __LINE__, #actual, _actual,        \
+             #expected, _expected);                                                                       \
+    }                                                                                                     \
+  } while (0)
+
+#define PWM_TEST_NEAR(actual, expected, tolerance)                                                        \
+  do                                                                                                      \
+  {                                                                                                       \
+    double _actual   = (double) (actual);                                                                 \
+    double _expected = (double) (expected);                                                               \
+                                                                                                          \
+    PWM_test_checks++;                                                                                    \
+                                                                                                          \
+    if (fabs(_actual - _expected) > (tolerance))                                                          \
+    {                                                                                                     \
+      PWM_test_failures++;                                                                                \
+      printf("FAIL %s:%d : %s = %g, expected %s = %g +/- %g\n", __FILE__, __LINE__, #actual, _actual,     \
+             #expected, _expected, (double) (tolerance));                                                 \
+    }                                                                                                     \
+  } while (0)
+
+// Print the result, and return the exit code of the test
+inline int PWM_test_report(const char* name)
+{
+  printf("%s : %d checks, %d failures\n", name, PWM_test_checks, PWM_test_failures);
+
+  return PWM_test_failures ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Host time of count calls of function, in ns per call. For the benchmarks only, never checked
+template<typename Function> double PWM_test_host_ns(const uint32_t& count, Function function)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < count; i++)
+    function(i);
+
+  return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Period of slice_num, in system clock cycles
+inline double PWM_test_cycles(const PWM_SimPeriod& period)
+{
+  return (double) period.length / MOCK_SUBCYCLES;
+}
+
+// High time of channel chan in a period, in counts, as the comparator : counter < CC
+inline uint32_t PWM_test_high_counts(const PWM_SimPeriod& period, const uint& chan)
+{
+  uint32_t top   = period.top & 0xffff;
+  uint32_t level = chan ? (period.cc >> 16) : (period.cc & 0xffff);
+
+  if (level > top + 1)
+    level = top + 1;
+
+  return (period.csr & PWM_CH0_CSR_PH_CORRECT_BITS) ? 2 * level : level;
+}
+
+#endif    // PWM_TEST_H
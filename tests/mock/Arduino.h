@@ -0,0 +1,231 @@
+/****************************************************************************************************************************
+  Arduino.h
+  Host mock of the Arduino core API used by RP2040_PWM : Print, Serial, F(), millis(), micros(), delay()
+  Time is the simulated time of RP2040_Sim.h, delay() runs the simulation
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ARDUINO_MOCK_H
+#define ARDUINO_MOCK_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "RP2040_Sim.h"
+
+#define DEC     10
+#define HEX     16
+#define OCT     8
+#define BIN     2
+
+#define F(string_literal)     (string_literal)
+
+///////////////////////////////////////////////////////////////////
+
+class Print
+{
+  public:
+
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+      size_t n = 0;
+
+      while (size--)
+        n += write(*buffer++);
+
+      return n;
+    }
+
+    size_t write(const char* str)
+    {
+      return str ? write( (const uint8_t*) str, strlen(str) ) : 0;
+    }
+
+    ///////////////////////////////////////////
+
+    size_t print(const char* str)
+    {
+      return write(str);
+    }
+
+    size_t print(const std::string& str)
+    {
+      return write(str.c_str());
+    }
+
+    size_t print(char c)
+    {
+      return write( (uint8_t) c);
+    }
+
+    size_t print(unsigned char n, int base = DEC)
+    {
+      return printNumber(n, base);
+    }
+
+    size_t print(int n, int base = DEC)
+    {
+      return print( (long long) n, base);
+    }
+
+    size_t print(unsigned int n, int base = DEC)
+    {
+      return printNumber(n, base);
+    }
+
+    size_t print(long n, int base = DEC)
+    {
+      return print( (long long) n, base);
+    }
+
+    size_t print(unsigned long n, int base = DEC)
+    {
+      return printNumber(n, base);
+    }
+
+    size_t print(long long n, int base = DEC)
+    {
+      // As Arduino, only base 10 is signed
+      if ( (base == DEC) && (n < 0) )
+        return write('-') + printNumber( (unsigned long long) -n, base);
+
+      return printNumber( (unsigned long long) n, base);
+    }
+
+    size_t print(unsigned long long n, int base = DEC)
+    {
+      return printNumber(n, base);
+    }
+
+    size_t print(double number, int digits = 2)
+    {
+      char buffer[64];
+
+      snprintf(buffer, sizeof(buffer), "%.*f", digits, number);
+
+      return write(buffer);
+    }
+
+    ///////////////////////////////////////////
+
+    size_t println()
+    {
+      return write("\r\n");
+    }
+
+    template<typename T> size_t println(const T& value)
+    {
+      return print(value) + println();
+    }
+
+    template<typename T> size_t println(const T& value, int format)
+    {
+      return print(value, format) + println();
+    }
+
+  private:
+
+    size_t printNumber(unsigned long long n, int base)
+    {
+      char  buffer[8 * sizeof(n) + 1];
+      char* str = &buffer[sizeof(buffer) - 1];
+
+      *str = '\0';
+
+      if (base < 2)
+        base = 10;
+
+      do
+      {
+        char c = n % base;
+        n /= base;
+
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+      } while (n);
+
+      return write(str);
+    }
+};
+
+///////////////////////////////////////////////////////////////////
+
+// Written to stdout, unless muted
+class MockSerial : public Print
+{
+  public:
+
+    MockSerial() : muted(false) {}
+
+    void begin(unsigned long baud)
+    {
+      (void) baud;
+    }
+
+    operator bool() const
+    {
+      return true;
+    }
+
+    using Print::write;
+
+    size_t write(uint8_t c) override
+    {
+      if (!muted)
+        fputc(c, stdout);
+
+      return 1;
+    }
+
+    bool muted;
+};
+
+inline MockSerial Serial;
+
+// Captured into a string, e.g. to check a report
+class PrintString : public Print
+{
+  public:
+
+    using Print::write;
+
+    size_t write(uint8_t c) override
+    {
+      text += (char) c;
+
+      return 1;
+    }
+
+    std::string text;
+};
+
+///////////////////////////////////////////////////////////////////
+
+inline unsigned long micros()
+{
+  return (unsigned long) time_us_32();
+}
+
+inline unsigned long millis()
+{
+  return (unsigned long) (time_us_64() / 1000);
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+  mock_sim_run_us(us);
+}
+
+inline void delay(unsigned long ms)
+{
+  mock_sim_run_us( (uint64_t) ms * 1000);
+}
+
+#endif    // ARDUINO_MOCK_H
@@ -0,0 +1,1487 @@
+/****************************************************************************************************************************
+  RP2040_Sim.h
+  Host simulation of the RP2040 peripherals used by RP2040_PWM, behind mock pico-sdk headers
+
+  Built by Khoi Hoang https://github.com/khoih-prog/RP2040_PWM
+  Licensed under MIT license
+
+  Models, cycle by cycle of the system clock :
+  - PWM slices : TOP and CC double-buffered and latched at wrap, or immediately if the slice is stopped.
+    DIV applied at once. CSR.EN and the EN alias register. Wrap IRQ flags and DREQ
+  - DMA channels : DREQ pacing by PWM wrap, DMA timer, ADC FIFO or forced, chaining, ring, IRQ 0 / 1, abort
+  - ADC : one conversion of 96 ADC clocks for each START_ONCE, 4-sample FIFO with DREQ
+  - Timer : hardware alarms and repeating timers
+  - NVIC : shared handlers, with an optional latency from the IRQ flag to the handler
+
+  Time is counted in 1/16 of a system clock cycle, so that fractional DIV is exact.
+  Every write to a peripheral register goes through mock_reg, which counts it and applies its side effect.
+  The library headers are used unchanged, the same as with the real pico-sdk.
+*****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef RP2040_SIM_H
+#define RP2040_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+typedef unsigned int uint;
+
+///////////////////////////////////////////////////////////////////
+
+#if defined(F_CPU)
+  #define MOCK_SYS_CLK            F_CPU
+#else
+  #define MOCK_SYS_CLK            125000000
+#endif
+
+// Simulation time unit : 1/16 of a system clock cycle, the resolution of the fractional DIV
+#define MOCK_SUBCYCLES            16
+
+#define MOCK_SUBCYCLES_PER_US     ( (uint64_t) MOCK_SUBCYCLES * (MOCK_SYS_CLK / 1000000) )
+
+#define NUM_PWM_SLICES_HW         8
+#define NUM_DMA_CHANNELS          12
+#define NUM_DMA_TIMERS            4
+#define NUM_TIMERS                4
+#define NUM_BANK0_GPIOS           30
+#define NUM_IRQS                  32
+
+///////////////////////////////////////////////////////////////////
+
+class mock_reg;
+
+inline void mock_sim_written(mock_reg* reg, const uint32_t& previous);
+
+// 32-bit peripheral register. Each assignment is one bus write, seen by the simulation
+class mock_reg
+{
+  public:
+
+    mock_reg() : value(0) {}
+
+    operator uint32_t() const
+    {
+      return value;
+    }
+
+    mock_reg& operator=(const uint32_t& newValue)
+    {
+      uint32_t previous = value;
+
+      value = newValue;
+      mock_sim_written(this, previous);
+
+      return *this;
+    }
+
+    mock_reg& operator=(const mock_reg& reg)
+    {
+      return *this = reg.value;
+    }
+
+    mock_reg& operator|=(const uint32_t& bits)
+    {
+      return *this = value | bits;
+    }
+
+    mock_reg& operator&=(const uint32_t& bits)
+    {
+      return *this = value & bits;
+    }
+
+    mock_reg& operator^=(const uint32_t& bits)
+    {
+      return *this = value ^ bits;
+    }
+
+    mock_reg& operator+=(const uint32_t& delta)
+    {
+      return *this = value + delta;
+    }
+
+    mock_reg& operator-=(const uint32_t& delta)
+    {
+      return *this = value - delta;
+    }
+
+    // Raw content, read and written by the simulation without any side effect
+    uint32_t value;
+};
+
+typedef mock_reg io_rw_32;
+typedef mock_reg io_ro_32;
+typedef mock_reg io_wo_32;
+
+///////////////////////////////////////////////////////////////////
+
+// One read then one write, the same bus cost as the atomic XOR alias of pico-sdk
+inline void hw_write_masked(io_rw_32* addr, uint32_t values, uint32_t write_mask)
+{
+  *addr = ( (uint32_t) *addr & ~write_mask ) | (values & write_mask);
+}
+
+inline void hw_set_bits(io_rw_32* addr, uint32_t mask)
+{
+  *addr = (uint32_t) *addr | mask;
+}
+
+inline void hw_clear_bits(io_rw_32* addr, uint32_t mask)
+{
+  *addr = (uint32_t) *addr & ~mask;
+}
+
+///////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+  io_rw_32 csr;
+  io_rw_32 div;
+  io_rw_32 ctr;
+  io_rw_32 cc;
+  io_rw_32 top;
+} pwm_slice_hw_t;
+
+typedef struct
+{
+  pwm_slice_hw_t slice[NUM_PWM_SLICES_HW];
+  io_rw_32 en;
+  io_rw_32 intr;
+  io_rw_32 inte;
+  io_rw_32 intf;
+  io_ro_32 ints;
+} pwm_hw_t;
+
+typedef struct
+{
+  io_rw_32 read_addr;
+  io_rw_32 write_addr;
+  io_rw_32 transfer_count;
+  io_rw_32 ctrl_trig;
+} dma_channel_hw_t;
+
+typedef struct
+{
+  dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+  io_rw_32 intr;
+  io_rw_32 inte0;
+  io_rw_32 intf0;
+  io_rw_32 ints0;
+  io_rw_32 inte1;
+  io_rw_32 intf1;
+  io_rw_32 ints1;
+  io_rw_32 timer[NUM_DMA_TIMERS];
+  io_wo_32 multi_channel_trigger;
+  io_rw_32 abort;
+} dma_hw_t;
+
+typedef struct
+{
+  io_rw_32 cs;
+  io_ro_32 result;
+  io_rw_32 fcs;
+  io_ro_32 fifo;
+  io_rw_32 div;
+  io_ro_32 intr;
+  io_rw_32 inte;
+  io_rw_32 intf;
+  io_ro_32 ints;
+} adc_hw_t;
+
+inline pwm_hw_t mock_pwm_hw;
+inline dma_hw_t mock_dma_hw;
+inline adc_hw_t mock_adc_hw;
+
+#define pwm_hw    (&mock_pwm_hw)
+#define dma_hw    (&mock_dma_hw)
+#define adc_hw    (&mock_adc_hw)
+
+///////////////////////////////////////////////////////////////////
+
+#define PWM_CH0_CSR_EN_BITS             0x00000001u
+#define PWM_CH0_CSR_EN_LSB              0
+#define PWM_CH0_CSR_PH_CORRECT_BITS     0x00000002u
+#define PWM_CH0_CSR_PH_CORRECT_LSB      1
+#define PWM_CH0_CSR_A_INV_BITS          0x00000004u
+#define PWM_CH0_CSR_A_INV_LSB           2
+#define PWM_CH0_CSR_B_INV_BITS          0x00000008u
+#define PWM_CH0_CSR_B_INV_LSB           3
+#define PWM_CH0_CSR_DIVMODE_BITS        0x00000030u
+#define PWM_CH0_CSR_DIVMODE_LSB         4
+#define PWM_CH0_DIV_INT_BITS            0x00000ff0u
+#define PWM_CH0_DIV_INT_LSB             4
+#define PWM_CH0_DIV_FRAC_BITS           0x0000000fu
+#define PWM_CH0_DIV_FRAC_LSB            0
+#define PWM_CH0_CC_A_BITS               0x0000ffffu
+#define PWM_CH0_CC_A_LSB                0
+#define PWM_CH0_CC_B_BITS               0xffff0000u
+#define PWM_CH0_CC_B_LSB                16
+#define PWM_CH0_CTR_RESET               0x00000000u
+#define PWM_CH0_CC_RESET                0x00000000u
+#define PWM_CH0_TOP_RESET               0x0000ffffu
+#define PWM_CH0_TOP_BITS                0x0000ffffu
+#define PWM_CH0_TOP_LSB                 0
+
+#define ADC_CS_EN_BITS                  0x00000001u
+#define ADC_CS_TS_EN_BITS               0x00000002u
+#define ADC_CS_START_ONCE_BITS          0x00000004u
+#define ADC_CS_START_MANY_BITS          0x00000008u
+#define ADC_CS_READY_BITS               0x00000100u
+#define ADC_CS_AINSEL_BITS              0x00007000u
+#define ADC_CS_AINSEL_LSB               12
+
+#define ADC_FCS_EN_BITS                 0x00000001u
+#define ADC_FCS_SHIFT_BITS              0x00000002u
+#define ADC_FCS_ERR_BITS                0x00000004u
+#define ADC_FCS_DREQ_EN_BITS            0x00000008u
+#define ADC_FCS_EMPTY_BITS              0x00000100u
+#define ADC_FCS_FULL_BITS               0x00000200u
+#define ADC_FCS_OVER_BITS               0x00000800u
+#define ADC_FCS_LEVEL_LSB               16
+#define ADC_FCS_THRESH_LSB              24
+
+#define ADC_FIFO_DEPTH                  4
+
+// 96 ADC clocks at 48 MHz for one conversion
+#define MOCK_ADC_CONVERSION_US_X1000    2000
+
+#define DREQ_PWM_WRAP0                  24
+#define DREQ_ADC                        36
+#define DREQ_DMA_TIMER0                 0x3b
+#define DREQ_FORCE                      0x3f
+
+#define TIMER_IRQ_0                     0
+#define TIMER_IRQ_1                     1
+#define TIMER_IRQ_2                     2
+#define TIMER_IRQ_3                     3
+#define PWM_IRQ_WRAP                    4
+#define DMA_IRQ_0                       11
+#define DMA_IRQ_1                       12
+#define ADC_IRQ_FIFO                    22
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY    0x80
+
+///////////////////////////////////////////////////////////////////
+
+enum dma_channel_transfer_size
+{
+  DMA_SIZE_8  = 0,
+  DMA_SIZE_16 = 1,
+  DMA_SIZE_32 = 2
+};
+
+typedef struct
+{
+  enum dma_channel_transfer_size size;
+  bool  readIncrement;
+  bool  writeIncrement;
+  bool  ringWrite;
+  uint  ringBits;
+  uint  dreq;
+  uint  chainTo;
+  bool  enable;
+} dma_channel_config;
+
+typedef void (*irq_handler_t)();
+typedef void (*hardware_alarm_callback_t)(uint alarm_num);
+
+typedef struct
+{
+  uint64_t _private_us_since_boot;
+} absolute_time_t;
+
+struct repeating_timer;
+
+typedef bool (*repeating_timer_callback_t)(struct repeating_timer* rt);
+
+typedef struct repeating_timer
+{
+  int64_t                     delay_us;
+  repeating_timer_callback_t  callback;
+  void*                       user_data;
+} repeating_timer_t;
+
+///////////////////////////////////////////////////////////////////
+
+// One complete period of a slice, as output
+typedef struct
+{
+  // Start and length, in 1/MOCK_SUBCYCLES of system clock cycle
+  uint64_t start;
+  uint64_t length;
+  // Latched at the start of the period
+  uint32_t top;
+  uint32_t cc;
+  uint32_t csr;
+  // DIV at the start and at the end of the period, different if written while counting
+  uint32_t div;
+  uint32_t divEnd;
+  bool     divChanged;
+} PWM_SimPeriod;
+
+typedef struct
+{
+  bool      running;
+  // Active TOP / CC, latched from the registers
+  uint32_t  top;
+  uint32_t  cc;
+  // Counting state : counts done at segStart, since the start of the period
+  uint64_t  periodStart;
+  uint64_t  segStart;
+  double    counts;
+  uint32_t  divStart;
+  bool      divChanged;
+  uint32_t  wraps;
+  uint32_t  writes;
+  bool      trace;
+  std::vector<PWM_SimPeriod> periods;
+} mock_slice_state;
+
+typedef struct
+{
+  dma_channel_config  config;
+  uintptr_t           read;
+  uintptr_t           write;
+  uint32_t            reload;
+  uint32_t            count;
+  uint32_t            transfers;
+  bool                busy;
+  bool                claimed;
+} mock_dma_channel_state;
+
+typedef struct
+{
+  uint16_t  x;
+  uint16_t  y;
+  uint64_t  base;
+  uint64_t  ticks;
+  bool      claimed;
+} mock_dma_timer_state;
+
+typedef struct
+{
+  bool                        claimed;
+  bool                        armed;
+  uint64_t                    target;
+  hardware_alarm_callback_t   callback;
+} mock_alarm_state;
+
+typedef struct
+{
+  repeating_timer_t*  timer;
+  uint64_t            next;
+} mock_repeating_state;
+
+typedef struct
+{
+  std::vector<irq_handler_t>  handlers;
+  bool                        enabled;
+  bool                        pending;
+  uint64_t                    serviceAt;
+  uint32_t                    count;
+} mock_irq_state;
+
+// ADC input value for a conversion started at time (subcycles)
+typedef uint16_t (*mock_adc_source_t)(uint input, uint64_t time);
+
+typedef struct
+{
+  // Time, in 1/MOCK_SUBCYCLES of system clock cycle
+  uint64_t                now;
+  // Delay from an IRQ flag to its handler, same unit
+  uint64_t                irqLatency;
+  // time_us_xx() from the host clock, e.g. to measure the cost of a call
+  bool                    hostClock;
+  uint32_t                pwmWrites;
+  mock_slice_state        slice[NUM_PWM_SLICES_HW];
+
+  mock_dma_channel_state  dma[NUM_DMA_CHANNELS];
+  mock_dma_timer_state    dmaTimer[NUM_DMA_TIMERS];
+  uint32_t                dmaTransfers;
+
+  bool                    adcBusy;
+  uint64_t                adcStart;
+  uint64_t                adcDone;
+  std::deque<uint16_t>    adcFifo;
+  mock_adc_source_t       adcSource;
+  uint32_t                adcConversions;
+  bool                    adcTrace;
+  std::vector<uint64_t>   adcStarts;
+
+  mock_alarm_state                  alarm[NUM_TIMERS];
+  std::vector<mock_repeating_state> repeating;
+
+  mock_irq_state          irq[NUM_IRQS];
+  uint8_t                 gpioFunction[NUM_BANK0_GPIOS];
+} mock_sim_state;
+
+inline mock_sim_state mock_sim;
+
+///////////////////////////////////////////////////////////////////
+// Clocks
+///////////////////////////////////////////////////////////////////
+
+inline uint64_t mock_host_us()
+{
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  return (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline uint64_t time_us_64()
+{
+  if (mock_sim.hostClock)
+    return mock_host_us();
+
+  return mock_sim.now / MOCK_SUBCYCLES_PER_US;
+}
+
+inline uint32_t time_us_32()
+{
+  return (uint32_t) time_us_64();
+}
+
+inline uint64_t mock_sim_cycles()
+{
+  return mock_sim.now / MOCK_SUBCYCLES;
+}
+
+///////////////////////////////////////////////////////////////////
+// NVIC
+///////////////////////////////////////////////////////////////////
+
+inline bool mock_irq_asserted(const uint& num)
+{
+  switch (num)
+  {
+    case PWM_IRQ_WRAP:
+      return mock_pwm_hw.ints.value != 0;
+
+    case DMA_IRQ_0:
+      return mock_dma_hw.ints0.value != 0;
+
+    case DMA_IRQ_1:
+      return mock_dma_hw.ints1.value != 0;
+
+    default:
+      return false;
+  }
+}
+
+inline void mock_irq_raise(const uint& num)
+{
+  mock_irq_state* irq = &mock_sim.irq[num];
+
+  if (irq->enabled && !irq->pending)
+  {
+    irq->pending   = true;
+    irq->serviceAt = mock_sim.now + mock_sim.irqLatency;
+  }
+}
+
+inline void mock_irq_service(const uint& num)
+{
+  mock_irq_state* irq = &mock_sim.irq[num];
+
+  irq->pending = false;
+
+  if (!irq->enabled)
+    return;
+
+  irq->count++;
+
+  // Copy, as a handler may add or remove handlers
+  std::vector<irq_handler_t> handlers = irq->handlers;
+
+  for (size_t i = 0; i < handlers.size(); i++)
+    handlers[i]();
+
+  // Level sensitive : fires again while a flag is left set
+  if (mock_irq_asserted(num))
+    mock_irq_raise(num);
+}
+
+inline void irq_set_enabled(uint num, bool enabled)
+{
+  mock_sim.irq[num].enabled = enabled;
+
+  if (enabled && mock_irq_asserted(num))
+    mock_irq_raise(num);
+}
+
+inline bool irq_is_enabled(uint num)
+{
+  return mock_sim.irq[num].enabled;
+}
+
+inline void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+  (void) order_priority;
+
+  mock_sim.irq[num].handlers.push_back(handler);
+}
+
+inline void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+  mock_sim.irq[num].handlers.assign(1, handler);
+}
+
+inline void irq_remove_handler(uint num, irq_handler_t handler)
+{
+  std::vector<irq_handler_t>& handlers = mock_sim.irq[num].handlers;
+
+  for (size_t i = 0; i < handlers.size(); i++)
+  {
+    if (handlers[i] == handler)
+    {
+      handlers.erase(handlers.begin() + i);
+      break;
+    }
+  }
+}
+
+inline uint32_t save_and_disable_interrupts()
+{
+  return 0;
+}
+
+inline void restore_interrupts(uint32_t status)
+{
+  (void) status;
+}
+
+inline void tight_loop_contents() {}
+
+///////////////////////////////////////////////////////////////////
+// PWM slices
+///////////////////////////////////////////////////////////////////
+
+// DIV in 1/16 of cycle per count, INT = 0 being 256
+inline uint32_t mock_div16(const uint32_t& div)
+{
+  uint32_t integer = (div >> PWM_CH0_DIV_INT_LSB) & 0xff;
+
+  return ( (integer ? integer : 256) << 4 ) | (div & PWM_CH0_DIV_FRAC_BITS);
+}
+
+inline uint32_t mock_period_counts(const uint& slice_num)
+{
+  uint32_t counts = (mock_sim.slice[slice_num].top & 0xffff) + 1;
+
+  return (mock_pwm_hw.slice[slice_num].csr.value & PWM_CH0_CSR_PH_CORRECT_BITS) ? 2 * counts : counts;
+}
+
+inline uint64_t mock_next_wrap(const uint& slice_num)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+
+  double remaining = mock_period_counts(slice_num) - slice->counts;
+
+  if (remaining < 0)
+    remaining = 0;
+
+  return slice->segStart + (uint64_t) ceil(remaining * mock_div16(mock_pwm_hw.slice[slice_num].div.value) - 1e-6);
+}
+
+// Bring the counts up to now, with the DIV used since segStart
+inline void mock_slice_sync(const uint& slice_num, const uint32_t& div)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+
+  if (slice->running)
+    slice->counts += (double) (mock_sim.now - slice->segStart) / mock_div16(div);
+
+  slice->segStart = mock_sim.now;
+}
+
+inline void mock_slice_start(const uint& slice_num)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+  pwm_slice_hw_t*   hw    = &mock_pwm_hw.slice[slice_num];
+
+  if (slice->running)
+    return;
+
+  slice->running      = true;
+  slice->top          = hw->top.value;
+  slice->cc           = hw->cc.value;
+  slice->counts       = hw->ctr.value & 0xffff;
+  slice->segStart     = mock_sim.now;
+  slice->periodStart  = mock_sim.now - (uint64_t) (slice->counts * mock_div16(hw->div.value));
+  slice->divStart     = hw->div.value;
+  slice->divChanged   = false;
+}
+
+inline void mock_slice_stop(const uint& slice_num)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+
+  if (!slice->running)
+    return;
+
+  mock_slice_sync(slice_num, mock_pwm_hw.slice[slice_num].div.value);
+
+  uint32_t counts = (uint32_t) slice->counts;
+  uint32_t top    = slice->top & 0xffff;
+
+  // Down-counting half of a phase-correct period
+  if (counts > top)
+    counts = 2 * (top + 1) - counts;
+
+  mock_pwm_hw.slice[slice_num].ctr.value = counts & 0xffff;
+  slice->running = false;
+}
+
+inline void mock_pwm_update_ints()
+{
+  mock_pwm_hw.ints.value = (mock_pwm_hw.intr.value | mock_pwm_hw.intf.value) & mock_pwm_hw.inte.value;
+}
+
+inline void mock_dma_dreq(const uint& dreq);
+
+inline void mock_slice_wrap(const uint& slice_num)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+  pwm_slice_hw_t*   hw    = &mock_pwm_hw.slice[slice_num];
+
+  if (slice->trace)
+  {
+    PWM_SimPeriod period;
+
+    period.start      = slice->periodStart;
+    period.length     = mock_sim.now - slice->periodStart;
+    period.top        = slice->top;
+    period.cc         = slice->cc;
+    period.csr        = hw->csr.value;
+    period.div        = slice->divStart;
+    period.divEnd     = hw->div.value;
+    period.divChanged = slice->divChanged;
+
+    slice->periods.push_back(period);
+  }
+
+  // Double-buffered TOP and CC take effect at the wrap
+  slice->top          = hw->top.value;
+  slice->cc           = hw->cc.value;
+  slice->counts       = 0;
+  slice->periodStart  = mock_sim.now;
+  slice->segStart     = mock_sim.now;
+  slice->divStart     = hw->div.value;
+  slice->divChanged   = false;
+  slice->wraps++;
+
+  mock_pwm_hw.intr.value |= 1u << slice_num;
+  mock_pwm_update_ints();
+
+  if (mock_pwm_hw.ints.value & (1u << slice_num))
+    mock_irq_raise(PWM_IRQ_WRAP);
+
+  mock_dma_dreq(DREQ_PWM_WRAP0 + slice_num);
+}
+
+inline void mock_slice_written(const uint& slice_num, const uint& field, const uint32_t& previous)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+  pwm_slice_hw_t*   hw    = &mock_pwm_hw.slice[slice_num];
+
+  slice->writes++;
+
+  switch (field)
+  {
+    case 0:
+      // CSR
+      if ( (hw->csr.value ^ previous) & PWM_CH0_CSR_PH_CORRECT_BITS )
+        mock_slice_sync(slice_num, hw->div.value);
+
+      if (hw->csr.value & PWM_CH0_CSR_EN_BITS)
+      {
+        mock_pwm_hw.en.value |= 1u << slice_num;
+        mock_slice_start(slice_num);
+      }
+      else
+      {
+        mock_pwm_hw.en.value &= ~(1u << slice_num);
+        mock_slice_stop(slice_num);
+      }
+
+      break;
+
+    case 1:
+      // DIV, not double-buffered : the rest of the period counts at the new rate
+      if (slice->running)
+      {
+        mock_slice_sync(slice_num, previous);
+
+        if (hw->div.value != previous)
+          slice->divChanged = true;
+      }
+
+      break;
+
+    case 2:
+      // CTR
+      hw->ctr.value &= 0xffff;
+
+      if (slice->running)
+      {
+        slice->counts       = hw->ctr.value;
+        slice->segStart     = mock_sim.now;
+        slice->periodStart  = mock_sim.now - (uint64_t) (slice->counts * mock_div16(hw->div.value));
+      }
+
+      break;
+
+    case 3:
+      // CC
+      if (!slice->running)
+        slice->cc = hw->cc.value;
+
+      break;
+
+    case 4:
+      // TOP
+      hw->top.value &= 0xffff;
+
+      if (!slice->running)
+        slice->top = hw->top.value;
+
+      break;
+  }
+}
+
+inline void mock_pwm_written(mock_reg* reg, const uint32_t& previous)
+{
+  mock_sim.pwmWrites++;
+
+  size_t index = reg - &mock_pwm_hw.slice[0].csr;
+
+  if (index < 5 * NUM_PWM_SLICES_HW)
+  {
+    mock_slice_written(index / 5, index % 5, previous);
+  }
+  else if (reg == &mock_pwm_hw.en)
+  {
+    // Alias of all the CSR.EN bits, to start or stop slices together
+    uint32_t changed = (mock_pwm_hw.en.value ^ previous) & 0xff;
+
+    for (uint slice_num = 0; slice_num < NUM_PWM_SLICES_HW; slice_num++)
+    {
+      if (changed & (1u << slice_num))
+      {
+        if (mock_pwm_hw.en.value & (1u << slice_num))
+        {
+          mock_pwm_hw.slice[slice_num].csr.value |= PWM_CH0_CSR_EN_BITS;
+          mock_slice_start(slice_num);
+        }
+        else
+        {
+          mock_pwm_hw.slice[slice_num].csr.value &= ~PWM_CH0_CSR_EN_BITS;
+          mock_slice_stop(slice_num);
+        }
+      }
+    }
+
+    mock_pwm_hw.en.value &= 0xff;
+  }
+  else if (reg == &mock_pwm_hw.intr)
+  {
+    // Write 1 to clear
+    mock_pwm_hw.intr.value = previous & ~mock_pwm_hw.intr.value;
+    mock_pwm_update_ints();
+  }
+  else if (reg == &mock_pwm_hw.ints)
+  {
+    mock_pwm_hw.ints.value = previous;
+  }
+  else
+  {
+    mock_pwm_update_ints();
+
+    if (mock_pwm_hw.ints.value)
+      mock_irq_raise(PWM_IRQ_WRAP);
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+// DMA
+///////////////////////////////////////////////////////////////////
+
+inline void mock_dma_update_ints()
+{
+  mock_dma_hw.ints0.value = (mock_dma_hw.intr.value | mock_dma_hw.intf0.value) & mock_dma_hw.inte0.value;
+  mock_dma_hw.ints1.value = (mock_dma_hw.intr.value | mock_dma_hw.intf1.value) & mock_dma_hw.inte1.value;
+}
+
+inline void mock_dma_mirror(const uint& channel)
+{
+  mock_dma_channel_state* dma = &mock_sim.dma[channel];
+
+  // Low 32 bits only, enough for the offset computations of the library
+  mock_dma_hw.ch[channel].read_addr.value       = (uint32_t) dma->read;
+  mock_dma_hw.ch[channel].write_addr.value      = (uint32_t) dma->write;
+  mock_dma_hw.ch[channel].transfer_count.value  = dma->count;
+}
+
+template<class T> inline bool mock_in_block(const uintptr_t& address, const T& block)
+{
+  return (address >= (uintptr_t) &block) && (address < (uintptr_t) &block + sizeof(block));
+}
+
+inline bool mock_is_register(const uintptr_t& address)
+{
+  return mock_in_block(address, mock_pwm_hw) || mock_in_block(address, mock_dma_hw) || mock_in_block(address, mock_adc_hw);
+}
+
+inline void mock_adc_pump();
+
+inline uint32_t mock_bus_read(const uintptr_t& address, const uint& bytes)
+{
+  if (mock_is_register(address))
+  {
+    mock_reg* reg = (mock_reg*) (address & ~(uintptr_t) 3);
+
+    if (reg == &mock_adc_hw.fifo)
+    {
+      // Reading the FIFO pops it
+      uint16_t sample = 0;
+
+      if (!mock_sim.adcFifo.empty())
+      {
+        sample = mock_sim.adcFifo.front();
+        mock_sim.adcFifo.pop_front();
+      }
+
+      return sample;
+    }
+
+    return reg->value >> ( 8 * (address & 3) );
+  }
+
+  uint32_t value = 0;
+
+  memcpy(&value, (const void*) address, bytes);
+
+  return value;
+}
+
+inline void mock_bus_write(const uintptr_t& address, const uint32_t& value, const uint& bytes)
+{
+  if (mock_is_register(address))
+  {
+    mock_reg* reg = (mock_reg*) (address & ~(uintptr_t) 3);
+
+    // Narrow writes to a peripheral register are replicated over the 32 bits
+    if (bytes == 2)
+      *reg = (value & 0xffff) | (value << 16);
+    else if (bytes == 1)
+      *reg = (value & 0xff) * 0x01010101u;
+    else
+      *reg = value;
+
+    return;
+  }
+
+  memcpy((void*) address, &value, bytes);
+}
+
+inline uintptr_t mock_dma_increment(const uintptr_t& address, const uint& bytes, const uint& ringBits)
+{
+  if (ringBits == 0)
+    return address + bytes;
+
+  uintptr_t mask = ( (uintptr_t) 1 << ringBits ) - 1;
+
+  return (address & ~mask) | ( (address + bytes) & mask );
+}
+
+inline void mock_dma_start(const uint& channel);
+
+inline void mock_dma_complete(const uint& channel)
+{
+  mock_dma_channel_state* dma = &mock_sim.dma[channel];
+
+  dma->busy = false;
+
+  mock_dma_hw.intr.value |= 1u << channel;
+  mock_dma_update_ints();
+
+  if (mock_dma_hw.ints0.value & (1u << channel))
+    mock_irq_raise(DMA_IRQ_0);
+
+  if (mock_dma_hw.ints1.value & (1u << channel))
+    mock_irq_raise(DMA_IRQ_1);
+
+  if (dma->config.chainTo != channel)
+    mock_dma_start(dma->config.chainTo);
+}
+
+inline void mock_dma_transfer(const uint& channel)
+{
+  mock_dma_channel_state* dma = &mock_sim.dma[channel];
+
+  uint bytes = 1u << dma->config.size;
+
+  mock_bus_write(dma->write, mock_bus_read(dma->read, bytes), bytes);
+
+  if (dma->config.readIncrement)
+    dma->read  = mock_dma_increment(dma->read, bytes, dma->config.ringWrite ? 0 : dma->config.ringBits);
+
+  if (dma->config.writeIncrement)
+    dma->write = mock_dma_increment(dma->write, bytes, dma->config.ringWrite ? dma->config.ringBits : 0);
+
+  dma->count--;
+  dma->transfers++;
+  mock_sim.dmaTransfers++;
+
+  mock_dma_mirror(channel);
+
+  if (dma->count == 0)
+    mock_dma_complete(channel);
+}
+
+inline void mock_dma_start(const uint& channel)
+{
+  mock_dma_channel_state* dma = &mock_sim.dma[channel];
+
+  dma->count = dma->reload;
+  dma->busy  = true;
+
+  mock_dma_mirror(channel);
+
+  if (dma->count == 0)
+  {
+    mock_dma_complete(channel);
+
+    return;
+  }
+
+  if (dma->config.dreq == DREQ_FORCE)
+  {
+    while (dma->busy)
+      mock_dma_transfer(channel);
+  }
+  else if (dma->config.dreq == DREQ_ADC)
+  {
+    mock_adc_pump();
+  }
+}
+
+inline void mock_dma_abort(const uint& channel)
+{
+  mock_sim.dma[channel].busy = false;
+}
+
+inline void mock_dma_dreq(const uint& dreq)
+{
+  // One transfer for the channels waiting now, not for a channel chained by one of them
+  uint32_t waiting = 0;
+
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+  {
+    if (mock_sim.dma[channel].busy && (mock_sim.dma[channel].config.dreq == dreq))
+      waiting |= 1u << channel;
+  }
+
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+  {
+    if ( (waiting & (1u << channel)) && mock_sim.dma[channel].busy )
+      mock_dma_transfer(channel);
+  }
+}
+
+inline bool mock_dma_waiting(const uint& dreq)
+{
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+  {
+    if (mock_sim.dma[channel].busy && (mock_sim.dma[channel].config.dreq == dreq))
+      return true;
+  }
+
+  return false;
+}
+
+inline void mock_dma_written(mock_reg* reg, const uint32_t& previous)
+{
+  if ( (reg == &mock_dma_hw.intr) || (reg == &mock_dma_hw.ints0) || (reg == &mock_dma_hw.ints1) )
+  {
+    // Write 1 to clear the raw flags
+    uint32_t cleared = reg->value;
+
+    if (reg == &mock_dma_hw.intr)
+      mock_dma_hw.intr.value = previous & ~cleared;
+    else
+      mock_dma_hw.intr.value &= ~cleared;
+
+    mock_dma_update_ints();
+  }
+  else if (reg == &mock_dma_hw.abort)
+  {
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+    {
+      if (mock_dma_hw.abort.value & (1u << channel))
+        mock_dma_abort(channel);
+    }
+
+    // Abort done at once, reads as 0
+    mock_dma_hw.abort.value = 0;
+  }
+  else if (reg == &mock_dma_hw.multi_channel_trigger)
+  {
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+    {
+      if (mock_dma_hw.multi_channel_trigger.value & (1u << channel))
+        mock_dma_start(channel);
+    }
+
+    mock_dma_hw.multi_channel_trigger.value = 0;
+  }
+  else
+  {
+    mock_dma_update_ints();
+
+    if (mock_dma_hw.ints0.value)
+      mock_irq_raise(DMA_IRQ_0);
+
+    if (mock_dma_hw.ints1.value)
+      mock_irq_raise(DMA_IRQ_1);
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+// ADC
+///////////////////////////////////////////////////////////////////
+
+inline void mock_adc_update_fcs()
+{
+  uint32_t level = mock_sim.adcFifo.size();
+
+  mock_adc_hw.fcs.value = (mock_adc_hw.fcs.value & 0x0f00000f) | (level << ADC_FCS_LEVEL_LSB) |
+                          (level == 0 ? ADC_FCS_EMPTY_BITS : 0) | (level == ADC_FIFO_DEPTH ? ADC_FCS_FULL_BITS : 0) |
+                          (mock_adc_hw.fcs.value & ADC_FCS_OVER_BITS);
+}
+
+// DREQ_ADC is asserted while the FIFO holds a sample
+inline void mock_adc_pump()
+{
+  if ( !(mock_adc_hw.fcs.value & ADC_FCS_DREQ_EN_BITS) )
+    return;
+
+  while (!mock_sim.adcFifo.empty() && mock_dma_waiting(DREQ_ADC))
+    mock_dma_dreq(DREQ_ADC);
+
+  mock_adc_update_fcs();
+}
+
+inline void mock_adc_start()
+{
+  if (mock_sim.adcBusy || !(mock_adc_hw.cs.value & ADC_CS_EN_BITS))
+    return;
+
+  mock_sim.adcBusy  = true;
+  mock_sim.adcStart = mock_sim.now;
+  mock_sim.adcDone  = mock_sim.now + MOCK_SUBCYCLES_PER_US * MOCK_ADC_CONVERSION_US_X1000 / 1000;
+
+  if (mock_sim.adcTrace)
+    mock_sim.adcStarts.push_back(mock_sim.now);
+
+  mock_adc_hw.cs.value &= ~ADC_CS_READY_BITS;
+}
+
+inline void mock_adc_complete()
+{
+  uint input      = (mock_adc_hw.cs.value & ADC_CS_AINSEL_BITS) >> ADC_CS_AINSEL_LSB;
+  uint16_t sample = mock_sim.adcSource ? (mock_sim.adcSource(input, mock_sim.adcStart) & 0xfff) : 0;
+
+  mock_sim.adcBusy = false;
+  mock_sim.adcConversions++;
+
+  mock_adc_hw.result.value  = sample;
+  mock_adc_hw.cs.value     |= ADC_CS_READY_BITS;
+
+  if (mock_adc_hw.fcs.value & ADC_FCS_EN_BITS)
+  {
+    if (mock_sim.adcFifo.size() < ADC_FIFO_DEPTH)
+      mock_sim.adcFifo.push_back( (mock_adc_hw.fcs.value & ADC_FCS_SHIFT_BITS) ? (sample >> 4) : sample);
+    else
+      mock_adc_hw.fcs.value |= ADC_FCS_OVER_BITS;
+  }
+
+  mock_adc_update_fcs();
+  mock_adc_pump();
+
+  if (mock_adc_hw.cs.value & ADC_CS_START_MANY_BITS)
+    mock_adc_start();
+}
+
+inline void mock_adc_written(mock_reg* reg, const uint32_t& previous)
+{
+  if (reg == &mock_adc_hw.cs)
+  {
+    if (mock_adc_hw.cs.value & (ADC_CS_START_ONCE_BITS | ADC_CS_START_MANY_BITS))
+      mock_adc_start();
+
+    // START_ONCE is self-clearing
+    mock_adc_hw.cs.value = (mock_adc_hw.cs.value & ~ADC_CS_START_ONCE_BITS) | (previous & ADC_CS_READY_BITS);
+  }
+  else if (reg == &mock_adc_hw.fcs)
+  {
+    // Write 1 to clear OVER
+    mock_adc_hw.fcs.value = (mock_adc_hw.fcs.value & 0x0f00000f) |
+                            (previous & ADC_FCS_OVER_BITS & ~mock_adc_hw.fcs.value);
+    mock_adc_update_fcs();
+    mock_adc_pump();
+  }
+  else if ( (reg == &mock_adc_hw.fifo) || (reg == &mock_adc_hw.result) )
+  {
+    reg->value = previous;
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+
+inline void mock_sim_written(mock_reg* reg, const uint32_t& previous)
+{
+  uintptr_t address = (uintptr_t) reg;
+
+  if (mock_in_block(address, mock_pwm_hw))
+    mock_pwm_written(reg, previous);
+  else if (mock_in_block(address, mock_dma_hw))
+    mock_dma_written(reg, previous);
+  else if (mock_in_block(address, mock_adc_hw))
+    mock_adc_written(reg, previous);
+}
+
+///////////////////////////////////////////////////////////////////
+// Event loop
+///////////////////////////////////////////////////////////////////
+
+enum mock_event_kind
+{
+  MOCK_EVENT_NONE,
+  MOCK_EVENT_WRAP,
+  MOCK_EVENT_DMA_TIMER,
+  MOCK_EVENT_ADC,
+  MOCK_EVENT_ALARM,
+  MOCK_EVENT_REPEATING,
+  MOCK_EVENT_IRQ
+};
+
+inline uint64_t mock_dma_timer_tick(const mock_dma_timer_state& timer, const uint64_t& tick)
+{
+  // One DREQ every Y / X system clock cycles
+  return timer.base + ( tick * MOCK_SUBCYCLES * timer.y + timer.x - 1 ) / timer.x;
+}
+
+// Run all the events up to and including time target, then stop at target
+inline void mock_sim_run_until(const uint64_t& target)
+{
+  uint32_t sameTime = 0;
+  uint64_t lastTime = mock_sim.now;
+
+  for (;;)
+  {
+    uint64_t        when  = UINT64_MAX;
+    mock_event_kind kind  = MOCK_EVENT_NONE;
+    uint            index = 0;
+
+    // Simultaneous events : slices first, as the hardware, then DMA, ADC, timer, and handlers last
+    for (uint i = 0; i < NUM_PWM_SLICES_HW; i++)
+    {
+      if (mock_sim.slice[i].running)
+      {
+        uint64_t wrap = mock_next_wrap(i);
+
+        if (wrap < when)
+        {
+          when  = wrap;
+          kind  = MOCK_EVENT_WRAP;
+          index = i;
+        }
+      }
+    }
+
+    for (uint i = 0; i < NUM_DMA_TIMERS; i++)
+    {
+      mock_dma_timer_state* timer = &mock_sim.dmaTimer[i];
+
+      if ( timer->x && timer->y && mock_dma_waiting(DREQ_DMA_TIMER0 + i) )
+      {
+        while (mock_dma_timer_tick(*timer, timer->ticks) < mock_sim.now)
+          timer->ticks++;
+
+        uint64_t tick = mock_dma_timer_tick(*timer, timer->ticks);
+
+        if (tick < when)
+        {
+          when  = tick;
+          kind  = MOCK_EVENT_DMA_TIMER;
+          index = i;
+        }
+      }
+    }
+
+    if (mock_sim.adcBusy && (mock_sim.adcDone < when))
+    {
+      when = mock_sim.adcDone;
+      kind = MOCK_EVENT_ADC;
+    }
+
+    for (uint i = 0; i < NUM_TIMERS; i++)
+    {
+      if (mock_sim.alarm[i].armed && (mock_sim.alarm[i].target < when))
+      {
+        when  = mock_sim.alarm[i].target;
+        kind  = MOCK_EVENT_ALARM;
+        index = i;
+      }
+    }
+
+    for (uint i = 0; i < mock_sim.repeating.size(); i++)
+    {
+      if (mock_sim.repeating[i].next < when)
+      {
+        when  = mock_sim.repeating[i].next;
+        kind  = MOCK_EVENT_REPEATING;
+        index = i;
+      }
+    }
+
+    for (uint i = 0; i < NUM_IRQS; i++)
+    {
+      if (mock_sim.irq[i].pending && (mock_sim.irq[i].serviceAt < when))
+      {
+        when  = mock_sim.irq[i].serviceAt;
+        kind  = MOCK_EVENT_IRQ;
+        index = i;
+      }
+    }
+
+    if ( (kind == MOCK_EVENT_NONE) || (when > target) )
+      break;
+
+    if (when < mock_sim.now)
+      when = mock_sim.now;
+
+    if (when == lastTime)
+    {
+      if (++sameTime > 1000000)
+      {
+        fprintf(stderr, "RP2040_Sim : no progress at cycle %llu, event %d\n", (unsigned long long) mock_sim_cycles(), kind);
+        abort();
+      }
+    }
+    else
+    {
+      sameTime = 0;
+      lastTime = when;
+    }
+
+    mock_sim.now = when;
+
+    switch (kind)
+    {
+      case MOCK_EVENT_WRAP:
+        mock_slice_wrap(index);
+        break;
+
+      case MOCK_EVENT_DMA_TIMER:
+        mock_sim.dmaTimer[index].ticks++;
+        mock_dma_dreq(DREQ_DMA_TIMER0 + index);
+        break;
+
+      case MOCK_EVENT_ADC:
+        mock_adc_complete();
+        break;
+
+      case MOCK_EVENT_ALARM:
+        mock_sim.alarm[index].armed = false;
+
+        if (mock_sim.alarm[index].callback)
+          mock_sim.alarm[index].callback(index);
+
+        break;
+
+      case MOCK_EVENT_REPEATING:
+      {
+        repeating_timer_t* timer = mock_sim.repeating[index].timer;
+
+        if (timer->callback(timer))
+        {
+          // The callback may have cancelled, then added timers
+          for (uint i = 0; i < mock_sim.repeating.size(); i++)
+          {
+            if (mock_sim.repeating[i].timer == timer)
+              mock_sim.repeating[i].next += (uint64_t) (timer->delay_us < 0 ? -timer->delay_us : timer->delay_us) * MOCK_SUBCYCLES_PER_US;
+          }
+        }
+        else
+        {
+          for (uint i = 0; i < mock_sim.repeating.size(); i++)
+          {
+            if (mock_sim.repeating[i].timer == timer)
+            {
+              mock_sim.repeating.erase(mock_sim.repeating.begin() + i);
+              break;
+            }
+          }
+        }
+
+        break;
+      }
+
+      case MOCK_EVENT_IRQ:
+        mock_irq_service(index);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if (target > mock_sim.now)
+    mock_sim.now = target;
+}
+
+inline void mock_sim_run_cycles(const uint64_t& cycles)
+{
+  mock_sim_run_until(mock_sim.now + cycles * MOCK_SUBCYCLES);
+}
+
+inline void mock_sim_run_us(const uint64_t& us)
+{
+  mock_sim_run_until(mock_sim.now + us * MOCK_SUBCYCLES_PER_US);
+}
+
+// Run until the next wrap of slice_num, included. False if not running
+inline bool mock_sim_run_to_wrap(const uint& slice_num)
+{
+  if (!mock_sim.slice[slice_num].running)
+    return false;
+
+  uint32_t wraps = mock_sim.slice[slice_num].wraps;
+
+  while (mock_sim.slice[slice_num].running && (mock_sim.slice[slice_num].wraps == wraps))
+    mock_sim_run_until(mock_next_wrap(slice_num));
+
+  return mock_sim.slice[slice_num].wraps != wraps;
+}
+
+// Record the periods of slice_num from now
+inline void mock_sim_trace(const uint& slice_num, const bool& enable = true)
+{
+  mock_sim.slice[slice_num].trace = enable;
+  mock_sim.slice[slice_num].periods.clear();
+}
+
+inline const std::vector<PWM_SimPeriod>& mock_sim_periods(const uint& slice_num)
+{
+  return mock_sim.slice[slice_num].periods;
+}
+
+// Current output level of a channel, as the comparator : high while counter < CC, then inverted if A_INV / B_INV
+inline bool mock_sim_output(const uint& slice_num, const uint& chan)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+  uint32_t          csr   = mock_pwm_hw.slice[slice_num].csr.value;
+
+  bool inverted = (csr & (chan ? PWM_CH0_CSR_B_INV_BITS : PWM_CH0_CSR_A_INV_BITS)) != 0;
+
+  if (!slice->running)
+    return inverted;
+
+  double   counts = slice->counts + (double) (mock_sim.now - slice->segStart) / mock_div16(mock_pwm_hw.slice[slice_num].div.value);
+  uint32_t top    = slice->top & 0xffff;
+  uint32_t level  = chan ? (slice->cc >> 16) : (slice->cc & 0xffff);
+
+  if ( (csr & PWM_CH0_CSR_PH_CORRECT_BITS) && (counts >= top + 1) )
+    counts = 2.0 * (top + 1) - counts;
+
+  return ( (uint32_t) counts < level ) != inverted;
+}
+
+// Back to power-on state. Library state is not touched
+inline void mock_sim_reset()
+{
+  for (uint i = 0; i < NUM_PWM_SLICES_HW; i++)
+  {
+    mock_pwm_hw.slice[i].csr.value  = 0;
+    mock_pwm_hw.slice[i].div.value  = 1 << PWM_CH0_DIV_INT_LSB;
+    mock_pwm_hw.slice[i].ctr.value  = 0;
+    mock_pwm_hw.slice[i].cc.value   = 0;
+    mock_pwm_hw.slice[i].top.value  = PWM_CH0_TOP_RESET;
+
+    mock_sim.slice[i].running     = false;
+    mock_sim.slice[i].top         = PWM_CH0_TOP_RESET;
+    mock_sim.slice[i].cc          = 0;
+    mock_sim.slice[i].counts      = 0;
+    mock_sim.slice[i].wraps       = 0;
+    mock_sim.slice[i].writes      = 0;
+    mock_sim.slice[i].trace       = false;
+    mock_sim.slice[i].divChanged  = false;
+    mock_sim.slice[i].periods.clear();
+  }
+
+  mock_pwm_hw.en.value    = 0;
+  mock_pwm_hw.intr.value  = 0;
+  mock_pwm_hw.inte.value  = 0;
+  mock_pwm_hw.intf.value  = 0;
+  mock_pwm_hw.ints.value  = 0;
+
+  memset( (void*) &mock_dma_hw, 0, sizeof(mock_dma_hw));
+  memset( (void*) &mock_adc_hw, 0, sizeof(mock_adc_hw));
+
+  for (uint i = 0; i < NUM_DMA_CHANNELS; i++)
+    mock_sim.dma[i] = mock_dma_channel_state();
+
+  for (uint i = 0; i < NUM_DMA_TIMERS; i++)
+    mock_sim.dmaTimer[i] = mock_dma_timer_state();
+
+  for (uint i = 0; i < NUM_TIMERS; i++)
+    mock_sim.alarm[i] = mock_alarm_state();
+
+  for (uint i = 0; i < NUM_IRQS; i++)
+  {
+    mock_sim.irq[i].handlers.clear();
+    mock_sim.irq[i].enabled = false;
+    mock_sim.irq[i].pending = false;
+    mock_sim.irq[i].count   = 0;
+  }
+
+  mock_sim.repeating.clear();
+  mock_sim.adcFifo.clear();
+  mock_sim.adcStarts.clear();
+
+  mock_sim.adcBusy        = false;
+  mock_sim.adcSource      = NULL;
+  mock_sim.adcConversions = 0;
+  mock_sim.adcTrace       = false;
+  mock_sim.pwmWrites      = 0;
+  mock_sim.dmaTransfers   = 0;
+  mock_sim.irqLatency     = 0;
+  mock_sim.hostClock      = false;
+
+  // GPIO_FUNC_NULL
+  memset(mock_sim.gpioFunction, 0x1f, sizeof(mock_sim.gpioFunction));
+}
+
+// Power-on state before main()
+struct mock_sim_init
+{
+  mock_sim_init()
+  {
+    mock_sim_reset();
+  }
+};
+
+inline mock_sim_init mock_sim_init_data;
+
+#endif    // RP2040_SIM_H
@@ -0,0 +1,84 @@
+/****************************************************************************************************************************
+  hardware/adc.h
+  Host mock of pico-sdk hardware_adc, on the simulated ADC of RP2040_Sim.h
+  The input value of each conversion is given by mock_sim.adcSource
+*****************************************************************************************************************************/
+
+#pragma once
+
+#include "../RP2040_Sim.h"
+#include "hardware/gpio.h"
+
+inline void adc_init()
+{
+  adc_hw->cs = ADC_CS_EN_BITS;
+}
+
+inline void adc_gpio_init(uint gpio)
+{
+  gpio_set_function(gpio, GPIO_FUNC_NULL);
+}
+
+inline void adc_select_input(uint input)
+{
+  hw_write_masked(&adc_hw->cs, input << ADC_CS_AINSEL_LSB, ADC_CS_AINSEL_BITS);
+}
+
+inline uint adc_get_selected_input()
+{
+  return (adc_hw->cs & ADC_CS_AINSEL_BITS) >> ADC_CS_AINSEL_LSB;
+}
+
+inline void adc_set_temp_sensor_enabled(bool enable)
+{
+  if (enable)
+    hw_set_bits(&adc_hw->cs, ADC_CS_TS_EN_BITS);
+  else
+    hw_clear_bits(&adc_hw->cs, ADC_CS_TS_EN_BITS);
+}
+
+inline void adc_run(bool run)
+{
+  if (run)
+    hw_set_bits(&adc_hw->cs, ADC_CS_START_MANY_BITS);
+  else
+    hw_clear_bits(&adc_hw->cs, ADC_CS_START_MANY_BITS);
+}
+
+inline void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift)
+{
+  hw_write_masked(&adc_hw->fcs,
+                  (en ? ADC_FCS_EN_BITS : 0) | (dreq_en ? ADC_FCS_DREQ_EN_BITS : 0) | ( ( (uint32_t) dreq_thresh ) << ADC_FCS_THRESH_LSB ) |
+                  (err_in_fifo ? ADC_FCS_ERR_BITS : 0) | (byte_shift ? ADC_FCS_SHIFT_BITS : 0),
+                  0x0f00000f);
+}
+
+// As the SDK, waits for the conversion in progress, so that its result is drained too
+inline void adc_fifo_drain()
+{
+  if (mock_sim.adcBusy)
+    mock_sim_run_until(mock_sim.adcDone);
+
+  mock_sim.adcFifo.clear();
+  mock_adc_update_fcs();
+}
+
+inline uint adc_fifo_get_level()
+{
+  return mock_sim.adcFifo.size();
+}
+
+inline bool adc_fifo_is_empty()
+{
+  return mock_sim.adcFifo.empty();
+}
+
+// Blocking conversion, run to completion in the simulation
+inline uint16_t adc_read()
+{
+  hw_set_bits(&adc_hw->cs, ADC_CS_START_ONCE_BITS);
+
+  mock_sim_run_until(mock_sim.adcDone);
+
+  return (uint16_t) adc_hw->result;
+}
@@ -0,0 +1,244 @@
+/****************************************************************************************************************************
+  hardware/dma.h
+  Host mock of pico-sdk hardware_dma, on the simulated DMA of RP2040_Sim.h
+  The addresses are kept at full host width by the simulation, the registers show their low 32 bits
+*****************************************************************************************************************************/
+
+#pragma once
+
+#include "../RP2040_Sim.h"
+
+inline void dma_channel_claim(uint channel)
+{
+  mock_sim.dma[channel].claimed = true;
+}
+
+inline void dma_channel_unclaim(uint channel)
+{
+  mock_sim.dma[channel].claimed = false;
+}
+
+inline int dma_claim_unused_channel(bool required)
+{
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+  {
+    if (!mock_sim.dma[channel].claimed)
+    {
+      mock_sim.dma[channel].claimed = true;
+
+      return (int) channel;
+    }
+  }
+
+  if (required)
+    abort();
+
+  return -1;
+}
+
+inline bool dma_channel_is_claimed(uint channel)
+{
+  return mock_sim.dma[channel].claimed;
+}
+
+///////////////////////////////////////////////////////////////////
+
+inline void dma_timer_claim(uint timer)
+{
+  mock_sim.dmaTimer[timer].claimed = true;
+}
+
+inline void dma_timer_unclaim(uint timer)
+{
+  mock_sim.dmaTimer[timer].claimed = false;
+}
+
+inline int dma_claim_unused_timer(bool required)
+{
+  for (uint timer = 0; timer < NUM_DMA_TIMERS; timer++)
+  {
+    if (!mock_sim.dmaTimer[timer].claimed)
+    {
+      mock_sim.dmaTimer[timer].claimed = true;
+
+      return (int) timer;
+    }
+  }
+
+  if (required)
+    abort();
+
+  return -1;
+}
+
+// Pace of X / Y DREQ per system clock cycle
+inline void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator)
+{
+  mock_dma_timer_state* state = &mock_sim.dmaTimer[timer];
+
+  state->x      = numerator;
+  state->y      = denominator;
+  state->base   = mock_sim.now;
+  state->ticks  = 1;
+
+  dma_hw->timer[timer] = ( ( (uint32_t) numerator ) << 16 ) | denominator;
+}
+
+inline uint dma_get_timer_dreq(uint timer)
+{
+  return DREQ_DMA_TIMER0 + timer;
+}
+
+///////////////////////////////////////////////////////////////////
+
+inline dma_channel_config dma_channel_get_default_config(uint channel)
+{
+  dma_channel_config c;
+
+  c.size            = DMA_SIZE_32;
+  c.readIncrement   = true;
+  c.writeIncrement  = false;
+  c.ringWrite       = false;
+  c.ringBits        = 0;
+  c.dreq            = DREQ_FORCE;
+  c.chainTo         = channel;
+  c.enable          = true;
+
+  return c;
+}
+
+inline void channel_config_set_read_increment(dma_channel_config* c, bool incr)
+{
+  c->readIncrement = incr;
+}
+
+inline void channel_config_set_write_increment(dma_channel_config* c, bool incr)
+{
+  c->writeIncrement = incr;
+}
+
+inline void channel_config_set_dreq(dma_channel_config* c, uint dreq)
+{
+  c->dreq = dreq;
+}
+
+inline void channel_config_set_chain_to(dma_channel_config* c, uint chain_to)
+{
+  c->chainTo = chain_to;
+}
+
+inline void channel_config_set_transfer_data_size(dma_channel_config* c, enum dma_channel_transfer_size size)
+{
+  c->size = size;
+}
+
+inline void channel_config_set_ring(dma_channel_config* c, bool write, uint size_bits)
+{
+  c->ringWrite  = write;
+  c->ringBits   = size_bits;
+}
+
+inline void channel_config_set_enable(dma_channel_config* c, bool enable)
+{
+  c->enable = enable;
+}
+
+///////////////////////////////////////////////////////////////////
+
+inline void dma_channel_start(uint channel)
+{
+  mock_dma_start(channel);
+}
+
+inline void dma_start_channel_mask(uint32_t mask)
+{
+  dma_hw->multi_channel_trigger = mask;
+}
+
+inline void dma_channel_set_config(uint channel, const dma_channel_config* config, bool trigger)
+{
+  mock_sim.dma[channel].config = *config;
+
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+inline void dma_channel_set_read_addr(uint channel, const volatile void* read_addr, bool trigger)
+{
+  mock_sim.dma[channel].read = (uintptr_t) read_addr;
+  mock_dma_mirror(channel);
+
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+inline void dma_channel_set_write_addr(uint channel, volatile void* write_addr, bool trigger)
+{
+  mock_sim.dma[channel].write = (uintptr_t) write_addr;
+  mock_dma_mirror(channel);
+
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+// Sets the reload value, copied to the live counter at each trigger
+inline void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger)
+{
+  mock_sim.dma[channel].reload = trans_count;
+
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+inline void dma_channel_configure(uint channel, const dma_channel_config* config, volatile void* write_addr,
+                                  const volatile void* read_addr, uint transfer_count, bool trigger)
+{
+  mock_dma_channel_state* dma = &mock_sim.dma[channel];
+
+  dma->config = *config;
+  dma->write  = (uintptr_t) write_addr;
+  dma->read   = (uintptr_t) read_addr;
+  dma->reload = transfer_count;
+  dma->count  = transfer_count;
+
+  mock_dma_mirror(channel);
+
+  if (trigger)
+    mock_dma_start(channel);
+}
+
+inline void dma_channel_abort(uint channel)
+{
+  dma_hw->abort = 1u << channel;
+}
+
+inline bool dma_channel_is_busy(uint channel)
+{
+  return mock_sim.dma[channel].busy;
+}
+
+inline void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+  if (enabled)
+    hw_set_bits(&dma_hw->inte0, 1u << channel);
+  else
+    hw_clear_bits(&dma_hw->inte0, 1u << channel);
+}
+
+inline void dma_channel_set_irq1_enabled(uint channel, bool enabled)
+{
+  if (enabled)
+    hw_set_bits(&dma_hw->inte1, 1u << channel);
+  else
+    hw_clear_bits(&dma_hw->inte1, 1u << channel);
+}
+
+inline void dma_channel_acknowledge_irq0(uint channel)
+{
+  dma_hw->ints0 = 1u << channel;
+}
+
+inline void dma_channel_acknowledge_irq1(uint channel)
+{
+  dma_hw->ints1 = 1u << channel;
+}
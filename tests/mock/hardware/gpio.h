@@ -0,0 +1,39 @@
+/****************************************************************************************************************************
+  hardware/gpio.h
+  Host mock of pico-sdk hardware_gpio : only the pin function is kept
+*****************************************************************************************************************************/
+
+#pragma once
+
+#include "../RP2040_Sim.h"
+
+enum gpio_function
+{
+  GPIO_FUNC_XIP   = 0,
+  GPIO_FUNC_SPI   = 1,
+  GPIO_FUNC_UART  = 2,
+  GPIO_FUNC_I2C   = 3,
+  GPIO_FUNC_PWM   = 4,
+  GPIO_FUNC_SIO   = 5,
+  GPIO_FUNC_PIO0  = 6,
+  GPIO_FUNC_PIO1  = 7,
+  GPIO_FUNC_GPCK  = 8,
+  GPIO_FUNC_USB   = 9,
+  GPIO_FUNC_NULL  = 0x1f
+};
+
+inline void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+  if (gpio < NUM_BANK0_GPIOS)
+    mock_sim.gpioFunction[gpio] = (uint8_t) fn;
+}
+
+inline enum gpio_function gpio_get_function(uint gpio)
+{
+  return (gpio < NUM_BANK0_GPIOS) ? (enum gpio_function) mock_sim.gpioFunction[gpio] : GPIO_FUNC_NULL;
+}
+
+inline void gpio_init(uint gpio)
+{
+  gpio_set_function(gpio, GPIO_FUNC_SIO);
+}
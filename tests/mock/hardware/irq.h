@@ -0,0 +1,8 @@
+/****************************************************************************************************************************
+  hardware/irq.h
+  Host mock of pico-sdk hardware_irq. Handlers are called by the simulation when their IRQ is raised
+*****************************************************************************************************************************/
+
+#pragma once
+
+#include "../RP2040_Sim.h"
@@ -0,0 +1,208 @@
+/****************************************************************************************************************************
+  hardware/pwm.h
+  Host mock of pico-sdk hardware_pwm, on the simulated registers of RP2040_Sim.h
+  Same register writes as pico-sdk, so that the bus writes counted are those of the real code
+*****************************************************************************************************************************/
+
+#pragma once
+
+#include "../RP2040_Sim.h"
+#include "hardware/gpio.h"
+
+enum pwm_chan
+{
+  PWM_CHAN_A = 0,
+  PWM_CHAN_B = 1
+};
+
+enum pwm_clkdiv_mode
+{
+  PWM_DIV_FREE_RUNNING  = 0,
+  PWM_DIV_B_HIGH        = 1,
+  PWM_DIV_B_RISING      = 2,
+  PWM_DIV_B_FALLING     = 3
+};
+
+typedef struct
+{
+  uint32_t csr;
+  uint32_t div;
+  uint32_t top;
+} pwm_config;
+
+///////////////////////////////////////////////////////////////////
+
+inline uint pwm_gpio_to_slice_num(uint gpio)
+{
+  return (gpio >> 1u) & 7u;
+}
+
+inline uint pwm_gpio_to_channel(uint gpio)
+{
+  return gpio & 1u;
+}
+
+inline void pwm_config_set_phase_correct(pwm_config* c, bool phase_correct)
+{
+  c->csr = (c->csr & ~PWM_CH0_CSR_PH_CORRECT_BITS) | ( (phase_correct ? 1u : 0u) << PWM_CH0_CSR_PH_CORRECT_LSB );
+}
+
+inline void pwm_config_set_clkdiv(pwm_config* c, float div)
+{
+  c->div = (uint32_t) (div * (float) (1u << PWM_CH0_DIV_INT_LSB));
+}
+
+inline void pwm_config_set_clkdiv_int_frac(pwm_config* c, uint8_t integer, uint8_t fract)
+{
+  c->div = ( ( (uint32_t) integer ) << PWM_CH0_DIV_INT_LSB ) | ( ( (uint32_t) fract ) << PWM_CH0_DIV_FRAC_LSB );
+}
+
+inline void pwm_config_set_clkdiv_int(pwm_config* c, uint div)
+{
+  pwm_config_set_clkdiv_int_frac(c, (uint8_t) div, 0);
+}
+
+inline void pwm_config_set_clkdiv_mode(pwm_config* c, enum pwm_clkdiv_mode mode)
+{
+  c->csr = (c->csr & ~PWM_CH0_CSR_DIVMODE_BITS) | ( ( (uint32_t) mode ) << PWM_CH0_CSR_DIVMODE_LSB );
+}
+
+inline void pwm_config_set_output_polarity(pwm_config* c, bool a, bool b)
+{
+  c->csr = (c->csr & ~(PWM_CH0_CSR_A_INV_BITS | PWM_CH0_CSR_B_INV_BITS)) |
+           ( (a ? 1u : 0u) << PWM_CH0_CSR_A_INV_LSB ) | ( (b ? 1u : 0u) << PWM_CH0_CSR_B_INV_LSB );
+}
+
+inline void pwm_config_set_wrap(pwm_config* c, uint16_t wrap)
+{
+  c->top = wrap;
+}
+
+inline pwm_config pwm_get_default_config()
+{
+  pwm_config c = { 0, 0, 0 };
+
+  pwm_config_set_phase_correct(&c, false);
+  pwm_config_set_clkdiv_int(&c, 1);
+  pwm_config_set_clkdiv_mode(&c, PWM_DIV_FREE_RUNNING);
+  pwm_config_set_output_polarity(&c, false, false);
+  pwm_config_set_wrap(&c, 0xffffu);
+
+  return c;
+}
+
+inline void pwm_init(uint slice_num, pwm_config* c, bool start)
+{
+  pwm_hw->slice[slice_num].csr  = 0;
+  pwm_hw->slice[slice_num].ctr  = PWM_CH0_CTR_RESET;
+  pwm_hw->slice[slice_num].cc   = PWM_CH0_CC_RESET;
+  pwm_hw->slice[slice_num].top  = c->top;
+  pwm_hw->slice[slice_num].div  = c->div;
+  pwm_hw->slice[slice_num].csr  = c->csr | ( (start ? 1u : 0u) << PWM_CH0_CSR_EN_LSB );
+}
+
+///////////////////////////////////////////////////////////////////
+
+inline void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level)
+{
+  hw_write_masked(&pwm_hw->slice[slice_num].cc, ( (uint32_t) level ) << (chan ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB),
+                  chan ? PWM_CH0_CC_B_BITS : PWM_CH0_CC_A_BITS);
+}
+
+inline void pwm_set_both_levels(uint slice_num, uint16_t level_a, uint16_t level_b)
+{
+  pwm_hw->slice[slice_num].cc = ( ( (uint32_t) level_b ) << PWM_CH0_CC_B_LSB ) | ( ( (uint32_t) level_a ) << PWM_CH0_CC_A_LSB );
+}
+
+inline void pwm_set_gpio_level(uint gpio, uint16_t level)
+{
+  pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level);
+}
+
+inline void pwm_set_wrap(uint slice_num, uint16_t wrap)
+{
+  pwm_hw->slice[slice_num].top = wrap;
+}
+
+inline void pwm_set_counter(uint slice_num, uint16_t c)
+{
+  pwm_hw->slice[slice_num].ctr = c;
+}
+
+inline uint16_t pwm_get_counter(uint slice_num)
+{
+  mock_slice_state* slice = &mock_sim.slice[slice_num];
+
+  if (!slice->running)
+    return (uint16_t) pwm_hw->slice[slice_num].ctr;
+
+  mock_slice_sync(slice_num, pwm_hw->slice[slice_num].div.value);
+
+  uint32_t counts = (uint32_t) slice->counts;
+  uint32_t top    = slice->top & 0xffff;
+
+  if (counts > top)
+    counts = 2 * (top + 1) - counts;
+
+  return (uint16_t) counts;
+}
+
+inline void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract)
+{
+  pwm_hw->slice[slice_num].div = ( ( (uint32_t) integer ) << PWM_CH0_DIV_INT_LSB ) | ( ( (uint32_t) fract ) << PWM_CH0_DIV_FRAC_LSB );
+}
+
+inline void pwm_set_phase_correct(uint slice_num, bool phase_correct)
+{
+  hw_write_masked(&pwm_hw->slice[slice_num].csr, ( phase_correct ? 1u : 0u ) << PWM_CH0_CSR_PH_CORRECT_LSB,
+                  PWM_CH0_CSR_PH_CORRECT_BITS);
+}
+
+inline void pwm_set_output_polarity(uint slice_num, bool a, bool b)
+{
+  hw_write_masked(&pwm_hw->slice[slice_num].csr, ( (a ? 1u : 0u) << PWM_CH0_CSR_A_INV_LSB ) | ( (b ? 1u : 0u) << PWM_CH0_CSR_B_INV_LSB ),
+                  PWM_CH0_CSR_A_INV_BITS | PWM_CH0_CSR_B_INV_BITS);
+}
+
+inline void pwm_set_enabled(uint slice_num, bool enabled)
+{
+  hw_write_masked(&pwm_hw->slice[slice_num].csr, ( enabled ? 1u : 0u ) << PWM_CH0_CSR_EN_LSB, PWM_CH0_CSR_EN_BITS);
+}
+
+inline void pwm_set_mask_enabled(uint32_t mask)
+{
+  pwm_hw->en = mask;
+}
+
+///////////////////////////////////////////////////////////////////
+
+inline void pwm_set_irq_enabled(uint slice_num, bool enabled)
+{
+  if (enabled)
+    hw_set_bits(&pwm_hw->inte, 1u << slice_num);
+  else
+    hw_clear_bits(&pwm_hw->inte, 1u << slice_num);
+}
+
+inline void pwm_set_irq_mask_enabled(uint32_t slice_mask, bool enabled)
+{
+  if (enabled)
+    hw_set_bits(&pwm_hw->inte, slice_mask);
+  else
+    hw_clear_bits(&pwm_hw->inte, slice_mask);
+}
+
+inline void pwm_clear_irq(uint slice_num)
+{
+  pwm_hw->intr = 1u << slice_num;
+}
+
+inline uint32_t pwm_get_irq_status_mask()
+{
+  return pwm_hw->ints;
+}
+
+inline void pwm_force_irq(uint slice_num)
+{
+  hw_set_bits(&pwm_hw->intf, 1u << slice_num);
+}
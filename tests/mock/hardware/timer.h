@@ -0,0 +1,79 @@
+/****************************************************************************************************************************
+  hardware/timer.h
+  Host mock of pico-sdk hardware_timer, on the simulated time of RP2040_Sim.h
+*****************************************************************************************************************************/
+
+#pragma once
+
+#include "../RP2040_Sim.h"
+
+inline uint64_t to_us_since_boot(absolute_time_t t)
+{
+  return t._private_us_since_boot;
+}
+
+inline void update_us_since_boot(absolute_time_t* t, uint64_t us_since_boot)
+{
+  t->_private_us_since_boot = us_since_boot;
+}
+
+inline void hardware_alarm_claim(uint alarm_num)
+{
+  mock_sim.alarm[alarm_num].claimed = true;
+}
+
+inline void hardware_alarm_unclaim(uint alarm_num)
+{
+  mock_sim.alarm[alarm_num].claimed = false;
+}
+
+inline int hardware_alarm_claim_unused(bool required)
+{
+  for (uint alarm_num = 0; alarm_num < NUM_TIMERS; alarm_num++)
+  {
+    if (!mock_sim.alarm[alarm_num].claimed)
+    {
+      mock_sim.alarm[alarm_num].claimed = true;
+
+      return (int) alarm_num;
+    }
+  }
+
+  if (required)
+    abort();
+
+  return -1;
+}
+
+inline void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback)
+{
+  mock_sim.alarm[alarm_num].callback = callback;
+}
+
+// True if the target is already in the past, the alarm is then not armed
+inline bool hardware_alarm_set_target(uint alarm_num, absolute_time_t target)
+{
+  uint64_t when = to_us_since_boot(target) * MOCK_SUBCYCLES_PER_US;
+
+  if (when <= mock_sim.now)
+  {
+    mock_sim.alarm[alarm_num].armed = false;
+
+    return true;
+  }
+
+  mock_sim.alarm[alarm_num].target  = when;
+  mock_sim.alarm[alarm_num].armed   = true;
+
+  return false;
+}
+
+inline void hardware_alarm_cancel(uint alarm_num)
+{
+  mock_sim.alarm[alarm_num].armed = false;
+}
+
+inline void busy_wait_us(uint64_t delay_us)
+{
+  mock_sim_run_us(delay_us);
+}
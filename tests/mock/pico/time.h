@@ -0,0 +1,72 @@
+/****************************************************************************************************************************
+  pico/time.h
+  Host mock of pico-sdk pico_time, on the simulated time of RP2040_Sim.h
+*****************************************************************************************************************************/
+
+#pragma once
+
+#include "hardware/timer.h"
+
+inline absolute_time_t get_absolute_time()
+{
+  absolute_time_t t;
+
+  update_us_since_boot(&t, time_us_64());
+
+  return t;
+}
+
+inline uint32_t to_ms_since_boot(absolute_time_t t)
+{
+  return (uint32_t) (to_us_since_boot(t) / 1000);
+}
+
+inline void sleep_us(uint64_t us)
+{
+  mock_sim_run_us(us);
+}
+
+inline void sleep_ms(uint32_t ms)
+{
+  mock_sim_run_us( (uint64_t) ms * 1000);
+}
+
+// Negative delay : from the start of the callback, positive : from its end. Same on the host
+inline bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void* user_data, repeating_timer_t* out)
+{
+  if (delay_us == 0)
+    return false;
+
+  out->delay_us   = delay_us;
+  out->callback   = callback;
+  out->user_data  = user_data;
+
+  mock_repeating_state state;
+
+  state.timer = out;
+  state.next  = mock_sim.now + (uint64_t) (delay_us < 0 ? -delay_us : delay_us) * MOCK_SUBCYCLES_PER_US;
+
+  mock_sim.repeating.push_back(state);
+
+  return true;
+}
+
+inline bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void* user_data, repeating_timer_t* out)
+{
+  return add_repeating_timer_us( (int64_t) delay_ms * 1000, callback, user_data, out);
+}
+
+inline bool cancel_repeating_timer(repeating_timer_t* timer)
+{
+  for (size_t i = 0; i < mock_sim.repeating.size(); i++)
+  {
+    if (mock_sim.repeating[i].timer == timer)
+    {
+      mock_sim.repeating.erase(mock_sim.repeating.begin() + i);
+
+      return true;
+    }
+  }
+
+  return false;
+}
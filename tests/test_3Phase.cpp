@@ -0,0 +1,323 @@
+/****************************************************************************************************************************
+  test_3Phase.cpp
+  RP2040_PWM_3Phase : levels of compute() against a floating point reference, for every mode and for carriers up to
+  the lowest one, with TOP up to 65535. The levels must stay in 0..TOP + 1, centered at (TOP + 1) / 2.
+  Simulated runs from the wrap IRQ : CC of the 3 slices at every period, for updateDivider and setRotation().
+  Slices marked active by begin() and cleared by end(), none kept claimed when begin() is refused a slice.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+// begin() refused a slice claimed by another user
+#define PWM_RESOURCE_STRICT   true
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_3Phase.h"
+
+#include "PWM_Test.h"
+
+#include <math.h>
+
+#define PIN_U           0
+#define PIN_V           2
+#define PIN_W           4
+
+// Any user of a slice
+static int otherUser;
+
+///////////////////////////////////////////////////////////////////
+
+// Same law as compute(), in double
+static double referenceLevel(const PWM_3Phase_Mode& mode, const uint32_t& top, const uint16_t& angle,
+                             const uint16_t& modIndex, const uint8_t& phase)
+{
+  double theta = 2 * M_PI * angle / 65536.0;
+  double v[3];
+
+  for (uint8_t i = 0; i < 3; i++)
+    v[i] = sin(theta - 2 * M_PI * i / 3);
+
+  double offset = 0;
+
+  if (mode == PWM_3PHASE_SPWM_THI)
+    offset = sin(3 * theta) / 6;
+  else if (mode == PWM_3PHASE_SVPWM)
+    offset = -(fmax(v[0], fmax(v[1], v[2])) + fmin(v[0], fmin(v[1], v[2]))) / 2;
+
+  double duty = 0.5 + (v[phase] + offset) * modIndex / PWM_3PHASE_MI_ONE / 2;
+
+  return fmin(fmax(duty, 0), 1) * (top + 1);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void checkCarrier(const uint32_t& carrierFreq)
+{
+  RP2040_PWM_3Phase inverter(PIN_U, PIN_V, PIN_W);
+
+  PWM_TEST_CHECK(inverter.begin(carrierFreq));
+
+  uint32_t top = inverter.get_TOP();
+
+  // 50% with 0 modulation
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[0].cc & 0xffff, (top + 1) / 2);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[0].top, top);
+
+  const PWM_3Phase_Mode  modes[]      = { PWM_3PHASE_SPWM, PWM_3PHASE_SPWM_THI, PWM_3PHASE_SVPWM };
+  const uint16_t         modIndexes[] = { PWM_3PHASE_MI_ONE / 2, PWM_3PHASE_MI_ONE, PWM_3PHASE_MI_MAX };
+
+  double   maxError = 0;
+  uint32_t outside  = 0;
+
+  for (const PWM_3Phase_Mode& mode : modes)
+  {
+    inverter.setMode(mode);
+
+    for (const uint16_t& modIndex : modIndexes)
+    {
+      for (uint32_t angle = 0; angle < 65536; angle += 97)
+      {
+        uint32_t levels[3];
+
+        inverter.compute(angle, modIndex, levels);
+
+        for (uint8_t i = 0; i < 3; i++)
+        {
+          if (levels[i] > top + 1)
+            outside++;
+
+          maxError = fmax(maxError, fabs(levels[i] - referenceLevel(mode, top, angle, modIndex, i)));
+        }
+      }
+    }
+  }
+
+  printf("Carrier %u Hz : TOP = %u, DIV = %u, max error = %.1f counts\n", carrierFreq, top, inverter.get_DIV(), maxError);
+
+  PWM_TEST_EQUAL(outside, 0);
+
+  // Q15 sin table, interpolated : about 1e-4 of the full scale
+  PWM_TEST_CHECK(maxError < 2 + (top + 1) * 2e-4);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// CC word of a high-side level, as written by RP2040_PWM_3Phase
+static uint32_t expectedCC(const uint32_t& level, const uint32_t& top, const uint16_t& deadTime)
+{
+  uint32_t levelB = level + deadTime;
+
+  if (levelB > top + 1)
+    levelB = top + 1;
+
+  return (level << PWM_CH0_CC_A_LSB) | (levelB << PWM_CH0_CC_B_LSB);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Run from start(), with a rotation changed after half of the updates. Every period of the 3 slices must have the CC of
+// the update done at the wrap before the previous one, updates every updateDivider periods
+static void checkRun(const uint16_t& updateDivider, const float& rotation, const float& newRotation)
+{
+  const uint32_t carrierFreq = 20000;
+  const uint16_t deadTime    = 20;
+  const uint16_t modIndex    = PWM_3PHASE_MI_ONE * 3 / 4;
+  const uint16_t startAngle  = 5000;
+  const uint32_t numUpdates  = 40;
+
+  RP2040_PWM_3Phase inverter(PIN_U, PIN_V, PIN_W);
+
+  PWM_TEST_CHECK(inverter.begin(carrierFreq, PWM_3PHASE_SVPWM, deadTime, updateDivider));
+  PWM_TEST_NEAR(inverter.getUpdateRate(), (double) carrierFreq / updateDivider, 1);
+
+  uint32_t top = inverter.get_TOP();
+
+  // Latency of the wrap IRQ, well inside the period
+  mock_sim.irqLatency = 200 * MOCK_SUBCYCLES;
+
+  for (uint8_t i = 0; i < 3; i++)
+    mock_sim_trace(i);
+
+  inverter.setVector(startAngle, modIndex);
+  inverter.setRotation(rotation);
+  inverter.start();
+
+  while (inverter.getUpdateCount() < numUpdates / 2)
+    mock_sim_run_to_wrap(0);
+
+  inverter.setRotation(newRotation);
+
+  while (inverter.getUpdateCount() < numUpdates)
+    mock_sim_run_to_wrap(0);
+
+  inverter.stop();
+
+  mock_sim.irqLatency = 0;
+
+  // CC of each update, same angle steps as handleWrap(). Update 0 is the 50% of begin()
+  std::vector<uint32_t> expected[3];
+  uint32_t levels[3];
+
+  inverter.compute(0, 0, levels);
+
+  for (uint8_t i = 0; i < 3; i++)
+    expected[i].push_back(expectedCC(levels[i], top, deadTime));
+
+  uint32_t anglePhase = (uint32_t) startAngle << 16;
+  uint16_t angle      = startAngle;
+
+  for (uint32_t update = 1; update <= numUpdates; update++)
+  {
+    float   electricalFreq = (update <= numUpdates / 2) ? rotation : newRotation;
+    int32_t angleStep      = (int32_t) (electricalFreq * 65536.0f * 65536.0f / inverter.getUpdateRate());
+
+    if (angleStep)
+    {
+      anglePhase += angleStep;
+      angle = anglePhase >> 16;
+    }
+    else
+    {
+      anglePhase = (uint32_t) angle << 16;
+    }
+
+    inverter.compute(angle, modIndex, levels);
+
+    for (uint8_t i = 0; i < 3; i++)
+      expected[i].push_back(expectedCC(levels[i], top, deadTime));
+  }
+
+  uint32_t wrong = 0;
+  size_t   numPeriods = mock_sim_periods(0).size();
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    const std::vector<PWM_SimPeriod>& periods = mock_sim_periods(i);
+
+    // Slices started together
+    PWM_TEST_EQUAL(periods.size(), numPeriods);
+
+    for (size_t p = 0; p < periods.size(); p++)
+    {
+      // Update u done at the end of period u * updateDivider - 1, latched at the end of the next one
+      size_t update = (p == 0) ? 0 : (p - 1) / updateDivider;
+
+      if (update > numUpdates)
+        update = numUpdates;
+
+      if ( (periods[p].cc != expected[i][update]) && (wrong++ < 4) )
+        printf("Slice %u, period %u : CC = 0x%08X, expected 0x%08X\n", i, (uint) p, periods[p].cc, expected[i][update]);
+
+      PWM_TEST_EQUAL(periods[p].top, top);
+    }
+  }
+
+  printf("Run, updateDivider = %u, rotation %.0f then %.0f Hz : %u periods, %u wrong CC\n", updateDivider, rotation,
+         newRotation, (uint) numPeriods, wrong);
+
+  PWM_TEST_EQUAL(wrong, 0);
+  PWM_TEST_CHECK(numPeriods >= numUpdates * updateDivider);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Host ns per compute(), the work of every update in the wrap IRQ
+static void benchmark()
+{
+  RP2040_PWM_3Phase inverter(PIN_U, PIN_V, PIN_W);
+
+  PWM_TEST_CHECK(inverter.begin(20000));
+
+  const PWM_3Phase_Mode  modes[] = { PWM_3PHASE_SPWM, PWM_3PHASE_SPWM_THI, PWM_3PHASE_SVPWM };
+  const char*            names[] = { "SPWM", "SPWM_THI", "SVPWM" };
+
+  const uint32_t count = 1000000;
+  uint32_t levels[3];
+  uint32_t sum = 0;
+
+  for (uint8_t m = 0; m < 3; m++)
+  {
+    inverter.setMode(modes[m]);
+
+    double ns = PWM_test_host_ns(count, [&](const uint32_t& i)
+    {
+      inverter.compute(i * 7, PWM_3PHASE_MI_ONE, levels);
+      sum += levels[0];
+    });
+
+    printf("compute() %-8s : %.1f ns\n", names[m], ns);
+  }
+
+  // Keeps the calls
+  PWM_TEST_CHECK(sum > 0);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testClaims()
+{
+  const uint slices[3] = { 0, 1, 2 };
+
+  {
+    RP2040_PWM_3Phase inverter(PIN_U, PIN_V, PIN_W);
+
+    PWM_TEST_CHECK(inverter.begin(20000));
+
+    for (const uint& slice_num : slices)
+    {
+      PWM_TEST_CHECK(PWM_slice_data[slice_num].channelA_Active);
+      PWM_TEST_CHECK(PWM_slice_data[slice_num].channelB_Active);
+    }
+
+    inverter.end();
+
+    for (const uint& slice_num : slices)
+    {
+      PWM_TEST_CHECK(!PWM_slice_data[slice_num].channelA_Active);
+      PWM_TEST_CHECK(!PWM_slice_data[slice_num].channelB_Active);
+    }
+
+    PWM_TEST_CHECK(PWM_resourceOwner(PIN_U) == NULL);
+  }
+
+  // Last slice already used : the first two released again
+  PWM_TEST_EQUAL(PWM_resourceClaimSlice(2, &otherUser), PWM_RESOURCE_OK);
+
+  {
+    RP2040_PWM_3Phase inverter(PIN_U, PIN_V, PIN_W);
+
+    PWM_TEST_CHECK(!inverter.begin(20000));
+
+    PWM_TEST_CHECK(PWM_resourceOwner(PIN_U) == NULL);
+    PWM_TEST_CHECK(PWM_resourceOwner(PIN_V) == NULL);
+    PWM_TEST_CHECK(PWM_resourceOwner(PIN_W) == &otherUser);
+    PWM_TEST_CHECK(!PWM_slice_data[0].channelA_Active);
+  }
+
+  // Not released by the destructor of the refused inverter
+  PWM_TEST_CHECK(PWM_resourceOwner(PIN_W + 1) == &otherUser);
+
+  PWM_resourceReleaseAll(&otherUser);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  checkCarrier(20000);
+  // TOP > 32767
+  checkCarrier(1000);
+  // TOP close to 65535
+  checkCarrier(954);
+  // Low carrier, DIV > 1
+  checkCarrier(4);
+
+  checkRun(1, 0, 0);
+  checkRun(3, 50, 200);
+  checkRun(2, 100, 0);
+
+  testClaims();
+  benchmark();
+
+  return PWM_test_report("test_3Phase");
+}
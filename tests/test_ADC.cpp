@@ -0,0 +1,190 @@
+/****************************************************************************************************************************
+  test_ADC.cpp
+  RP2040_PWM_ADC : conversions started at the middle of the on-time, from the wrap of a phase-correct slice or from a
+  delayed trigger slice, one per period, tagged with the index of their period, and overruns of the ring buffer.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_ADC.h"
+
+#include "PWM_Test.h"
+
+#define ADC_PWM_PIN     14
+#define ADC_PWM_SLICE   7
+#define TRIGGER_SLICE   6
+
+// Period of the PWM slice and start time of the sampling, in subcycles
+static uint64_t periodLength;
+static uint64_t startTime;
+
+///////////////////////////////////////////////////////////////////
+
+// Index of the PWM period the conversion was started in, as the sample value. A start at the wrap ending period n
+// belongs to period n
+static uint16_t periodSource(uint input, uint64_t time)
+{
+  (void) input;
+
+  return ( (time - startTime - 1) / periodLength ) & 0xfff;
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Sample for 100 periods. Return the largest distance, in cycles, of the conversion starts to the expected point
+static double checkSampling(RP2040_PWM_ADC& adc, const uint32_t& expectedTicks)
+{
+  mock_sim.adcSource = periodSource;
+  mock_sim.adcTrace  = true;
+  mock_sim.adcStarts.clear();
+
+  PWM_TEST_CHECK(adc.start());
+
+  startTime = mock_sim.now;
+
+  mock_sim_run_us(100 * periodLength / MOCK_SUBCYCLES_PER_US);
+
+  // One per period, the last one may still be converting
+  PWM_TEST_NEAR(adc.getSampleCount(), 100, 1);
+
+  PWM_ADC_Sample sample;
+  uint32_t       count = 0, wrong = 0;
+
+  while (adc.read(sample))
+  {
+    if ( (sample.period != count) || (sample.value != (sample.period & 0xfff) ) )
+    {
+      if (wrong++ < 4)
+        printf("Sample %u : period = %u, value = %u\n", count, sample.period, sample.value);
+    }
+
+    count++;
+  }
+
+  PWM_TEST_EQUAL(wrong, 0);
+  PWM_TEST_EQUAL(count, adc.getSampleCount());
+  PWM_TEST_EQUAL(adc.getOverruns(), 0);
+
+  double maxDistance = 0;
+
+  for (const uint64_t& start : mock_sim.adcStarts)
+  {
+    uint64_t offset = (start - startTime) % periodLength;
+    double   ticks  = (double) offset / MOCK_SUBCYCLES;
+
+    maxDistance = fmax(maxDistance, fabs(ticks - expectedTicks));
+  }
+
+  adc.stop();
+
+  mock_sim.adcTrace = false;
+
+  return maxDistance;
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Phase-correct : the wrap at counter 0 is the middle of the on-time
+static void testSameSlice()
+{
+  RP2040_PWM PWM_Instance(ADC_PWM_PIN, 20000, 30, true);
+
+  PWM_TEST_CHECK(PWM_Instance.setPWM(ADC_PWM_PIN, 20000, 30, true));
+
+  RP2040_PWM_ADC adc(ADC_PWM_PIN);
+
+  PWM_TEST_CHECK(adc.begin(0));
+  PWM_TEST_EQUAL(adc.getTriggerSlice(), ADC_PWM_SLICE);
+  PWM_TEST_EQUAL(adc.getCenterDelay(), 0);
+  PWM_TEST_NEAR(adc.getSampleRate(), 20000, 1);
+
+  periodLength = (uint64_t) 2 * (mock_pwm_hw.slice[ADC_PWM_SLICE].top + 1) * MOCK_SUBCYCLES;
+
+  double distance = checkSampling(adc, 0);
+
+  printf("Same slice : conversions started %.1f cycles from the wrap\n", distance);
+
+  // DMA write only
+  PWM_TEST_CHECK(distance < 4);
+
+  // Delay refused without a trigger slice
+  PWM_TEST_CHECK(!adc.begin(0, PWM_ADC_SAME_SLICE, 100));
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Edge-aligned : a spare slice triggers in the middle of the on-time, level / 2 after the wrap
+static void testTriggerSlice()
+{
+  RP2040_PWM PWM_Instance(ADC_PWM_PIN, 20000, 30);
+
+  PWM_TEST_CHECK(PWM_Instance.setPWM(ADC_PWM_PIN, 20000, 30));
+
+  RP2040_PWM_ADC adc(ADC_PWM_PIN);
+
+  // Center delay read from the slice, once configured
+  PWM_TEST_CHECK(adc.begin(0, TRIGGER_SLICE, 0));
+
+  uint32_t delay = adc.getCenterDelay();
+
+  PWM_TEST_EQUAL(delay, (mock_pwm_hw.slice[ADC_PWM_SLICE].cc & 0xffff) / 2);
+  PWM_TEST_CHECK(adc.begin(0, TRIGGER_SLICE, delay));
+  PWM_TEST_EQUAL(adc.getTriggerSlice(), TRIGGER_SLICE);
+
+  periodLength = (uint64_t) (mock_pwm_hw.slice[ADC_PWM_SLICE].top + 1) * MOCK_SUBCYCLES;
+
+  double distance = checkSampling(adc, delay);
+
+  printf("Trigger slice : conversions started %.1f cycles from the middle of the on-time\n", distance);
+
+  PWM_TEST_CHECK(distance < 4);
+
+  // The trigger slice is the one of the PWM slice, or its delay a whole period
+  PWM_TEST_CHECK(!adc.begin(0, ADC_PWM_SLICE, delay));
+  PWM_TEST_CHECK(!adc.begin(0, TRIGGER_SLICE, 6250));
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Not read for more than the ring : the oldest samples are lost and counted
+static void testOverrun()
+{
+  RP2040_PWM PWM_Instance(ADC_PWM_PIN, 100000, 50, true);
+
+  PWM_TEST_CHECK(PWM_Instance.setPWM(ADC_PWM_PIN, 100000, 50, true));
+
+  RP2040_PWM_ADC adc(ADC_PWM_PIN);
+
+  PWM_TEST_CHECK(adc.begin(0));
+  PWM_TEST_CHECK(adc.start());
+
+  mock_sim_run_us(10 * (PWM_ADC_RING_SIZE + 100));
+
+  uint32_t count = adc.getSampleCount();
+
+  PWM_TEST_EQUAL(adc.available(), PWM_ADC_RING_SIZE - 1);
+
+  PWM_ADC_Sample sample;
+
+  PWM_TEST_CHECK(adc.read(sample));
+  PWM_TEST_EQUAL(sample.period, count - (PWM_ADC_RING_SIZE - 1));
+  PWM_TEST_EQUAL(adc.getOverruns(), count - (PWM_ADC_RING_SIZE - 1));
+
+  PWM_TEST_CHECK(adc.readLatest(sample));
+  PWM_TEST_EQUAL(sample.period, count - 1);
+  PWM_TEST_CHECK(!adc.read(sample));
+
+  adc.end();
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testSameSlice();
+  testTriggerSlice();
+  testOverrun();
+
+  return PWM_test_report("test_ADC");
+}
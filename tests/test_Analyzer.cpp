@@ -0,0 +1,140 @@
+/****************************************************************************************************************************
+  test_Analyzer.cpp
+  RP2040_PWM_Analyzer run on the simulated slice : one CSV line per point, errors of the frequency and duty mapping
+  within the resolution of TOP / DIV, and the call costs measured with the host clock. Printed as a baseline.
+  Frequency changes measured solved and from the operating-point cache, the cache left as before run().
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Analyzer.h"
+
+#include "PWM_Test.h"
+
+#define ANALYZER_PIN    2
+
+///////////////////////////////////////////////////////////////////
+
+static void testRun()
+{
+  RP2040_PWM_Analyzer analyzer(ANALYZER_PIN);
+
+  // Points cached by the other instances
+  const float cached[] = { 1234.0f, 25000.0f };
+
+  PWM_opCacheClear();
+  PWM_opCachePreload(cached, 2);
+
+  PWM_OpCache_Stats cacheStats = PWM_opCacheStats();
+
+  PrintString csv;
+
+  analyzer.setFreqRange(10.0f, 1000000.0f, 4);
+  analyzer.setDutySteps(5);
+
+  // Host time of the calls
+  mock_sim.hostClock = true;
+
+  uint32_t count = analyzer.run(&csv);
+
+  mock_sim.hostClock = false;
+
+  const PWM_Analyzer_Stats& stats = analyzer.getStats();
+
+  // 2 x (5 decades x 4 + 1) frequencies x 5 duties
+  PWM_TEST_EQUAL(count, 2 * 21 * 5);
+  PWM_TEST_EQUAL(stats.points, count);
+  PWM_TEST_EQUAL(stats.failed, 0);
+  PWM_TEST_EQUAL(stats.costPoints, 2 * 21);
+
+  // Header + one line per point
+  size_t lines = 0;
+
+  for (char c : csv.text)
+    lines += (c == '\n');
+
+  PWM_TEST_EQUAL(lines, count + 1);
+
+  // Cache and statistics as before
+  PWM_TEST_CHECK(PWM_opCacheLookup(cached[0], false) != NULL);
+  PWM_TEST_CHECK(PWM_opCacheLookup(cached[1], false) != NULL);
+  PWM_TEST_EQUAL(PWM_opCacheStats().hits,      cacheStats.hits);
+  PWM_TEST_EQUAL(PWM_opCacheStats().misses,    cacheStats.misses);
+  PWM_TEST_EQUAL(PWM_opCacheStats().evictions, cacheStats.evictions);
+  PWM_TEST_EQUAL(PWM_opCacheStats().clock,     cacheStats.clock);
+
+  // Lowest resolution at 1MHz phase-correct, TOP = 62. Frequency : half a count. Duty : 2 levels
+  PWM_TEST_CHECK(stats.maxFreqError < 1e6 / 62 / 2);
+  PWM_TEST_CHECK(stats.maxDutyError < 2e6 / 62);
+  PWM_TEST_CHECK(stats.minBits > 5);
+  PWM_TEST_CHECK(stats.maxBits > 15);
+
+  PrintString summary;
+
+  analyzer.printSummary(summary);
+  analyzer.printHistograms(summary);
+
+  printf("%s\n", summary.text.c_str());
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Solved cost from frequency changes all missing the cache, cached cost from frequency changes all hitting it
+static void testCost()
+{
+  RP2040_PWM_Analyzer analyzer(ANALYZER_PIN);
+
+  const uint16_t repeats = 50;
+
+  analyzer.setCostRepeats(repeats);
+
+  for (const float& frequency : { 100.0f, 20000.0f, 62500000.0f })
+  {
+    PWM_opCacheResetStats();
+
+    analyzer.measureCost(frequency, 30000, false);
+
+    // Misses : the solved loop, then otherFreq cached. Hits : frequency still cached after the solved loop, the cached
+    // loop, and back to frequency for the dutycycle loop
+    PWM_TEST_EQUAL(PWM_opCacheStats().misses, repeats + 1);
+    PWM_TEST_EQUAL(PWM_opCacheStats().hits,   1 + repeats + 1);
+  }
+
+  mock_sim.hostClock = true;
+
+  analyzer.measureCost(20000.0f, 30000, false);
+
+  mock_sim.hostClock = false;
+
+  printf("Frequency change at 20KHz, ns : solved %u, cached %u, dutycycle change %u\n", analyzer.getFreqCost(),
+         analyzer.getFreqCostCached(), analyzer.getDutyCost());
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testRelease()
+{
+  {
+    RP2040_PWM_Analyzer analyzer(ANALYZER_PIN);
+
+    PWM_Analyzer_Point point;
+
+    PWM_TEST_CHECK(analyzer.analyzePoint(1000.0f, 50000, false, point));
+    PWM_TEST_CHECK(PWM_resourceOwner(ANALYZER_PIN) == analyzer.getPWM());
+  }
+
+  // Instance deleted with the analyzer, channel free
+  PWM_TEST_CHECK(PWM_resourceOwner(ANALYZER_PIN) == NULL);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testRun();
+  testCost();
+  testRelease();
+
+  return PWM_test_report("test_Analyzer");
+}
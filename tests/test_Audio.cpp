@@ -0,0 +1,117 @@
+/****************************************************************************************************************************
+  test_Audio.cpp
+  RP2040_PWM_Audio : samples are played at the DMA timer rate of the last begin(), also when the DMA channels and timer
+  are kept from a previous begin(). A failed claim must not leak channels.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Audio.h"
+
+#include "PWM_Test.h"
+
+#define AUDIO_PIN         0
+#define AUDIO_FRAMES      2000
+#define AUDIO_LEVEL       200
+
+static uint8_t samples[AUDIO_FRAMES];
+
+///////////////////////////////////////////////////////////////////
+
+// Play the samples at srcRate = sampleRate, and return the time the level was output, in us
+static double playTime(RP2040_PWM_Audio& audio)
+{
+  mock_sim_trace(0, false);
+  mock_sim_trace(0);
+
+  PWM_TEST_CHECK(audio.play(samples, AUDIO_FRAMES, PWM_AUDIO_FORMAT_U8, 1, (uint32_t) audio.getActualSampleRate(), false));
+
+  uint64_t timeout = time_us_64() + 1000000;
+
+  while (audio.isPlaying() && (time_us_64() < timeout) )
+    mock_sim_run_us(100);
+
+  PWM_TEST_CHECK(!audio.isPlaying());
+
+  uint64_t length = 0;
+
+  for (const PWM_SimPeriod& period : mock_sim_periods(0))
+  {
+    if ( (period.cc & 0xffff) == AUDIO_LEVEL)
+      length += period.length;
+  }
+
+  mock_sim_trace(0, false);
+
+  return (double) length / MOCK_SUBCYCLES_PER_US;
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testRateChange()
+{
+  RP2040_PWM_Audio audio(AUDIO_PIN);
+
+  memset(samples, AUDIO_LEVEL, sizeof(samples));
+
+  PWM_TEST_CHECK(audio.begin(22050));
+  PWM_TEST_NEAR(audio.getActualSampleRate(), 22050, 1);
+
+  double time22 = playTime(audio);
+
+  // A new begin() keeps the claimed channels and timer, but must pace them at the new rate
+  PWM_TEST_CHECK(audio.begin(44100));
+  PWM_TEST_NEAR(audio.getActualSampleRate(), 44100, 1);
+
+  double time44 = playTime(audio);
+
+  printf("%u frames : %.0f us at 22050, %.0f us at 44100\n", AUDIO_FRAMES, time22, time44);
+
+  PWM_TEST_NEAR(time22, 1e6 * AUDIO_FRAMES / 22050.0, 2e6 / 22050.0);
+  PWM_TEST_NEAR(time44, 1e6 * AUDIO_FRAMES / 44100.0, 2e6 / 44100.0);
+
+  // Only 2 channels were claimed by the 2 begin()
+  int channel = dma_claim_unused_channel(false);
+
+  PWM_TEST_EQUAL(channel, 2);
+  dma_channel_unclaim(channel);
+
+  audio.stop();
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testClaimFailure()
+{
+  mock_sim_reset();
+
+  // No DMA timer left
+  for (uint timer = 0; timer < NUM_DMA_TIMERS; timer++)
+    dma_timer_claim(timer);
+
+  RP2040_PWM_Audio audio(AUDIO_PIN);
+
+  PWM_TEST_CHECK(!audio.begin(22050));
+
+  // Both channels claimed before the failure are free again
+  PWM_TEST_EQUAL(dma_claim_unused_channel(false), 0);
+  PWM_TEST_EQUAL(dma_claim_unused_channel(false), 1);
+
+  dma_channel_unclaim(0);
+  dma_channel_unclaim(1);
+  dma_timer_unclaim(0);
+
+  PWM_TEST_CHECK(audio.begin(22050));
+  PWM_TEST_NEAR(audio.getActualSampleRate(), 22050, 1);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testRateChange();
+  testClaimFailure();
+
+  return PWM_test_report("test_Audio");
+}
@@ -0,0 +1,114 @@
+/****************************************************************************************************************************
+  test_Burst.cpp
+  RP2040_PWM_Burst : exact number of pulses per burst and of periods per gap. Above PWM_BURST_IRQ_MAX_FREQUENCY the
+  wraps are counted by DMA, exact with any IRQ latency. The whole slice is claimed, as start() restarts it.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Burst.h"
+
+#include "PWM_Test.h"
+
+#define BURST_PIN       6
+#define SIBLING_PIN     7
+#define BURST_SLICE     3
+
+///////////////////////////////////////////////////////////////////
+
+// Run the burst, and return the pattern of the periods output : 1 for a pulse, 0 for a zero level
+static std::string runBurst(RP2040_PWM_Burst& burst)
+{
+  mock_sim_trace(BURST_SLICE, false);
+  mock_sim_trace(BURST_SLICE);
+
+  PWM_TEST_CHECK(burst.start());
+
+  uint64_t timeout = time_us_64() + 100000;
+
+  while (burst.isRunning() && (time_us_64() < timeout) )
+    mock_sim_run_us(100);
+
+  PWM_TEST_CHECK(burst.isDone());
+  PWM_TEST_CHECK(!mock_sim_output(BURST_SLICE, 0));
+
+  std::string pattern;
+
+  for (const PWM_SimPeriod& period : mock_sim_periods(BURST_SLICE))
+    pattern += PWM_test_high_counts(period, 0) ? '1' : '0';
+
+  mock_sim_trace(BURST_SLICE, false);
+
+  // Zero level periods after the last pulse, until the slice is stopped
+  pattern.erase(pattern.find_last_not_of('0') + 1);
+
+  return pattern;
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testBurstIRQ()
+{
+  RP2040_PWM_Burst burst(BURST_PIN);
+
+  PWM_TEST_CHECK(burst.setBurst(10000.0f, 50.0f, 3, 2, 2));
+  PWM_TEST_EQUAL(burst.getMode(), PWM_BURST_IRQ);
+
+  PWM_TEST_CHECK(runBurst(burst) == "11100111");
+  PWM_TEST_EQUAL(burst.getBurstCount(), 2);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// IRQ latency longer than a period : the wraps would be missed from the IRQ
+static void testHighFrequency()
+{
+  mock_sim.irqLatency = 2 * 125 * MOCK_SUBCYCLES;
+
+  RP2040_PWM_Burst burst(BURST_PIN);
+
+  PWM_TEST_CHECK(burst.setBurst(1000000.0f, 50.0f, 10));
+  PWM_TEST_EQUAL(burst.getMode(), PWM_BURST_DMA);
+
+  PWM_TEST_CHECK(runBurst(burst) == std::string(10, '1'));
+  PWM_TEST_EQUAL(burst.getBurstCount(), 1);
+
+  // Repeated bursts need the IRQ
+  PWM_TEST_CHECK(!burst.setBurst(1000000.0f, 50.0f, 10, 2, 5));
+  PWM_TEST_CHECK(burst.setBurst(PWM_BURST_IRQ_MAX_FREQUENCY, 50.0f, 10, 2, 5));
+  PWM_TEST_EQUAL(burst.getMode(), PWM_BURST_IRQ);
+
+  mock_sim.irqLatency = 0;
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testSliceClaim()
+{
+  RP2040_PWM_Burst burst(BURST_PIN);
+  RP2040_PWM_Burst other(BURST_PIN);
+
+  PWM_TEST_CHECK(burst.setBurst(10000.0f, 50.0f, 3));
+  PWM_TEST_CHECK(burst.start());
+
+  // The other channel of the slice belongs to the burst too
+  PWM_TEST_CHECK(PWM_resourceOwner(BURST_PIN)   == &burst);
+  PWM_TEST_CHECK(PWM_resourceOwner(SIBLING_PIN) == &burst);
+  PWM_TEST_EQUAL(PWM_resourceClaim(SIBLING_PIN, &other, burst.get_TOP(), burst.get_DIV(), false), PWM_RESOURCE_BUSY);
+
+  burst.stop();
+
+  PWM_TEST_CHECK(PWM_resourceOwner(SIBLING_PIN) == NULL);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testBurstIRQ();
+  testHighFrequency();
+  testSliceClaim();
+
+  return PWM_test_report("test_Burst");
+}
@@ -0,0 +1,172 @@
+/****************************************************************************************************************************
+  test_OpCache.cpp
+  Operating-point cache : a cached transition must program the same registers as a solved one, for setPWM_Int() and
+  setPWMPushPull_Int(), with hits, misses and LRU evictions counted. Benchmark of cached versus uncached transitions.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+
+#include "PWM_Test.h"
+
+#define SINGLE_PIN      2
+#define SINGLE_SLICE    1
+#define PUSHPULL_PIN_A  6
+#define PUSHPULL_PIN_B  7
+#define PUSHPULL_SLICE  3
+
+static const float    frequencies[] = { 100.0f, 1000.0f, 2500.0f, 20000.0f };
+static const uint8_t  numFrequencies = sizeof(frequencies) / sizeof(frequencies[0]);
+
+///////////////////////////////////////////////////////////////////
+
+static void readRegisters(const uint& slice_num, uint32_t* regs)
+{
+  regs[0] = mock_pwm_hw.slice[slice_num].csr;
+  regs[1] = mock_pwm_hw.slice[slice_num].div;
+  regs[2] = mock_pwm_hw.slice[slice_num].top;
+  regs[3] = mock_pwm_hw.slice[slice_num].cc;
+}
+
+///////////////////////////////////////////////////////////////////
+
+// First pass solved, second pass from the cache : same registers
+template<typename Function> void checkTransitions(const char* name, const uint& slice_num, Function setFrequency)
+{
+  uint32_t solved[numFrequencies][4];
+  uint32_t cached[4];
+
+  PWM_opCacheClear();
+  PWM_opCacheResetStats();
+
+  for (uint8_t i = 0; i < numFrequencies; i++)
+  {
+    PWM_TEST_CHECK(setFrequency(frequencies[i]));
+    readRegisters(slice_num, solved[i]);
+  }
+
+  PWM_TEST_EQUAL(PWM_opCacheStats().hits,   0);
+  PWM_TEST_EQUAL(PWM_opCacheStats().misses, numFrequencies);
+
+  for (uint8_t i = 0; i < numFrequencies; i++)
+  {
+    PWM_TEST_CHECK(setFrequency(frequencies[i]));
+    readRegisters(slice_num, cached);
+
+    for (uint8_t reg = 0; reg < 4; reg++)
+    {
+      if (cached[reg] != solved[i][reg])
+        printf("%s at %.0f Hz : register %u = 0x%X, solved 0x%X\n", name, frequencies[i], reg, cached[reg], solved[i][reg]);
+
+      PWM_TEST_EQUAL(cached[reg], solved[i][reg]);
+    }
+  }
+
+  PWM_TEST_EQUAL(PWM_opCacheStats().hits,   numFrequencies);
+  PWM_TEST_EQUAL(PWM_opCacheStats().misses, numFrequencies);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testTransitions()
+{
+  RP2040_PWM PWM_Single(SINGLE_PIN, 1000, 30);
+  RP2040_PWM PWM_PushPull(PUSHPULL_PIN_A, 1000, 30);
+
+  checkTransitions("setPWM_Int()", SINGLE_SLICE, [&](const float& frequency)
+  {
+    return PWM_Single.setPWM_Int(SINGLE_PIN, frequency, 30000);
+  });
+
+  checkTransitions("setPWMPushPull_Int()", PUSHPULL_SLICE, [&](const float& frequency)
+  {
+    return PWM_PushPull.setPWMPushPull_Int(PUSHPULL_PIN_A, PUSHPULL_PIN_B, frequency, 30000);
+  });
+
+  // Same frequency in phase-correct and normal mode : 2 different points
+  PWM_TEST_CHECK(PWM_opCacheLookup(1000.0f, true)  != NULL);
+  PWM_TEST_CHECK(PWM_opCacheLookup(1000.0f, false) == NULL);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testEviction()
+{
+  float preload[PWM_OP_CACHE_SIZE];
+
+  PWM_opCacheClear();
+  PWM_opCacheResetStats();
+
+  for (uint8_t i = 0; i < PWM_OP_CACHE_SIZE; i++)
+    preload[i] = 1000.0f * (i + 1);
+
+  PWM_TEST_EQUAL(PWM_opCachePreload(preload, PWM_OP_CACHE_SIZE), PWM_OP_CACHE_SIZE);
+  PWM_TEST_EQUAL(PWM_opCacheStats().evictions, 0);
+
+  // First one used again, so the second one is the least recently used
+  PWM_TEST_CHECK(PWM_opCacheFind(preload[0], false) != NULL);
+
+  float newFrequency = 123456.0f;
+
+  PWM_TEST_EQUAL(PWM_opCachePreload(&newFrequency, 1), 1);
+  PWM_TEST_EQUAL(PWM_opCacheStats().evictions, 1);
+
+  PWM_TEST_CHECK(PWM_opCacheLookup(preload[0], false)  != NULL);
+  PWM_TEST_CHECK(PWM_opCacheLookup(preload[1], false)  == NULL);
+  PWM_TEST_CHECK(PWM_opCacheLookup(newFrequency, false) != NULL);
+
+  // Out of range, not cached
+  float tooHigh = 2 * MAX_PWM_FREQUENCY;
+
+  PWM_TEST_EQUAL(PWM_opCachePreload(&tooHigh, 1), 0);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Host ns per frequency change, cycling through the frequencies, solved every time or from the cache
+static void benchmark()
+{
+  RP2040_PWM PWM_Single(SINGLE_PIN, 1000, 30);
+  RP2040_PWM PWM_PushPull(PUSHPULL_PIN_A, 1000, 30);
+
+  const uint32_t count = 20000;
+
+  double single[2], pushPull[2];
+
+  for (uint8_t withCache = 0; withCache < 2; withCache++)
+  {
+    PWM_opCacheClear();
+
+    single[withCache] = PWM_test_host_ns(count, [&](const uint32_t& i)
+    {
+      if (!withCache)
+        PWM_opCacheClear();
+
+      PWM_Single.setPWM_Int(SINGLE_PIN, frequencies[i % numFrequencies], 30000);
+    });
+
+    pushPull[withCache] = PWM_test_host_ns(count, [&](const uint32_t& i)
+    {
+      if (!withCache)
+        PWM_opCacheClear();
+
+      PWM_PushPull.setPWMPushPull_Int(PUSHPULL_PIN_A, PUSHPULL_PIN_B, frequencies[i % numFrequencies], 30000);
+    });
+  }
+
+  printf("Frequency change, ns per call  : uncached, cached\n");
+  printf("  setPWM_Int()                 : %8.1f, %8.1f\n", single[0],   single[1]);
+  printf("  setPWMPushPull_Int()         : %8.1f, %8.1f\n", pushPull[0], pushPull[1]);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testTransitions();
+  testEviction();
+  benchmark();
+
+  return PWM_test_report("test_OpCache");
+}
@@ -0,0 +1,253 @@
+/****************************************************************************************************************************
+  test_Resource.cpp
+  PWM resource ownership : one table for all the translation units, channels released by ~RP2040_PWM() and by the
+  stop / end of the classes claiming whole slices, so that another user can claim them.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Sweep.h"
+#include "RP2040_PWM_Burst.h"
+#include "RP2040_PWM_Audio.h"
+#include "RP2040_PWM_3Phase.h"
+#include "RP2040_PWM_ADC.h"
+#include "RP2040_PWM_Sequencer.h"
+
+#include "PWM_Test.h"
+
+// test_Resource_Other.cpp
+PWM_Resource_Status otherClaim(const uint8_t& pin, const void* owner);
+const void*         otherOwner(const uint8_t& pin);
+
+// Any user of a channel
+static int otherUser;
+
+///////////////////////////////////////////////////////////////////
+
+static void testTranslationUnits()
+{
+  RP2040_PWM PWM_Instance(0, 1000, 50);
+
+  PWM_TEST_CHECK(PWM_Instance.setPWM());
+
+  // Seen from the other .cpp, and claims from there seen here
+  PWM_TEST_CHECK(otherOwner(0) == &PWM_Instance);
+  PWM_TEST_EQUAL(otherClaim(0, &otherUser), PWM_RESOURCE_BUSY);
+  // TOP / DIV of the slice set by setPWM() from here
+  PWM_TEST_EQUAL(otherClaim(1, &otherUser), PWM_RESOURCE_SLICE_CONFLICT);
+  PWM_TEST_EQUAL(otherClaim(3, &otherUser), PWM_RESOURCE_OK);
+  PWM_TEST_CHECK(PWM_resourceOwner(3) == &otherUser);
+
+  PWM_resourceRelease(3, &otherUser);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testDestructor()
+{
+  {
+    RP2040_PWM PWM_Instance(2, 1000, 50);
+
+    PWM_TEST_CHECK(PWM_Instance.setPWM());
+    PWM_TEST_CHECK(PWM_resourceOwner(2) == &PWM_Instance);
+  }
+
+  PWM_TEST_CHECK(PWM_resourceOwner(2) == NULL);
+
+  RP2040_PWM* PWM_Instance = new RP2040_PWM(2, 2000, 50);
+
+  PWM_TEST_CHECK(PWM_Instance->setPWM());
+  PWM_TEST_CHECK(PWM_resourceOwner(2) == PWM_Instance);
+
+  delete PWM_Instance;
+
+  PWM_TEST_CHECK(PWM_resourceOwner(2) == NULL);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testSweepBurst()
+{
+  RP2040_PWM_Sweep sweep(4);
+
+  PWM_TEST_CHECK(sweep.setSweep(1000.0f, 2000.0f, 10.0f, 50.0f, PWM_SWEEP_LINEAR, 1));
+  PWM_TEST_CHECK(sweep.start());
+  PWM_TEST_CHECK(PWM_resourceOwner(5) == &sweep);
+
+  // Released at the end of the sweeps
+  mock_sim_run_us(20000);
+
+  PWM_TEST_CHECK(sweep.isFinished());
+  PWM_TEST_CHECK(PWM_resourceOwner(4) == NULL);
+  PWM_TEST_CHECK(PWM_resourceOwner(5) == NULL);
+
+  RP2040_PWM_Burst burst(4);
+
+  PWM_TEST_CHECK(burst.setBurst(10000.0f, 50.0f, 5));
+  PWM_TEST_CHECK(burst.start());
+  PWM_TEST_CHECK(PWM_resourceOwner(5) == &burst);
+
+  mock_sim_run_us(1000);
+
+  PWM_TEST_CHECK(burst.isDone());
+  PWM_TEST_CHECK(PWM_resourceOwner(4) == NULL);
+
+  // And by stop()
+  PWM_TEST_CHECK(burst.start());
+  PWM_TEST_CHECK(PWM_resourceOwner(4) == &burst);
+
+  burst.stop();
+
+  PWM_TEST_CHECK(PWM_resourceOwner(4) == NULL);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testEnd()
+{
+  {
+    RP2040_PWM_Audio audio(6);
+
+    PWM_TEST_CHECK(audio.begin(22050));
+    PWM_TEST_CHECK(PWM_resourceOwner(7) == &audio);
+
+    audio.end();
+
+    PWM_TEST_CHECK(PWM_resourceOwner(6) == NULL);
+    PWM_TEST_CHECK(PWM_resourceOwner(7) == NULL);
+
+    // DMA channels and timer free again
+    PWM_TEST_EQUAL(dma_claim_unused_channel(false), 0);
+    PWM_TEST_EQUAL(dma_claim_unused_timer(false), 0);
+
+    dma_channel_unclaim(0);
+    dma_timer_unclaim(0);
+
+    // By the destructor
+    PWM_TEST_CHECK(audio.begin(22050));
+  }
+
+  PWM_TEST_CHECK(PWM_resourceOwner(6) == NULL);
+  PWM_TEST_EQUAL(dma_claim_unused_channel(false), 0);
+
+  dma_channel_unclaim(0);
+
+  {
+    RP2040_PWM_3Phase inverter(8, 10, 12);
+
+    PWM_TEST_CHECK(inverter.begin(20000));
+
+    inverter.start();
+
+    PWM_TEST_CHECK(PWM_resourceOwner(13) == &inverter);
+  }
+
+  PWM_TEST_CHECK(PWM_resourceOwner(8)  == NULL);
+  PWM_TEST_CHECK(PWM_resourceOwner(13) == NULL);
+  PWM_TEST_EQUAL(mock_pwm_hw.inte, 0);
+
+  RP2040_PWM PWM_Instance(14, 10000, 50);
+
+  PWM_TEST_CHECK(PWM_Instance.setPWM());
+
+  {
+    RP2040_PWM_ADC adc(14);
+
+    PWM_TEST_CHECK(adc.begin(0, 0));
+    PWM_TEST_CHECK(adc.start());
+    PWM_TEST_CHECK(PWM_resourceOwner(0) == &adc);
+  }
+
+  // Trigger slice released, the PWM slice is kept
+  PWM_TEST_CHECK(PWM_resourceOwner(0)  == NULL);
+  PWM_TEST_CHECK(PWM_resourceOwner(14) == &PWM_Instance);
+  PWM_TEST_EQUAL(dma_claim_unused_channel(false), 0);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static uint claimedAlarms()
+{
+  uint count = 0;
+
+  for (uint i = 0; i < NUM_TIMERS; i++)
+    count += mock_sim.alarm[i].claimed;
+
+  return count;
+}
+
+// Destroyed while running, with a new DIV waiting for the next wrap
+static void testSequencer()
+{
+  // 110us ticks : the frequency change at 550us, the next wrap at 600us
+  static const PWM_Seq_Op script[] =
+  {
+    /* 0 */ PWM_SEQ_OP_FREQ    (0, 8, 10000),
+    /* 1 */ PWM_SEQ_OP_DUTY    (0, 8, 50000),
+    /* 2 */ PWM_SEQ_OP_ENABLE  (0, 8),
+    /* 3 */ PWM_SEQ_OP_FREQ    (5, 8, 100),
+    /* 4 */ PWM_SEQ_OP_FREQ    (5, 8, 10000),
+    /* 5 */ PWM_SEQ_OP_JUMP    (0, 3)
+  };
+
+  uint alarms = claimedAlarms();
+
+  {
+    RP2040_PWM_Sequencer sequencer(110);
+
+    PWM_TEST_CHECK(sequencer.attachPin(8));
+    PWM_TEST_CHECK(sequencer.load(script, sizeof(script) / sizeof(script[0])));
+    PWM_TEST_CHECK(sequencer.start());
+    PWM_TEST_CHECK(PWM_resourceOwner(9) == &sequencer);
+    PWM_TEST_EQUAL(claimedAlarms(), alarms + 1);
+
+    mock_sim_run_us(560);
+
+    PWM_TEST_EQUAL(mock_pwm_hw.inte, 1 << 4);
+    PWM_TEST_EQUAL(mock_pwm_hw.slice[4].div, 1 << PWM_CH0_DIV_INT_LSB);
+  }
+
+  PWM_TEST_CHECK(PWM_resourceOwner(8) == NULL);
+  PWM_TEST_CHECK(PWM_resourceOwner(9) == NULL);
+  PWM_TEST_EQUAL(claimedAlarms(), alarms);
+  PWM_TEST_EQUAL(mock_pwm_hw.inte, 0);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[4].div, PWM_slice_shadow_data[4].div);
+  PWM_TEST_CHECK(mock_pwm_hw.slice[4].div > (1 << PWM_CH0_DIV_INT_LSB));
+
+  for (uint i = 0; i < PWM_SEQ_NUM_ALARMS; i++)
+    PWM_TEST_CHECK(PWM_Sequencer_instance[i] == NULL);
+
+  // No alarm nor wrap IRQ left on the destroyed sequencer
+  mock_sim_run_us(2000);
+
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[4].div, PWM_slice_shadow_data[4].div);
+
+  // end() before the destructor, then the slice free for another user
+  RP2040_PWM_Sequencer sequencer;
+
+  PWM_TEST_CHECK(sequencer.attachPin(8));
+  PWM_TEST_CHECK(sequencer.load(script, sizeof(script) / sizeof(script[0])));
+  PWM_TEST_CHECK(sequencer.start());
+
+  sequencer.end();
+
+  PWM_TEST_CHECK(!sequencer.isRunning());
+  PWM_TEST_EQUAL(claimedAlarms(), alarms);
+  PWM_TEST_EQUAL(PWM_resourceClaimSlice(4, &otherUser), PWM_RESOURCE_OK);
+
+  PWM_resourceReleaseAll(&otherUser);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testTranslationUnits();
+  testDestructor();
+  testSweepBurst();
+  testEnd();
+  testSequencer();
+
+  return PWM_test_report("test_Resource");
+}
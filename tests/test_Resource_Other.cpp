@@ -0,0 +1,22 @@
+/****************************************************************************************************************************
+  test_Resource_Other.cpp
+  Second translation unit of test_Resource : claims and owners seen from another .cpp including RP2040_PWM.h
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+
+///////////////////////////////////////////////////////////////////
+
+PWM_Resource_Status otherClaim(const uint8_t& pin, const void* owner)
+{
+  return PWM_resourceClaim(pin, owner, 1000, 1, false);
+}
+
+///////////////////////////////////////////////////////////////////
+
+const void* otherOwner(const uint8_t& pin)
+{
+  return PWM_resourceOwner(pin);
+}
@@ -0,0 +1,334 @@
+/****************************************************************************************************************************
+  test_Sequencer.cpp
+  RP2040_PWM_Sequencer : timing of the ops, and frequency changes needing a new DIV on a running slice. With no IRQ
+  latency, every period must be entirely of the old or of the new frequency, never the old TOP with the new DIV or
+  the reverse. Then each opcode run by execute(), the checks of load(), and the host speed of execute().
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Sequencer.h"
+
+#include "PWM_Test.h"
+
+#define SEQ_PIN         10
+#define SEQ_SLICE       5
+
+// Ops run by execute() only, without alarm
+#define OP_PIN_A        12
+#define OP_PIN_B        13
+#define OP_SLICE        6
+
+// 100us ticks
+static const PWM_Seq_Op script[] =
+{
+  /* 0 */ PWM_SEQ_OP_FREQ    (  0, SEQ_PIN, 10000),
+  /* 1 */ PWM_SEQ_OP_DUTY    (  0, SEQ_PIN, 50000),
+  /* 2 */ PWM_SEQ_OP_ENABLE  (  0, SEQ_PIN),
+  // DIV 1 to 20
+  /* 3 */ PWM_SEQ_OP_FREQ    ( 13, SEQ_PIN,   100),
+  // DIV 20 to 1
+  /* 4 */ PWM_SEQ_OP_FREQ    (347, SEQ_PIN, 10000),
+  // DIV 1 to 2, then disabled at the same time
+  /* 5 */ PWM_SEQ_OP_FREQ    (100, SEQ_PIN,  1000),
+  /* 6 */ PWM_SEQ_OP_DISABLE (  0, SEQ_PIN),
+  /* 7 */ PWM_SEQ_OP_END     (  0)
+};
+
+///////////////////////////////////////////////////////////////////
+
+static void testFrequencyChange()
+{
+  RP2040_PWM_Sequencer sequencer(100);
+
+  PWM_TEST_CHECK(sequencer.attachPin(SEQ_PIN));
+  PWM_TEST_CHECK(sequencer.load(script, sizeof(script) / sizeof(script[0])));
+
+  mock_sim_trace(SEQ_SLICE);
+
+  PWM_TEST_CHECK(sequencer.start());
+
+  mock_sim_run_us(100000);
+
+  PWM_TEST_CHECK(!sequencer.isRunning());
+  // All but END
+  PWM_TEST_EQUAL(sequencer.getOpCount(), 7);
+
+  const std::vector<PWM_SimPeriod>& periods = mock_sim_periods(SEQ_SLICE);
+
+  uint32_t fast = 0, slow = 0, wrong = 0;
+
+  for (const PWM_SimPeriod& period : periods)
+  {
+    double cycles = PWM_test_cycles(period);
+
+    if ( (period.top == 12499) && (fabs(cycles - 12500) < 1) )
+      fast++;
+    else if ( (period.top == 62499) && (fabs(cycles - 1250000) < 1) )
+      slow++;
+    else if (wrong++ < 4)
+      printf("Period TOP = %u, %.0f cycles\n", (uint) period.top, cycles);
+
+    PWM_TEST_NEAR( (double) PWM_test_high_counts(period, 0) / (period.top + 1), 0.5, 0.001);
+  }
+
+  printf("%u periods at 10KHz, %u at 100Hz\n", fast, slow);
+
+  PWM_TEST_EQUAL(wrong, 0);
+  PWM_TEST_EQUAL(fast, 14 + 46);
+  PWM_TEST_EQUAL(slow, 4);
+
+  // Disabled with DIV written at once
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[SEQ_SLICE].div, 2 << PWM_CH0_DIV_INT_LSB);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[SEQ_SLICE].csr & PWM_CH0_CSR_EN_BITS, 0);
+  PWM_TEST_EQUAL(mock_pwm_hw.inte & (1 << SEQ_SLICE), 0);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// PC of each execute() call, until the end of script
+static std::vector<uint16_t> runTrace(RP2040_PWM_Sequencer& sequencer)
+{
+  std::vector<uint16_t> trace;
+
+  do
+  {
+    trace.push_back(sequencer.getPC());
+  } while ( (sequencer.execute() != PWM_SEQ_STOPPED) && (trace.size() < 1000) );
+
+  return trace;
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testLevel()
+{
+  static const PWM_Seq_Op ops[] =
+  {
+    // Both channels at the same timestamp, one CC word
+    /* 0 */ PWM_SEQ_OP_LEVEL (1, OP_PIN_A, 100),
+    /* 1 */ PWM_SEQ_OP_LEVEL (0, OP_PIN_B, 200),
+    /* 2 */ PWM_SEQ_OP_LEVEL (7, OP_PIN_B, 300),
+    /* 3 */ PWM_SEQ_OP_END   (1)
+  };
+
+  RP2040_PWM_Sequencer sequencer;
+
+  PWM_TEST_CHECK(sequencer.load(ops, sizeof(ops) / sizeof(ops[0])));
+
+  // Delta of the next op returned
+  PWM_TEST_EQUAL(sequencer.execute(), 7);
+  PWM_TEST_EQUAL(sequencer.getPC(), 2);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[OP_SLICE].cc, (200 << PWM_CH0_CC_B_LSB) | 100);
+
+  PWM_TEST_EQUAL(sequencer.execute(), 1);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[OP_SLICE].cc, (300 << PWM_CH0_CC_B_LSB) | 100);
+
+  PWM_TEST_EQUAL(sequencer.execute(), PWM_SEQ_STOPPED);
+  PWM_TEST_EQUAL(sequencer.execute(), PWM_SEQ_STOPPED);
+  PWM_TEST_EQUAL(sequencer.getOpCount(), 3);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// WAIT only adds its delta, ops after it run at the sum of the deltas
+static void testWait()
+{
+  static const PWM_Seq_Op ops[] =
+  {
+    /* 0 */ PWM_SEQ_OP_LEVEL (0, OP_PIN_A, 10),
+    /* 1 */ PWM_SEQ_OP_WAIT  (4),
+    /* 2 */ PWM_SEQ_OP_WAIT  (6),
+    /* 3 */ PWM_SEQ_OP_LEVEL (0, OP_PIN_A, 20),
+    /* 4 */ PWM_SEQ_OP_END   (0)
+  };
+
+  // 100us ticks
+  RP2040_PWM_Sequencer sequencer(100);
+
+  PWM_TEST_CHECK(sequencer.load(ops, sizeof(ops) / sizeof(ops[0])));
+  PWM_TEST_CHECK(sequencer.start());
+
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[OP_SLICE].cc & PWM_CH0_CC_A_BITS, 10);
+
+  mock_sim_run_us(990);
+
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[OP_SLICE].cc & PWM_CH0_CC_A_BITS, 10);
+  PWM_TEST_EQUAL(sequencer.getPC(), 2);
+
+  mock_sim_run_us(20);
+
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[OP_SLICE].cc & PWM_CH0_CC_A_BITS, 20);
+  PWM_TEST_CHECK(!sequencer.isRunning());
+  PWM_TEST_EQUAL(sequencer.getOpCount(), 4);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testJump()
+{
+  static const PWM_Seq_Op ops[] =
+  {
+    /* 0 */ PWM_SEQ_OP_LEVEL (1, OP_PIN_A, 100),
+    /* 1 */ PWM_SEQ_OP_JUMP  (1, 3),
+    /* 2 */ PWM_SEQ_OP_LEVEL (1, OP_PIN_A, 999),
+    /* 3 */ PWM_SEQ_OP_END   (1)
+  };
+
+  RP2040_PWM_Sequencer sequencer;
+
+  PWM_TEST_CHECK(sequencer.load(ops, sizeof(ops) / sizeof(ops[0])));
+
+  std::vector<uint16_t> trace = runTrace(sequencer);
+
+  PWM_TEST_CHECK(trace == std::vector<uint16_t>({ 0, 1, 3 }));
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[OP_SLICE].cc & PWM_CH0_CC_A_BITS, 100);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testLoop()
+{
+  static const PWM_Seq_Op ops[] =
+  {
+    /* 0 */ PWM_SEQ_OP_WAIT  (1),
+    /* 1 */ PWM_SEQ_OP_WAIT  (1),
+    // Inner : op 1 run 2 more times
+    /* 2 */ PWM_SEQ_OP_LOOP  (1, 1, 2),
+    // Outer : ops 0-2 run 1 more time, inner loop counted again
+    /* 3 */ PWM_SEQ_OP_LOOP  (1, 0, 1),
+    /* 4 */ PWM_SEQ_OP_END   (1)
+  };
+
+  RP2040_PWM_Sequencer sequencer;
+
+  PWM_TEST_CHECK(sequencer.load(ops, sizeof(ops) / sizeof(ops[0])));
+
+  std::vector<uint16_t> trace = runTrace(sequencer);
+
+  PWM_TEST_CHECK(trace == std::vector<uint16_t>({ 0, 1, 2, 1, 2, 1, 2, 3, 0, 1, 2, 1, 2, 1, 2, 3, 4 }));
+
+  // Restarted by reset() with the counters cleared
+  sequencer.reset();
+
+  PWM_TEST_CHECK(runTrace(sequencer) == trace);
+
+  // Count 0 loops forever
+  static const PWM_Seq_Op forever[] =
+  {
+    /* 0 */ PWM_SEQ_OP_WAIT  (1),
+    /* 1 */ PWM_SEQ_OP_LOOP  (1, 0, 0)
+  };
+
+  PWM_TEST_CHECK(sequencer.load(forever, sizeof(forever) / sizeof(forever[0])));
+
+  for (uint32_t i = 0; i < 100; i++)
+    PWM_TEST_EQUAL(sequencer.execute(), 1);
+
+  PWM_TEST_EQUAL(sequencer.getPC(), 0);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// An endless loop of zero delta is stopped after PWM_SEQ_MAX_BURST ops
+static void testBurstGuard()
+{
+  static const PWM_Seq_Op ops[] =
+  {
+    /* 0 */ PWM_SEQ_OP_LEVEL (0, OP_PIN_A, 50),
+    /* 1 */ PWM_SEQ_OP_JUMP  (0, 0)
+  };
+
+  RP2040_PWM_Sequencer sequencer;
+
+  PWM_TEST_CHECK(sequencer.load(ops, sizeof(ops) / sizeof(ops[0])));
+
+  PWM_TEST_EQUAL(sequencer.execute(), PWM_SEQ_STOPPED);
+  PWM_TEST_EQUAL(sequencer.getOpCount(), PWM_SEQ_MAX_BURST);
+
+  // Ops run before the guard still flushed
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[OP_SLICE].cc & PWM_CH0_CC_A_BITS, 50);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testLoad()
+{
+  static const PWM_Seq_Op jump[] =
+  {
+    /* 0 */ PWM_SEQ_OP_WAIT  (1),
+    /* 1 */ PWM_SEQ_OP_JUMP  (1, 2)
+  };
+
+  static const PWM_Seq_Op loop[] =
+  {
+    /* 0 */ PWM_SEQ_OP_WAIT  (1),
+    /* 1 */ PWM_SEQ_OP_LOOP  (1, 5, 3),
+    /* 2 */ PWM_SEQ_OP_END   (1)
+  };
+
+  static const PWM_Seq_Op valid[] =
+  {
+    /* 0 */ PWM_SEQ_OP_WAIT  (1),
+    /* 1 */ PWM_SEQ_OP_LOOP  (1, 0, 3),
+    /* 2 */ PWM_SEQ_OP_JUMP  (1, 2)
+  };
+
+  RP2040_PWM_Sequencer sequencer;
+
+  PWM_TEST_CHECK(!sequencer.load(NULL, 1));
+  PWM_TEST_CHECK(!sequencer.load(valid, 0));
+  PWM_TEST_CHECK(!sequencer.load(jump, sizeof(jump) / sizeof(jump[0])));
+  PWM_TEST_CHECK(!sequencer.load(loop, sizeof(loop) / sizeof(loop[0])));
+  PWM_TEST_CHECK(!sequencer.start());
+
+  PWM_TEST_CHECK(sequencer.load(valid, sizeof(valid) / sizeof(valid[0])));
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Host ns per execute(), and ops per second, of a script changing both channels of a slice
+static void benchmark()
+{
+  static const PWM_Seq_Op ops[] =
+  {
+    /* 0 */ PWM_SEQ_OP_LEVEL (1, OP_PIN_A, 100),
+    /* 1 */ PWM_SEQ_OP_LEVEL (0, OP_PIN_B, 200),
+    /* 2 */ PWM_SEQ_OP_DUTY  (1, OP_PIN_A, 30000),
+    /* 3 */ PWM_SEQ_OP_DUTY  (0, OP_PIN_B, 70000),
+    /* 4 */ PWM_SEQ_OP_WAIT  (1),
+    /* 5 */ PWM_SEQ_OP_LOOP  (0, 0, 0)
+  };
+
+  RP2040_PWM_Sequencer sequencer;
+
+  PWM_TEST_CHECK(sequencer.load(ops, sizeof(ops) / sizeof(ops[0])));
+
+  const uint32_t count = 100000;
+
+  double ns = PWM_test_host_ns(count, [&](const uint32_t&)
+  {
+    sequencer.execute();
+  });
+
+  PWM_TEST_CHECK(sequencer.getOpCount() >= 2 * count);
+
+  printf("execute() : %.1f ns per call, %.2f M ops/s\n", ns, sequencer.getOpCount() / (ns * count * 1e-3));
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testFrequencyChange();
+  testLevel();
+  testWait();
+  testJump();
+  testLoop();
+  testBurstGuard();
+  testLoad();
+  benchmark();
+
+  return PWM_test_report("test_Sequencer");
+}
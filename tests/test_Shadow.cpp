@@ -0,0 +1,404 @@
+/****************************************************************************************************************************
+  test_Shadow.cpp
+  Register shadow : bus writes of RP2040_PWM compared to the pico-sdk call sequence of v1.7.0, replayed on another slice.
+  Both slices must end with the same registers, and the statistics must count the real writes on both sides.
+  setPWM_manual_Fast() must write only the CC half of its own channel.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#define PWM_SHADOW_STATISTICS     true
+
+#include "RP2040_PWM.h"
+
+#include "PWM_Test.h"
+
+///////////////////////////////////////////////////////////////////
+
+// pico-sdk calls of RP2040_PWM v1.7.0, for the write count and the registers of the old code path
+class Legacy_PWM
+{
+  public:
+
+    Legacy_PWM(const float& frequency, const float& dutycycle, bool phaseCorrect = false)
+    {
+      float actualFreq;
+
+      PWM_calc_TOP_and_DIV(125000000, frequency, phaseCorrect, _top, _div, actualFreq);
+
+      _frequency  = frequency;
+      _dutycycle  = dutycycle * 1000;
+    }
+
+    bool setPWM_Int(const uint8_t& pin, const float& frequency, const uint32_t& dutycycle, bool phaseCorrect = false)
+    {
+      bool newFreq      = false;
+      bool newDutyCycle = false;
+
+      if (_frequency != frequency)
+      {
+        float actualFreq;
+
+        PWM_calc_TOP_and_DIV(125000000, frequency, phaseCorrect, _top, _div, actualFreq);
+
+        _frequency  = frequency;
+        _dutycycle  = dutycycle;
+        newFreq     = true;
+      }
+      else if (_enabled && (_dutycycle != dutycycle))
+      {
+        _dutycycle    = dutycycle;
+        newDutyCycle  = true;
+      }
+
+      if ( (!_enabled) || newFreq || newDutyCycle )
+      {
+        uint slice_num = pwm_gpio_to_slice_num(pin);
+
+        gpio_set_function(pin, GPIO_FUNC_PWM);
+
+        pwm_config config = pwm_get_default_config();
+
+        pwm_set_phase_correct(slice_num, phaseCorrect);
+        pwm_config_set_clkdiv_int(&config, _div);
+        pwm_config_set_wrap(&config, _top);
+
+        if (newDutyCycle)
+          pwm_set_wrap(slice_num, _top);
+        else
+          pwm_init(slice_num, &config, true);
+
+        uint32_t level = ( _top * (_dutycycle / 2) ) / 50000;
+
+        pwm_set_gpio_level(pin, level);
+
+        uint chan = pwm_gpio_to_channel(pin);
+
+        _slice[slice_num].level[chan]   = level;
+        _slice[slice_num].active[chan]  = true;
+
+        if (_slice[slice_num].active[chan ^ 1])
+          pwm_set_chan_level(slice_num, chan ^ 1, _slice[slice_num].level[chan ^ 1]);
+
+        pwm_set_enabled(slice_num, true);
+
+        _enabled = true;
+      }
+
+      return true;
+    }
+
+    bool setPWMPushPull_Int(const uint8_t& pinA, const uint8_t& pinB, const float& frequency, const uint32_t& dutycycle)
+    {
+      bool newFreq      = false;
+      bool newDutyCycle = false;
+      uint slice_num    = pwm_gpio_to_slice_num(pinA);
+
+      if (_frequency != frequency)
+      {
+        float actualFreq;
+
+        PWM_calc_TOP_and_DIV(125000000, frequency, true, _top, _div, actualFreq);
+
+        _frequency  = frequency;
+        _dutycycle  = dutycycle;
+        newFreq     = true;
+      }
+      else if (_enabled && (_dutycycle != dutycycle))
+      {
+        _dutycycle    = dutycycle;
+        newDutyCycle  = true;
+      }
+
+      if ( (!_enabled) || newFreq || newDutyCycle )
+      {
+        gpio_set_function(pinA, GPIO_FUNC_PWM);
+        gpio_set_function(pinB, GPIO_FUNC_PWM);
+
+        pwm_config config = pwm_get_default_config();
+
+        pwm_config_set_clkdiv_int(&config, _div);
+        pwm_config_set_wrap(&config, _top);
+
+        if (newDutyCycle)
+          pwm_set_wrap(slice_num, _top);
+        else
+          pwm_init(slice_num, &config, true);
+
+        uint32_t level = ( _top * (_dutycycle / 2) ) / 50000;
+
+        pwm_set_gpio_level(pinA, level);
+        pwm_set_gpio_level(pinB, level);
+        pwm_set_phase_correct(slice_num, true);
+        pwm_set_output_polarity(slice_num, false, true);
+        pwm_set_chan_level(slice_num, PWM_CHAN_A, level);
+        pwm_set_chan_level(slice_num, PWM_CHAN_B, _top - level);
+        pwm_set_enabled(slice_num, true);
+
+        _enabled = true;
+      }
+
+      return true;
+    }
+
+    bool setPWM_manual(const uint8_t& pin, const uint16_t& top, const uint8_t& div, uint16_t& level)
+    {
+      uint slice_num = pwm_gpio_to_slice_num(pin);
+      uint chan      = pwm_gpio_to_channel(pin);
+
+      _top = top;
+
+      gpio_set_function(pin, GPIO_FUNC_PWM);
+
+      pwm_config config = pwm_get_default_config();
+
+      pwm_set_phase_correct(slice_num, false);
+      pwm_config_set_clkdiv_int(&config, div);
+      pwm_config_set_wrap(&config, top);
+      pwm_init(slice_num, &config, true);
+      pwm_set_gpio_level(pin, level);
+
+      _slice[slice_num].level[chan]   = level;
+      _slice[slice_num].active[chan]  = true;
+
+      if (_slice[slice_num].active[chan ^ 1])
+        pwm_set_chan_level(slice_num, chan ^ 1, _slice[slice_num].level[chan ^ 1]);
+
+      pwm_set_enabled(slice_num, true);
+
+      return true;
+    }
+
+    bool setPWM_manual(const uint8_t& pin, uint16_t& level)
+    {
+      uint slice_num = pwm_gpio_to_slice_num(pin);
+      uint chan      = pwm_gpio_to_channel(pin);
+
+      pwm_set_gpio_level(pin, level);
+
+      _slice[slice_num].level[chan]   = level;
+      _slice[slice_num].active[chan]  = true;
+
+      if (_slice[slice_num].active[chan ^ 1])
+        pwm_set_chan_level(slice_num, chan ^ 1, _slice[slice_num].level[chan ^ 1]);
+
+      pwm_set_enabled(slice_num, true);
+
+      return true;
+    }
+
+    bool setPWM_manual_Fast(const uint8_t& pin, uint16_t& level)
+    {
+      hw_write_masked( &pwm_hw->slice[pwm_gpio_to_slice_num(pin)].cc,
+                       ((uint)level) << (pwm_gpio_to_channel(pin) ? PWM_CH0_CC_B_LSB : PWM_CH0_CC_A_LSB),
+                       pwm_gpio_to_channel(pin) ? PWM_CH0_CC_B_BITS : PWM_CH0_CC_A_BITS);
+
+      return true;
+    }
+
+    void disablePWM(const uint& slice_num)
+    {
+      pwm_set_enabled(slice_num, false);
+    }
+
+    void enablePWM(const uint& slice_num)
+    {
+      pwm_set_enabled(slice_num, true);
+    }
+
+  private:
+
+    // Shared by all instances, as PWM_slice_data[]
+    static inline struct
+    {
+      uint32_t level[2];
+      bool     active[2];
+    } _slice[NUM_PWM_SLICES] = {};
+
+    float     _frequency  = 0;
+    uint32_t  _dutycycle  = 0;
+    uint32_t  _top        = 0;
+    uint32_t  _div        = 0;
+    bool      _enabled    = false;
+};
+
+///////////////////////////////////////////////////////////////////
+
+static uint32_t newWrites     = 0;
+static uint32_t legacyWrites  = 0;
+
+// Run the same request on both sides, then check the registers and the statistics
+template<typename New, typename Old> void compare(const char* name, const uint& newSlice, const uint& oldSlice,
+                                                 New newCall, Old oldCall)
+{
+  PWM_shadow_stats before = PWM_shadow_get_stats();
+  uint32_t         writes = mock_sim.pwmWrites;
+
+  newCall();
+
+  uint32_t newDone = mock_sim.pwmWrites - writes;
+
+  writes = mock_sim.pwmWrites;
+
+  oldCall();
+
+  uint32_t oldDone = mock_sim.pwmWrites - writes;
+
+  PWM_TEST_EQUAL(PWM_shadow_get_stats().written - before.written, newDone);
+  PWM_TEST_EQUAL(PWM_shadow_get_stats().legacy  - before.legacy,  oldDone);
+  PWM_TEST_CHECK(newDone <= oldDone);
+
+  PWM_TEST_EQUAL(pwm_hw->slice[newSlice].csr, pwm_hw->slice[oldSlice].csr);
+  PWM_TEST_EQUAL(pwm_hw->slice[newSlice].div, pwm_hw->slice[oldSlice].div);
+  PWM_TEST_EQUAL(pwm_hw->slice[newSlice].top, pwm_hw->slice[oldSlice].top);
+  PWM_TEST_EQUAL(pwm_hw->slice[newSlice].cc,  pwm_hw->slice[oldSlice].cc);
+
+  newWrites     += newDone;
+  legacyWrites  += oldDone;
+
+  printf("  %-36s writes %2u, v1.7.0 %2u\n", name, newDone, oldDone);
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Slice 1 (pins 2, 3) new code, slice 2 (pins 4, 5) v1.7.0
+void testSetPWM()
+{
+  RP2040_PWM PWM_A(2, 1000, 0);
+  RP2040_PWM PWM_B(3, 1000, 0);
+
+  Legacy_PWM oldA(1000, 0);
+  Legacy_PWM oldB(1000, 0);
+
+  compare("setPWM() new frequency", 1, 2, [&] { PWM_A.setPWM(2, 1000, 50); },  [&] { oldA.setPWM_Int(4, 1000, 50000); });
+  compare("setPWM() new dutycycle", 1, 2, [&] { PWM_A.setPWM(2, 1000, 25); },  [&] { oldA.setPWM_Int(4, 1000, 25000); });
+  compare("setPWM() no change",     1, 2, [&] { PWM_A.setPWM(2, 1000, 25); },  [&] { oldA.setPWM_Int(4, 1000, 25000); });
+  compare("setPWM() other channel", 1, 2, [&] { PWM_B.setPWM(3, 1000, 75); },  [&] { oldB.setPWM_Int(5, 1000, 75000); });
+  compare("setPWM() both, new dutycycle", 1, 2, [&] { PWM_B.setPWM(3, 1000, 60); },  [&] { oldB.setPWM_Int(5, 1000, 60000); });
+  compare("setPWM() frequency change", 1, 2, [&] { PWM_A.setPWM(2, 5000, 10); },  [&] { oldA.setPWM_Int(4, 5000, 10000); });
+  compare("disablePWM()",           1, 2, [&] { PWM_A.disablePWM(); },         [&] { oldA.disablePWM(2); });
+  compare("enablePWM()",            1, 2, [&] { PWM_A.enablePWM(); },          [&] { oldA.enablePWM(2); });
+
+  // Dynamic dutycycle, the usual case of the examples
+  for (uint32_t duty = 0; duty <= 100; duty += 10)
+  {
+    compare("setPWM() dutycycle sweep", 1, 2, [&] { PWM_A.setPWM(2, 5000, duty); }, [&] { oldA.setPWM_Int(4, 5000, duty * 1000); });
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Slice 3 (pins 6, 7) new code, slice 4 (pins 8, 9) v1.7.0
+void testPushPull()
+{
+  RP2040_PWM PWM_PP(6, 1000, 0);
+
+  Legacy_PWM oldPP(1000, 0);
+
+  compare("setPWMPushPull() new frequency", 3, 4, [&] { PWM_PP.setPWMPushPull(6, 7, 20000, 30); }, [&] { oldPP.setPWMPushPull_Int(8, 9, 20000, 30000); });
+  compare("setPWMPushPull() new dutycycle", 3, 4, [&] { PWM_PP.setPWMPushPull(6, 7, 20000, 40); }, [&] { oldPP.setPWMPushPull_Int(8, 9, 20000, 40000); });
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Slice 5 (pins 10, 11) new code, slice 6 (pins 12, 13) v1.7.0
+void testManual()
+{
+  RP2040_PWM PWM_M(10, 1000, 0);
+  RP2040_PWM PWM_N(11, 1000, 0);
+
+  Legacy_PWM old(1000, 0);
+
+  uint16_t level = 1000;
+
+  compare("setPWM_manual(top, div)", 5, 6, [&] { uint16_t l = level; PWM_M.setPWM_manual(10, 5000, 1, l); }, [&] { old.setPWM_manual(12, 5000, 1, level); });
+  compare("setPWM_manual(top, div) other", 5, 6, [&] { uint16_t l = 2000; PWM_N.setPWM_manual(11, 5000, 1, l); }, [&] { uint16_t l = 2000; old.setPWM_manual(13, 5000, 1, l); });
+
+  for (uint16_t i = 0; i < 20; i++)
+  {
+    level = 250 * i;
+
+    compare("setPWM_manual(level)", 5, 6, [&] { uint16_t l = level; PWM_M.setPWM_manual(10, l); }, [&] { old.setPWM_manual(12, level); });
+  }
+
+  for (uint16_t i = 0; i < 20; i++)
+  {
+    level = 100 * i;
+
+    compare("setPWM_manual_Fast()", 5, 6, [&] { uint16_t l = level; PWM_N.setPWM_manual_Fast(11, l); }, [&] { old.setPWM_manual_Fast(13, level); });
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+
+// The other channel written behind the library, e.g. by pwm_set_chan_level(), must survive setPWM_manual_Fast()
+void testFastKeepsOtherChannel()
+{
+  RP2040_PWM PWM_F(14, 1000, 0);
+
+  uint16_t level = 100;
+
+  PWM_F.setPWM_manual(14, 1000, 1, level);
+
+  // Slice 7 channel B set outside of the shadow
+  pwm_set_chan_level(7, PWM_CHAN_B, 777);
+
+  for (uint16_t i = 0; i < 10; i++)
+  {
+    level = 10 * i;
+
+    PWM_F.setPWM_manual_Fast(14, level);
+
+    PWM_TEST_EQUAL(pwm_hw->slice[7].cc & PWM_CH0_CC_A_BITS, level);
+    PWM_TEST_EQUAL(pwm_hw->slice[7].cc >> PWM_CH0_CC_B_LSB, 777);
+  }
+
+  // The shadow follows the channel written, and is not marked dirty
+  PWM_TEST_EQUAL(PWM_slice_shadow_data[7].cc & PWM_CH0_CC_A_BITS, level);
+  PWM_TEST_EQUAL(PWM_slice_shadow_data[7].dirty, 0);
+}
+
+///////////////////////////////////////////////////////////////////
+
+void testDutyKeepsManualSibling()
+{
+  // Slice 0 : A driven by setPWM(), B by setPWM_manual() on the same TOP / DIV
+  RP2040_PWM PWM_A(0, 1000, 50);
+  RP2040_PWM PWM_B(1, 1000, 0);
+
+  PWM_A.setPWM();
+
+  uint16_t level = 1234;
+
+  PWM_B.setPWM_manual(1, PWM_A.get_TOP(), PWM_A.get_DIV(), level);
+
+  PWM_TEST_EQUAL(pwm_hw->slice[0].cc >> PWM_CH0_CC_B_LSB, 1234);
+
+  // Dutycycle only change of A must keep the B level
+  PWM_A.setPWM_Int(0, 1000, 25000);
+
+  PWM_TEST_EQUAL(pwm_hw->slice[0].cc >> PWM_CH0_CC_B_LSB, 1234);
+  PWM_TEST_EQUAL(pwm_hw->slice[0].cc & PWM_CH0_CC_A_BITS, (uint32_t) PWM_A.get_TOP() * 25000 / 100000);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  PWM_shadow_reset_stats();
+
+  printf("Register writes, RP2040_PWM vs v1.7.0 :\n");
+
+  testSetPWM();
+  testPushPull();
+  testManual();
+  testFastKeepsOtherChannel();
+  testDutyKeepsManualSibling();
+
+  PWM_TEST_EQUAL(PWM_shadow_writes_saved(), PWM_shadow_get_stats().legacy - PWM_shadow_get_stats().written);
+
+  printf("Total : %u writes, v1.7.0 %u writes, %u saved (%.1f%%)\n", newWrites, legacyWrites, legacyWrites - newWrites,
+         100.0 * (legacyWrites - newWrites) / legacyWrites);
+
+  return PWM_test_report("test_Shadow");
+}
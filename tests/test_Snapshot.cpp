@@ -0,0 +1,162 @@
+/****************************************************************************************************************************
+  test_Snapshot.cpp
+  RP2040_PWM_Snapshot : capture, print and restore after a simulated reboot. Registers, shadow and slice data must be
+  restored, slices set by setPWM_manual() must accept setPWM_manual() with level only.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Snapshot.h"
+
+#include "PWM_Test.h"
+
+#define MANUAL_PIN      4
+#define MANUAL_SLICE    2
+#define FREQ_PIN        7
+#define FREQ_SLICE      3
+
+///////////////////////////////////////////////////////////////////
+
+// Power-on state of the chip and of the library data
+static void reboot()
+{
+  mock_sim_reset();
+
+  memset(PWM_slice_data,        0, sizeof(PWM_slice_data));
+  memset(PWM_slice_manual_data, 0, sizeof(PWM_slice_manual_data));
+  memset(PWM_slice_shadow_data, 0, sizeof(PWM_slice_shadow_data));
+
+  PWM_opCacheClear();
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testRestore()
+{
+  RP2040_PWM PWM_Manual(MANUAL_PIN, 1000, 0);
+  RP2040_PWM PWM_Freq(FREQ_PIN, 1000, 0);
+
+  uint16_t level = 300;
+
+  PWM_TEST_CHECK(PWM_Manual.setPWM_manual(MANUAL_PIN, 1000, 2, level));
+  PWM_TEST_CHECK(PWM_Freq.setPWM(FREQ_PIN, 10000, 25));
+
+  PWM_Snapshot snapshot;
+
+  PWM_TEST_CHECK(PWM_snapshotCapture(snapshot));
+  PWM_TEST_EQUAL(snapshot.sliceMask,  (1 << MANUAL_SLICE) | (1 << FREQ_SLICE));
+  PWM_TEST_EQUAL(snapshot.enableMask, (1 << MANUAL_SLICE) | (1 << FREQ_SLICE));
+  PWM_TEST_EQUAL(snapshot.manualMask, 1 << MANUAL_SLICE);
+  PWM_TEST_EQUAL(snapshot.gpioMask,   (1UL << MANUAL_PIN) | (1UL << FREQ_PIN));
+
+  // Printed as an initializer with the manual slices
+  PrintString text;
+
+  PWM_snapshotPrint(snapshot, text);
+  PWM_TEST_CHECK(text.text.find(", 0xC, 0xC, 0x4, 0x90,") != std::string::npos);
+
+  uint32_t freqCC = mock_pwm_hw.slice[FREQ_SLICE].cc;
+
+  reboot();
+
+  PWM_TEST_CHECK(!PWM_slice_manual_data[MANUAL_SLICE].initialized);
+  PWM_TEST_CHECK(PWM_snapshotRestore(snapshot));
+
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[MANUAL_SLICE].top, 1000);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[MANUAL_SLICE].div, 2 << PWM_CH0_DIV_INT_LSB);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[MANUAL_SLICE].cc,  300);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[FREQ_SLICE].cc,    freqCC);
+  PWM_TEST_EQUAL(mock_pwm_hw.en, (1 << MANUAL_SLICE) | (1 << FREQ_SLICE));
+  PWM_TEST_EQUAL(gpio_get_function(MANUAL_PIN), GPIO_FUNC_PWM);
+
+  PWM_TEST_CHECK(PWM_slice_manual_data[MANUAL_SLICE].initialized);
+  PWM_TEST_CHECK(PWM_slice_manual_data[MANUAL_SLICE].channelA_Active);
+  PWM_TEST_EQUAL(PWM_slice_manual_data[MANUAL_SLICE].channelA_div, 300);
+  PWM_TEST_CHECK(!PWM_slice_manual_data[FREQ_SLICE].initialized);
+  PWM_TEST_CHECK(PWM_slice_data[FREQ_SLICE].channelB_Active);
+  PWM_TEST_CHECK(!PWM_slice_data[MANUAL_SLICE].channelA_Active);
+
+  // Level only, on the restored TOP / DIV
+  level = 500;
+
+  PWM_TEST_CHECK(PWM_Manual.setPWM_manual(MANUAL_PIN, level));
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[MANUAL_SLICE].cc,  500);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[MANUAL_SLICE].top, 1000);
+
+  // Corrupted snapshot refused
+  snapshot.slice[MANUAL_SLICE].top++;
+
+  PWM_TEST_CHECK(!PWM_snapshotRestore(snapshot));
+
+  // Snapshot of the previous layout refused
+  snapshot.slice[MANUAL_SLICE].top--;
+  snapshot.version = 1;
+  snapshot.checksum = PWM_snapshotChecksum(snapshot);
+
+  PWM_TEST_CHECK(!PWM_snapshotRestore(snapshot));
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Host ns from power-on to both slices running, by restore or by constructor + setPWM_manual() / setPWM()
+static void benchmark()
+{
+  PWM_Snapshot snapshot;
+
+  {
+    RP2040_PWM PWM_Manual(MANUAL_PIN, 1000, 0);
+    RP2040_PWM PWM_Freq(FREQ_PIN, 1000, 0);
+
+    uint16_t level = 300;
+
+    PWM_Manual.setPWM_manual(MANUAL_PIN, 1000, 2, level);
+    PWM_Freq.setPWM(FREQ_PIN, 10000, 25);
+
+    PWM_TEST_CHECK(PWM_snapshotCapture(snapshot));
+  }
+
+  const uint32_t count = 20000;
+
+  // Cost of the simulated reboot itself, taken off both
+  double boot = PWM_test_host_ns(count, [&](const uint32_t&)
+  {
+    reboot();
+  });
+
+  double restore = PWM_test_host_ns(count, [&](const uint32_t&)
+  {
+    reboot();
+
+    PWM_snapshotRestore(snapshot);
+  });
+
+  double setPWM = PWM_test_host_ns(count, [&](const uint32_t&)
+  {
+    reboot();
+
+    RP2040_PWM PWM_Manual(MANUAL_PIN, 1000, 0);
+    RP2040_PWM PWM_Freq(FREQ_PIN, 1000, 0);
+
+    uint16_t level = 300;
+
+    PWM_Manual.setPWM_manual(MANUAL_PIN, 1000, 2, level);
+    PWM_Freq.setPWM(FREQ_PIN, 10000, 25);
+  });
+
+  // Both paths end with the same registers
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[MANUAL_SLICE].cc, 300);
+
+  printf("Power-on to 2 slices running, ns : restore %8.1f, constructor + setPWM() %8.1f\n", restore - boot,
+         setPWM - boot);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testRestore();
+  benchmark();
+
+  return PWM_test_report("test_Snapshot");
+}
@@ -0,0 +1,139 @@
+/****************************************************************************************************************************
+  test_Sweep.cpp
+  RP2040_PWM_Sweep : every period produced must have the TOP of the frequency law, from the first period on, with no
+  period repeated, also when the slice was already running. Frequencies above PWM_SWEEP_MAX_FREQUENCY are refused.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Sweep.h"
+
+#include "PWM_Test.h"
+
+#define SWEEP_PIN       2
+#define SWEEP_SLICE     1
+
+///////////////////////////////////////////////////////////////////
+
+// Same law as RP2040_PWM_Sweep, linear, phaseCorrect = false
+static std::vector<uint16_t> referenceTOPs(const float& startFreq, const float& stopFreq, const float& duration_ms, const uint32_t& div)
+{
+  std::vector<uint16_t> tops;
+
+  float tickFreq   = 125000000.0f / div;
+  float tickPeriod = 1.0f / tickFreq;
+  float duration   = duration_ms / 1000.0f;
+  float rate       = (stopFreq - startFreq) / duration;
+  float freq       = startFreq;
+  float elapsed    = 0;
+
+  for (;;)
+  {
+    float    top    = ( tickFreq / freq / 1 ) - 1.0f + 0.5f;
+    uint16_t top16  = (top > 65535.0f) ? 65535 : (uint16_t) top;
+    float    period = (top16 + 1) * tickPeriod;
+
+    tops.push_back(top16);
+    elapsed += period;
+
+    if (elapsed >= duration)
+      return tops;
+
+    freq += rate * period;
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void checkSweep(RP2040_PWM_Sweep& sweep, const float& startFreq, const float& stopFreq, const float& duration_ms)
+{
+  std::vector<uint16_t> tops = referenceTOPs(startFreq, stopFreq, duration_ms, sweep.get_DIV());
+
+  mock_sim_trace(SWEEP_SLICE, false);
+  mock_sim_trace(SWEEP_SLICE);
+
+  PWM_TEST_CHECK(sweep.start());
+
+  mock_sim_run_us( (uint64_t) (duration_ms * 1000) + 10000);
+
+  PWM_TEST_CHECK(sweep.isFinished());
+  PWM_TEST_CHECK(!sweep.isRunning());
+  PWM_TEST_EQUAL(sweep.getPeriodCount(), tops.size());
+
+  const std::vector<PWM_SimPeriod>& periods = mock_sim_periods(SWEEP_SLICE);
+
+  // All the periods of the law, then stopped at the wrap latching the zero level
+  PWM_TEST_EQUAL(periods.size(), tops.size());
+  PWM_TEST_CHECK(!mock_sim_output(SWEEP_SLICE, 0));
+
+  uint32_t wrong  = 0;
+  uint64_t length = 0;
+
+  for (uint32_t i = 0; (i < tops.size()) && (i < periods.size()); i++)
+  {
+    if ( (periods[i].top != tops[i]) || (PWM_test_high_counts(periods[i], 0) != ( (uint32_t) tops[i] * 25000 ) / 50000) )
+    {
+      if (wrong++ < 4)
+        printf("Period %u : TOP = %u, expected %u\n", i, (uint) periods[i].top, (uint) tops[i]);
+    }
+
+    length += periods[i].length;
+  }
+
+  PWM_TEST_EQUAL(wrong, 0);
+  PWM_TEST_CHECK(periods.size() >= 2);
+
+  if (periods.size() >= 2)
+  {
+    // First TOP not repeated
+    PWM_TEST_CHECK(periods[0].top != periods[1].top);
+  }
+
+  // Duration exact to one period
+  PWM_TEST_NEAR( (double) length / MOCK_SUBCYCLES_PER_US, duration_ms * 1000, 1e6 / stopFreq);
+
+  mock_sim_trace(SWEEP_SLICE, false);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testSweep()
+{
+  RP2040_PWM_Sweep sweep(SWEEP_PIN);
+
+  PWM_TEST_CHECK(sweep.setSweep(1000.0f, 2000.0f, 50.0f, 50.0f, PWM_SWEEP_LINEAR, 1));
+
+  checkSweep(sweep, 1000.0f, 2000.0f, 50.0f);
+
+  // Same, on a slice left running at another frequency
+  PWM_shadow_set_top(SWEEP_SLICE, 999);
+  PWM_shadow_set_csr(SWEEP_SLICE, PWM_CH0_CSR_EN_BITS);
+  PWM_shadow_flush(SWEEP_SLICE);
+  mock_sim_run_us(100);
+
+  PWM_TEST_CHECK(sweep.setSweep(20000.0f, 40000.0f, 5.0f, 50.0f, PWM_SWEEP_LINEAR, 1));
+
+  checkSweep(sweep, 20000.0f, 40000.0f, 5.0f);
+}
+
+///////////////////////////////////////////////////////////////////
+
+static void testMaxFrequency()
+{
+  RP2040_PWM_Sweep sweep(SWEEP_PIN);
+
+  PWM_TEST_CHECK(sweep.setSweep(50000.0f, PWM_SWEEP_MAX_FREQUENCY, 5.0f, 50.0f));
+  PWM_TEST_CHECK(!sweep.setSweep(50000.0f, 2 * PWM_SWEEP_MAX_FREQUENCY, 5.0f, 50.0f));
+  PWM_TEST_CHECK(!sweep.setSweep(2 * PWM_SWEEP_MAX_FREQUENCY, 50000.0f, 5.0f, 50.0f));
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testSweep();
+  testMaxFrequency();
+
+  return PWM_test_report("test_Sweep");
+}
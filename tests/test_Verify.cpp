@@ -0,0 +1,135 @@
+/****************************************************************************************************************************
+  test_Verify.cpp
+  RP2040_PWM_Verify : mismatches of the registers with the shadow, and of both with the intended configuration of the
+  added instances, e.g. a stale instance overwriting the slice through the shadow. Repair restores the intended bits.
+*****************************************************************************************************************************/
+
+#include <Arduino.h>
+
+#include "RP2040_PWM.h"
+#include "RP2040_PWM_Verify.h"
+
+#include "PWM_Test.h"
+
+///////////////////////////////////////////////////////////////////
+
+static uint8_t lastMismatch = 0;
+
+static void onMismatch(const uint& slice_num, const uint8_t& mismatch)
+{
+  (void) slice_num;
+
+  lastMismatch = mismatch;
+}
+
+///////////////////////////////////////////////////////////////////
+
+// Every mode of RP2040_PWM must be seen as intended right after its own call
+static void testIntendedModes()
+{
+  RP2040_PWM PWM_A(0, 1000, 0);
+  RP2040_PWM PWM_B(1, 1000, 0);
+  RP2040_PWM PWM_PP(4, 1000, 0);
+  RP2040_PWM PWM_M(6, 1000, 0);
+  RP2040_PWM PWM_PC(8, 1000, 0);
+
+  RP2040_PWM_Verify verify;
+
+  PWM_TEST_CHECK(verify.addInstance(&PWM_A));
+  PWM_TEST_CHECK(verify.addInstance(&PWM_B));
+  PWM_TEST_CHECK(verify.addInstance(&PWM_PP));
+  PWM_TEST_CHECK(verify.addInstance(&PWM_M));
+  PWM_TEST_CHECK(verify.addInstance(&PWM_PC));
+  PWM_TEST_CHECK(verify.addInstance(&PWM_A));
+
+  // Not enabled yet : nothing intended
+  PWM_TEST_EQUAL(verify.verifyAll(), 0);
+
+  uint16_t level = 300;
+
+  PWM_TEST_CHECK(PWM_A.setPWM(0, 1000, 50));
+  PWM_TEST_CHECK(PWM_B.setPWM(1, 1000, 25));
+  PWM_TEST_CHECK(PWM_PP.setPWMPushPull(4, 5, 10000, 30));
+  PWM_TEST_CHECK(PWM_M.setPWM_manual(6, 1000, 2, level));
+  PWM_TEST_CHECK(PWM_PC.setPWM(8, 5000, 75, true));
+
+  PWM_TEST_EQUAL(verify.verifyAll(), 0);
+
+  level = 400;
+
+  PWM_TEST_CHECK(PWM_M.setPWM_manual_Fast(6, level));
+  PWM_TEST_CHECK(PWM_A.setPWM(0, 1000, 60));
+
+  PWM_TEST_EQUAL(verify.verifyAll(), 0);
+  PWM_TEST_EQUAL(verify.getMismatchCount(), 0);
+
+  PWM_A.disablePWM();
+  PWM_B.disablePWM();
+  PWM_PP.disablePWM();
+  PWM_M.disablePWM();
+  PWM_PC.disablePWM();
+}
+
+///////////////////////////////////////////////////////////////////
+
+// A stale instance takes the channel of another one. Registers and shadow agree, only the instance check sees it
+static void testStaleInstance()
+{
+  RP2040_PWM PWM_Owner(10, 1000, 50);
+  RP2040_PWM PWM_Other(11, 1000, 20);
+  RP2040_PWM PWM_Stale(10, 1000, 0);
+
+  RP2040_PWM_Verify verify(true);
+
+  verify.attachCallback(onMismatch);
+
+  PWM_TEST_CHECK(verify.addInstance(&PWM_Owner));
+  PWM_TEST_CHECK(verify.addInstance(&PWM_Other));
+
+  PWM_TEST_CHECK(PWM_Owner.setPWM(10, 1000, 50));
+  PWM_TEST_CHECK(PWM_Other.setPWM(11, 1000, 20));
+
+  uint32_t top = mock_pwm_hw.slice[5].top;
+  uint32_t cc  = mock_pwm_hw.slice[5].cc;
+
+  PWM_TEST_EQUAL(cc, ( (top * 25000 / 50000) ) | ( (top * 10000 / 50000) << 16 ) );
+
+  PWM_TEST_EQUAL(verify.verifyAll(), 0);
+
+  PWM_TEST_CHECK(PWM_Stale.setPWM(10, 2500, 10));
+
+  // New TOP and DIV of the slice, new level of the channel
+  PWM_TEST_EQUAL(verify.verifySlice(5), PWM_VERIFY_INSTANCE | PWM_SHADOW_DIV | PWM_SHADOW_TOP | PWM_SHADOW_CC);
+  PWM_TEST_EQUAL(lastMismatch, PWM_VERIFY_INSTANCE | PWM_SHADOW_DIV | PWM_SHADOW_TOP | PWM_SHADOW_CC);
+  PWM_TEST_EQUAL(verify.getRepairCount(), 1);
+
+  // Repaired in the registers and in the shadow
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[5].top, top);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[5].cc,  cc);
+  PWM_TEST_EQUAL(PWM_slice_shadow_data[5].top, top);
+  PWM_TEST_EQUAL(verify.verifyAll(), 0);
+
+  // Register changed behind the library
+  mock_pwm_hw.slice[5].cc = 0;
+
+  PWM_TEST_EQUAL(verify.verifyAll(), (1 << 5));
+  PWM_TEST_EQUAL(lastMismatch, PWM_VERIFY_INSTANCE | PWM_SHADOW_CC);
+  PWM_TEST_EQUAL(mock_pwm_hw.slice[5].cc, cc);
+
+  // Removed : the stale value is no more a mismatch
+  verify.removeInstance(&PWM_Owner);
+  verify.removeInstance(&PWM_Other);
+
+  PWM_TEST_CHECK(PWM_Stale.setPWM(10, 2500, 10));
+  PWM_TEST_EQUAL(verify.verifyAll(), 0);
+}
+
+///////////////////////////////////////////////////////////////////
+
+int main()
+{
+  testIntendedModes();
+  testStaleInstance();
+
+  return PWM_test_report("test_Verify");
+}